@@ -0,0 +1,801 @@
+/* Copyright (c) <2003-2016> <Newton Game Dynamics>
+*
+* This software is provided 'as-is', without any express or implied
+* warranty. In no event will the authors be held liable for any damages
+* arising from the use of this software.
+*
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely
+*/
+
+// headless benchmark, builds a set of canonical scenes, steps each one for a fixed
+// number of frames at several thread counts and writes the results as json.
+// all scenes are built from a fixed random seed so that runs are reproducible,
+// the checksum of the final body positions can be used to compare runs.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Newton.h"
+#include "dVector.h"
+#include "dMatrix.h"
+
+#define BENCH_TIMESTEP			(1.0f / 60.0f)
+#define BENCH_GRAVITY			(-10.0f)
+#define BENCH_DEFAULT_FRAMES	300
+#define BENCH_DEFAULT_RAYS		100000
+
+class BenchRandom
+{
+	public:
+	BenchRandom(unsigned seed)
+		:m_seed(seed)
+	{
+	}
+
+	dFloat Get(dFloat minValue, dFloat maxValue)
+	{
+		// linear congruential generator, same sequence on all platforms
+		m_seed = m_seed * 1664525u + 1013904223u;
+		dFloat t = dFloat ((m_seed >> 8) & 0xffffff) / dFloat (0xffffff);
+		return minValue + (maxValue - minValue) * t;
+	}
+
+	unsigned m_seed;
+};
+
+class BenchScene
+{
+	public:
+	BenchScene()
+		:m_rayCount(0)
+		,m_rayHits(0)
+		,m_rayIndex(0)
+	{
+	}
+
+	int m_rayCount;
+	std::atomic<int> m_rayHits;
+	std::atomic<int> m_rayIndex;
+	std::vector<dVector> m_rayOrigins;
+	std::vector<dVector> m_rayTargets;
+	std::vector<dMatrix> m_hingeFrames;
+};
+
+typedef void (*BenchBuildScene) (NewtonWorld* const world, BenchScene* const scene, BenchRandom& random);
+
+class BenchSceneDesc
+{
+	public:
+	const char* m_name;
+	BenchBuildScene m_build;
+};
+
+static void ApplyGravity (const NewtonBody* const body, dFloat timestep, int threadIndex)
+{
+	dFloat mass;
+	dFloat Ixx;
+	dFloat Iyy;
+	dFloat Izz;
+
+	NewtonBodyGetMass(body, &mass, &Ixx, &Iyy, &Izz);
+	dVector gravityForce (0.0f, BENCH_GRAVITY * mass, 0.0f, 0.0f);
+	NewtonBodySetForce(body, &gravityForce[0]);
+}
+
+static void ApplyWheelTorque (const NewtonBody* const body, dFloat timestep, int threadIndex)
+{
+	ApplyGravity (body, timestep, threadIndex);
+
+	// the wheel spins around its local x axis
+	dMatrix matrix;
+	NewtonBodyGetMatrix(body, &matrix[0][0]);
+	dVector torque (matrix.m_front.Scale (400.0f));
+	NewtonBodySetTorque(body, &torque[0]);
+}
+
+static void ApplyCharacterForce (const NewtonBody* const body, dFloat timestep, int threadIndex)
+{
+	ApplyGravity (body, timestep, threadIndex);
+
+	// steer the character toward its walk velocity on the horizontal plane
+	dFloat mass;
+	dFloat Ixx;
+	dFloat Iyy;
+	dFloat Izz;
+	dVector veloc;
+	NewtonBodyGetMass(body, &mass, &Ixx, &Iyy, &Izz);
+	NewtonBodyGetVelocity(body, &veloc[0]);
+
+	const dFloat* const walkVeloc = (dFloat*) NewtonBodyGetUserData(body);
+	dVector force (mass * (walkVeloc[0] - veloc.m_x) / timestep, 0.0f, mass * (walkVeloc[2] - veloc.m_z) / timestep, 0.0f);
+	NewtonBodyAddForce(body, &force[0]);
+}
+
+static NewtonBody* CreateBody (NewtonWorld* const world, NewtonCollision* const collision, const dMatrix& matrix, dFloat mass)
+{
+	NewtonBody* const body = NewtonCreateDynamicBody(world, collision, &matrix[0][0]);
+	if (mass > 0.0f) {
+		NewtonBodySetMassProperties(body, mass, collision);
+		NewtonBodySetForceAndTorqueCallback(body, ApplyGravity);
+	}
+	return body;
+}
+
+static void CreateFloor (NewtonWorld* const world, dFloat size)
+{
+	NewtonCollision* const collision = NewtonCreateBox(world, size, 1.0f, size, 0, NULL);
+	dMatrix matrix (dGetIdentityMatrix());
+	matrix.m_posit.m_y = -0.5f;
+	CreateBody (world, collision, matrix, 0.0f);
+	NewtonDestroyCollision(collision);
+}
+
+static void CreateHeightField (NewtonWorld* const world, BenchRandom& random, int size, dFloat cellSize, dFloat roughness)
+{
+	std::vector<dFloat32> elevation (size * size);
+	std::vector<char> attributes (size * size, 0);
+	for (int z = 0; z < size; z ++) {
+		for (int x = 0; x < size; x ++) {
+			elevation[z * size + x] = roughness * (sinf (dFloat (x) * 0.15f) * cosf (dFloat (z) * 0.11f) + random.Get(-0.1f, 0.1f));
+		}
+	}
+
+	NewtonCollision* const collision = NewtonCreateHeightFieldCollision(world, size, size, 0, 0, &elevation[0], &attributes[0], 1.0f, cellSize, cellSize, 0);
+	dMatrix matrix (dGetIdentityMatrix());
+	matrix.m_posit = dVector (-0.5f * size * cellSize, 0.0f, -0.5f * size * cellSize, 1.0f);
+	CreateBody (world, collision, matrix, 0.0f);
+	NewtonDestroyCollision(collision);
+}
+
+static void CreateMeshTerrain (NewtonWorld* const world, BenchRandom& random, int size, dFloat cellSize)
+{
+	std::vector<dFloat> heights ((size + 1) * (size + 1));
+	for (size_t i = 0; i < heights.size(); i ++) {
+		heights[i] = random.Get(0.0f, 0.3f);
+	}
+
+	NewtonCollision* const collision = NewtonCreateTreeCollision(world, 0);
+	NewtonTreeCollisionBeginBuild(collision);
+	const dFloat origin = -0.5f * size * cellSize;
+	for (int z = 0; z < size; z ++) {
+		for (int x = 0; x < size; x ++) {
+			dFloat p[4][3];
+			for (int i = 0; i < 4; i ++) {
+				const int x0 = x + (i & 1);
+				const int z0 = z + (i >> 1);
+				p[i][0] = origin + x0 * cellSize;
+				p[i][1] = heights[z0 * (size + 1) + x0];
+				p[i][2] = origin + z0 * cellSize;
+			}
+			dFloat face0[3][3] = {{p[0][0], p[0][1], p[0][2]}, {p[2][0], p[2][1], p[2][2]}, {p[1][0], p[1][1], p[1][2]}};
+			dFloat face1[3][3] = {{p[1][0], p[1][1], p[1][2]}, {p[2][0], p[2][1], p[2][2]}, {p[3][0], p[3][1], p[3][2]}};
+			NewtonTreeCollisionAddFace(collision, 3, &face0[0][0], 3 * sizeof (dFloat), 0);
+			NewtonTreeCollisionAddFace(collision, 3, &face1[0][0], 3 * sizeof (dFloat), 0);
+		}
+	}
+	NewtonTreeCollisionEndBuild(collision, 1);
+
+	dMatrix matrix (dGetIdentityMatrix());
+	CreateBody (world, collision, matrix, 0.0f);
+	NewtonDestroyCollision(collision);
+}
+
+static NewtonCollision* CreateRandomShape (NewtonWorld* const world, BenchRandom& random)
+{
+	const int type = int (random.Get(0.0f, 3.999f));
+	switch (type)
+	{
+		case 0:
+			return NewtonCreateBox(world, random.Get(0.3f, 1.0f), random.Get(0.3f, 1.0f), random.Get(0.3f, 1.0f), 0, NULL);
+		case 1:
+			return NewtonCreateSphere(world, random.Get(0.2f, 0.5f), 0, NULL);
+		case 2:
+			return NewtonCreateCylinder(world, random.Get(0.2f, 0.5f), random.Get(0.2f, 0.5f), random.Get(0.3f, 1.0f), 0, NULL);
+		default:
+		{
+			dFloat points[16][3];
+			for (int i = 0; i < 16; i ++) {
+				points[i][0] = random.Get(-0.5f, 0.5f);
+				points[i][1] = random.Get(-0.5f, 0.5f);
+				points[i][2] = random.Get(-0.5f, 0.5f);
+			}
+			return NewtonCreateConvexHull(world, 16, &points[0][0], 3 * sizeof (dFloat), 0.0f, 0, NULL);
+		}
+	}
+}
+
+static void BuildPyramid (NewtonWorld* const world, BenchScene* const scene, BenchRandom& random)
+{
+	CreateFloor (world, 200.0f);
+
+	const int base = 24;
+	const dFloat size = 1.0f;
+	NewtonCollision* const collision = NewtonCreateBox(world, size, size, size, 0, NULL);
+	for (int y = 0; y < base; y ++) {
+		for (int x = 0; x < base - y; x ++) {
+			dMatrix matrix (dGetIdentityMatrix());
+			matrix.m_posit = dVector ((x - 0.5f * (base - y - 1)) * size * 1.01f, (y + 0.5f) * size, 0.0f, 1.0f);
+			NewtonBody* const body = CreateBody (world, collision, matrix, 1.0f);
+			// keep the stack awake so that every frame measures the solver
+			NewtonBodySetAutoSleep(body, 0);
+		}
+	}
+	NewtonDestroyCollision(collision);
+}
+
+static void BuildRubble (NewtonWorld* const world, BenchScene* const scene, BenchRandom& random)
+{
+	CreateFloor (world, 200.0f);
+
+	// a pit with four walls
+	NewtonCollision* const wall = NewtonCreateBox(world, 22.0f, 8.0f, 1.0f, 0, NULL);
+	for (int i = 0; i < 4; i ++) {
+		dMatrix matrix (dYawMatrix (dFloat (i) * 3.141592f * 0.5f));
+		matrix.m_posit = matrix.m_right.Scale (10.5f);
+		matrix.m_posit.m_y = 4.0f;
+		matrix.m_posit.m_w = 1.0f;
+		CreateBody (world, wall, matrix, 0.0f);
+	}
+	NewtonDestroyCollision(wall);
+
+	for (int i = 0; i < 1000; i ++) {
+		NewtonCollision* const collision = CreateRandomShape (world, random);
+		dMatrix matrix (dPitchMatrix (random.Get(0.0f, 3.0f)) * dYawMatrix (random.Get(0.0f, 3.0f)));
+		matrix.m_posit = dVector ((i % 10) * 1.8f - 8.1f, 1.0f + (i / 100) * 1.5f, ((i / 10) % 10) * 1.8f - 8.1f, 1.0f);
+		CreateBody (world, collision, matrix, 1.0f);
+		NewtonDestroyCollision(collision);
+	}
+}
+
+static void BuildRagdolls (NewtonWorld* const world, BenchScene* const scene, BenchRandom& random)
+{
+	CreateFloor (world, 200.0f);
+
+	// capsules are aligned to the local x axis, roll them up right
+	const dMatrix upright (dRollMatrix (3.141592f * 0.5f));
+	NewtonCollision* const torso = NewtonCreateCapsule(world, 0.2f, 0.2f, 0.7f, 0, NULL);
+	NewtonCollision* const limb = NewtonCreateCapsule(world, 0.08f, 0.08f, 0.45f, 0, NULL);
+	NewtonCollision* const head = NewtonCreateSphere(world, 0.15f, 0, NULL);
+
+	const dFloat limbOffset[4][2] = {{-0.32f, 0.25f}, {0.32f, 0.25f}, {-0.12f, -0.35f}, {0.12f, -0.35f}};
+	const dVector pin (0.0f, -1.0f, 0.0f, 0.0f);
+	for (int i = 0; i < 64; i ++) {
+		dVector origin ((i % 8) * 2.0f - 7.0f, 2.5f + random.Get(0.0f, 2.0f), (i / 8) * 2.0f - 7.0f, 1.0f);
+
+		dMatrix matrix (upright);
+		matrix.m_posit = origin;
+		NewtonBody* const torsoBody = CreateBody (world, torso, matrix, 10.0f);
+
+		matrix = dGetIdentityMatrix();
+		matrix.m_posit = origin + dVector (0.0f, 0.55f, 0.0f, 0.0f);
+		NewtonBody* const headBody = CreateBody (world, head, matrix, 2.0f);
+		dVector neck (origin + dVector (0.0f, 0.4f, 0.0f, 0.0f));
+		NewtonJoint* const neckJoint = NewtonConstraintCreateBall(world, &neck[0], headBody, torsoBody);
+		NewtonBallSetConeLimits(neckJoint, &pin[0], 0.5f, 0.5f);
+
+		for (int j = 0; j < 4; j ++) {
+			NewtonBody* parent = torsoBody;
+			dVector joint (origin + dVector (limbOffset[j][0], limbOffset[j][1], 0.0f, 0.0f));
+			for (int k = 0; k < 2; k ++) {
+				matrix = upright;
+				matrix.m_posit = joint - dVector (0.0f, 0.3f, 0.0f, 0.0f);
+				NewtonBody* const limbBody = CreateBody (world, limb, matrix, 2.0f);
+				NewtonJoint* const ball = NewtonConstraintCreateBall(world, &joint[0], limbBody, parent);
+				NewtonBallSetConeLimits(ball, &pin[0], 1.0f, 0.5f);
+				parent = limbBody;
+				joint -= dVector (0.0f, 0.6f, 0.0f, 0.0f);
+			}
+		}
+	}
+
+	NewtonDestroyCollision(head);
+	NewtonDestroyCollision(limb);
+	NewtonDestroyCollision(torso);
+}
+
+static void SubmitHingeConstraints (const NewtonJoint* const joint, dFloat timestep, int threadIndex)
+{
+	// the core library has no hinge, this emulates one with a user joint, 
+	// user data points to the joint frames in the local space of each body
+	const dMatrix* const localFrames = (dMatrix*) NewtonJointGetUserData(joint);
+	dMatrix matrix0;
+	dMatrix matrix1;
+	NewtonBodyGetMatrix(NewtonJointGetBody0(joint), &matrix0[0][0]);
+	NewtonBodyGetMatrix(NewtonJointGetBody1(joint), &matrix1[0][0]);
+	matrix0 = localFrames[0] * matrix0;
+	matrix1 = localFrames[1] * matrix1;
+
+	NewtonUserJointAddLinearRow(joint, &matrix0.m_posit[0], &matrix1.m_posit[0], &matrix1.m_front[0]);
+	NewtonUserJointAddLinearRow(joint, &matrix0.m_posit[0], &matrix1.m_posit[0], &matrix1.m_up[0]);
+	NewtonUserJointAddLinearRow(joint, &matrix0.m_posit[0], &matrix1.m_posit[0], &matrix1.m_right[0]);
+
+	// keep the pin of both bodies aligned
+	const dFloat angle0 = asinf (dClamp (matrix0.m_front.DotProduct3 (matrix1.m_up), dFloat (-1.0f), dFloat (1.0f)));
+	const dFloat angle1 = asinf (dClamp (matrix0.m_front.DotProduct3 (matrix1.m_right), dFloat (-1.0f), dFloat (1.0f)));
+	NewtonUserJointAddAngularRow(joint, -angle1, &matrix1.m_up[0]);
+	NewtonUserJointAddAngularRow(joint, angle0, &matrix1.m_right[0]);
+}
+
+static void CreateHinge (NewtonWorld* const world, BenchScene* const scene, const dMatrix& pinAndPivot, NewtonBody* const child, NewtonBody* const parent)
+{
+	dMatrix matrix0;
+	dMatrix matrix1;
+	NewtonBodyGetMatrix(child, &matrix0[0][0]);
+	NewtonBodyGetMatrix(parent, &matrix1[0][0]);
+
+	const size_t index = scene->m_hingeFrames.size();
+	dAssert ((index + 2) <= scene->m_hingeFrames.capacity());
+	scene->m_hingeFrames.push_back (pinAndPivot * matrix0.Inverse());
+	scene->m_hingeFrames.push_back (pinAndPivot * matrix1.Inverse());
+
+	NewtonJoint* const joint = NewtonConstraintCreateUserJoint(world, 5, SubmitHingeConstraints, child, parent);
+	NewtonJointSetUserData(joint, &scene->m_hingeFrames[index]);
+}
+
+static void BuildVehicles (NewtonWorld* const world, BenchScene* const scene, BenchRandom& random)
+{
+	CreateHeightField (world, random, 256, 1.0f, 1.5f);
+
+	NewtonCollision* const chassis = NewtonCreateBox(world, 4.0f, 0.8f, 2.0f, 0, NULL);
+	NewtonCollision* const tire = NewtonCreateChamferCylinder(world, 0.45f, 0.3f, 0, NULL);
+
+	// tires spin around the local x axis, yaw them so that they roll along the vehicle x axis
+	const dMatrix tireAlign (dYawMatrix (3.141592f * 0.5f));
+	scene->m_hingeFrames.reserve (32 * 4 * 2);
+	for (int i = 0; i < 32; i ++) {
+		dVector origin ((i % 4) * 12.0f - 18.0f, 4.0f, (i / 4) * 6.0f - 21.0f, 1.0f);
+
+		dMatrix matrix (dGetIdentityMatrix());
+		matrix.m_posit = origin;
+		NewtonBody* const chassisBody = CreateBody (world, chassis, matrix, 800.0f);
+
+		for (int j = 0; j < 4; j ++) {
+			matrix = tireAlign;
+			matrix.m_posit = origin + dVector ((j & 1) ? 1.4f : -1.4f, -0.6f, (j & 2) ? 1.2f : -1.2f, 0.0f);
+			NewtonBody* const tireBody = CreateBody (world, tire, matrix, 30.0f);
+			NewtonBodySetForceAndTorqueCallback(tireBody, ApplyWheelTorque);
+			CreateHinge (world, scene, matrix, tireBody, chassisBody);
+		}
+	}
+
+	NewtonDestroyCollision(tire);
+	NewtonDestroyCollision(chassis);
+}
+
+static void BuildCharacters (NewtonWorld* const world, BenchScene* const scene, BenchRandom& random)
+{
+	CreateMeshTerrain (world, random, 96, 1.0f);
+
+	static dFloat walkVelocity[256][4];
+	NewtonCollision* const capsule = NewtonCreateCapsule(world, 0.4f, 0.4f, 1.8f, 0, NULL);
+	const dVector upPin (0.0f, 1.0f, 0.0f, 0.0f);
+	for (int i = 0; i < 256; i ++) {
+		dMatrix matrix (dRollMatrix (3.141592f * 0.5f));
+		matrix.m_posit = dVector ((i % 16) * 2.5f - 19.0f, 1.5f, (i / 16) * 2.5f - 19.0f, 1.0f);
+		NewtonBody* const body = CreateBody (world, capsule, matrix, 80.0f);
+
+		const dFloat angle = random.Get(0.0f, 6.28f);
+		walkVelocity[i][0] = 3.0f * cosf (angle);
+		walkVelocity[i][1] = 0.0f;
+		walkVelocity[i][2] = 3.0f * sinf (angle);
+		walkVelocity[i][3] = 0.0f;
+		NewtonBodySetUserData(body, &walkVelocity[i][0]);
+		NewtonBodySetForceAndTorqueCallback(body, ApplyCharacterForce);
+		NewtonConstraintCreateUpVector(world, &upPin[0], body);
+	}
+	NewtonDestroyCollision(capsule);
+}
+
+static void BuildRayBatch (NewtonWorld* const world, BenchScene* const scene, BenchRandom& random)
+{
+	CreateHeightField (world, random, 128, 1.0f, 1.0f);
+	for (int i = 0; i < 2000; i ++) {
+		NewtonCollision* const collision = CreateRandomShape (world, random);
+		dMatrix matrix (dPitchMatrix (random.Get(0.0f, 3.0f)) * dYawMatrix (random.Get(0.0f, 3.0f)));
+		matrix.m_posit = dVector (random.Get(-60.0f, 60.0f), random.Get(2.0f, 6.0f), random.Get(-60.0f, 60.0f), 1.0f);
+		CreateBody (world, collision, matrix, 1.0f);
+		NewtonDestroyCollision(collision);
+	}
+
+	scene->m_rayOrigins.resize (scene->m_rayCount);
+	scene->m_rayTargets.resize (scene->m_rayCount);
+	for (int i = 0; i < scene->m_rayCount; i ++) {
+		scene->m_rayOrigins[i] = dVector (random.Get(-60.0f, 60.0f), 20.0f, random.Get(-60.0f, 60.0f), 1.0f);
+		scene->m_rayTargets[i] = dVector (random.Get(-60.0f, 60.0f), -5.0f, random.Get(-60.0f, 60.0f), 1.0f);
+	}
+}
+
+static void BuildFracturedCompounds (NewtonWorld* const world, BenchScene* const scene, BenchRandom& random)
+{
+	CreateFloor (world, 200.0f);
+
+	// pre fractured blocks, each one a compound of 27 jittered convex chunks
+	const int grid = 3;
+	const dFloat chunkSize = 2.0f / grid;
+	NewtonCollision* const compound = NewtonCreateCompoundCollision(world, 0);
+	NewtonCompoundCollisionBeginAddRemove(compound);
+	for (int i = 0; i < grid * grid * grid; i ++) {
+		dVector center ((i % grid + 0.5f) * chunkSize - 1.0f, ((i / grid) % grid + 0.5f) * chunkSize - 1.0f, (i / (grid * grid) + 0.5f) * chunkSize - 1.0f, 1.0f);
+		dFloat points[8][3];
+		for (int j = 0; j < 8; j ++) {
+			points[j][0] = center.m_x + ((j & 1) ? 0.5f : -0.5f) * chunkSize * random.Get(0.8f, 1.0f);
+			points[j][1] = center.m_y + ((j & 2) ? 0.5f : -0.5f) * chunkSize * random.Get(0.8f, 1.0f);
+			points[j][2] = center.m_z + ((j & 4) ? 0.5f : -0.5f) * chunkSize * random.Get(0.8f, 1.0f);
+		}
+		NewtonCollision* const chunk = NewtonCreateConvexHull(world, 8, &points[0][0], 3 * sizeof (dFloat), 0.0f, 0, NULL);
+		NewtonCompoundCollisionAddSubCollision(compound, chunk);
+		NewtonDestroyCollision(chunk);
+	}
+	NewtonCompoundCollisionEndAddRemove(compound);
+
+	for (int i = 0; i < 128; i ++) {
+		dMatrix matrix (dPitchMatrix (random.Get(0.0f, 3.0f)) * dYawMatrix (random.Get(0.0f, 3.0f)));
+		matrix.m_posit = dVector ((i % 8) * 3.0f - 10.5f, 2.0f + (i / 8) * 3.0f, random.Get(-1.0f, 1.0f), 1.0f);
+		CreateBody (world, compound, matrix, 10.0f);
+	}
+	NewtonDestroyCollision(compound);
+}
+
+static dFloat RayCastFilter (const NewtonBody* const body, const NewtonCollision* const shapeHit, const dFloat* const hitContact, const dFloat* const hitNormal, dLong collisionID, void* const userData, dFloat intersectParam)
+{
+	dFloat* const param = (dFloat*) userData;
+	if (intersectParam < *param) {
+		*param = intersectParam;
+	}
+	return intersectParam;
+}
+
+static void RayCastBatchJob (NewtonWorld* const world, void* const userData, int threadIndex)
+{
+	BenchScene* const scene = (BenchScene*) userData;
+	const int batchSize = 256;
+	int hits = 0;
+	for (int i = scene->m_rayIndex.fetch_add (batchSize); i < scene->m_rayCount; i = scene->m_rayIndex.fetch_add (batchSize)) {
+		const int count = (i + batchSize) < scene->m_rayCount ? batchSize : scene->m_rayCount - i;
+		for (int j = 0; j < count; j ++) {
+			dFloat param = 1.2f;
+			NewtonWorldRayCast(world, &scene->m_rayOrigins[i + j][0], &scene->m_rayTargets[i + j][0], RayCastFilter, &param, NULL, threadIndex);
+			hits += (param < 1.0f) ? 1 : 0;
+		}
+	}
+	scene->m_rayHits.fetch_add (hits);
+}
+
+static void CastRays (NewtonWorld* const world, BenchScene* const scene)
+{
+	scene->m_rayIndex = 0;
+	const int threadCount = NewtonGetThreadsCount(world);
+	for (int i = 0; i < threadCount; i ++) {
+		NewtonDispachThreadJob(world, RayCastBatchJob, scene, "RayCastBatch");
+	}
+	NewtonSyncThreadJobs(world);
+}
+
+static void AddStats (NewtonWorldStats& acc, const NewtonWorldStats& stats)
+{
+	acc.m_updateTime += stats.m_updateTime;
+	acc.m_forceAndTorqueTime += stats.m_forceAndTorqueTime;
+	acc.m_broadPhaseTime += stats.m_broadPhaseTime;
+	acc.m_narrowPhaseTime += stats.m_narrowPhaseTime;
+	acc.m_islandBuildTime += stats.m_islandBuildTime;
+	acc.m_solverTime += stats.m_solverTime;
+	acc.m_integrationTime += stats.m_integrationTime;
+	acc.m_transformTime += stats.m_transformTime;
+	for (int i = 0; i < NEWTON_MAX_THREADS_COUNT; i ++) {
+		acc.m_threadBusyTime[i] += stats.m_threadBusyTime[i];
+		acc.m_threadIdleTime[i] += stats.m_threadIdleTime[i];
+	}
+	acc.m_threadsCount = stats.m_threadsCount;
+	acc.m_pairsCount = stats.m_pairsCount;
+	acc.m_contactsCount = stats.m_contactsCount;
+	acc.m_activeBodiesCount = stats.m_activeBodiesCount;
+	acc.m_islandsCount = stats.m_islandsCount;
+	acc.m_solverRowsCount = stats.m_solverRowsCount;
+}
+
+static void RunScene (FILE* const file, const BenchSceneDesc& desc, int threads, int frames, int rays, int deterministic, int compoundSplit, bool firstResult)
+{
+	NewtonWorld* const world = NewtonCreate();
+	NewtonSetThreadsCount(world, threads);
+	NewtonSetDeterministicMode(world, deterministic);
+	NewtonSetCompoundContactSplitThreshold(world, compoundSplit);
+
+	BenchScene scene;
+	BenchRandom random (0x5eed1234);
+	scene.m_rayCount = (desc.m_build == BuildRayBatch) ? rays : 0;
+	desc.m_build (world, &scene, random);
+
+	// for deterministic behavior call this function each time the world changes
+	NewtonInvalidateCache(world);
+
+	NewtonWorldStats acc;
+	memset (&acc, 0, sizeof (acc));
+	dFloat rayTime = 0.0f;
+	std::chrono::steady_clock::time_point start (std::chrono::steady_clock::now());
+	for (int i = 0; i < frames; i ++) {
+		NewtonUpdate(world, BENCH_TIMESTEP);
+
+		NewtonWorldStats stats;
+		NewtonWorldGetStats(world, &stats);
+		AddStats (acc, stats);
+
+		if (scene.m_rayCount) {
+			std::chrono::steady_clock::time_point rayStart (std::chrono::steady_clock::now());
+			CastRays (world, &scene);
+			rayTime += std::chrono::duration<dFloat> (std::chrono::steady_clock::now() - rayStart).count();
+		}
+	}
+	const dFloat totalTime = std::chrono::duration<dFloat> (std::chrono::steady_clock::now() - start).count();
+
+	int bodyCount = 0;
+	double checksum = 0.0;
+	for (NewtonBody* body = NewtonWorldGetFirstBody(world); body; body = NewtonWorldGetNextBody(world, body)) {
+		dVector posit;
+		NewtonBodyGetPosition(body, &posit[0]);
+		checksum += posit.m_x + posit.m_y + posit.m_z;
+		bodyCount ++;
+	}
+	const int jointCount = NewtonWorldGetConstraintCount(world);
+	NewtonDestroy(world);
+
+	const dFloat scale = 1000.0f / frames;
+	fprintf (file, "%s\t\t{\n", firstResult ? "" : ",\n");
+	fprintf (file, "\t\t\t\"scene\": \"%s\",\n", desc.m_name);
+	fprintf (file, "\t\t\t\"threads\": %d,\n", threads);
+	fprintf (file, "\t\t\t\"frames\": %d,\n", frames);
+	fprintf (file, "\t\t\t\"bodies\": %d,\n", bodyCount);
+	fprintf (file, "\t\t\t\"joints\": %d,\n", jointCount);
+	fprintf (file, "\t\t\t\"total_seconds\": %.6f,\n", totalTime);
+	fprintf (file, "\t\t\t\"ms_per_frame\": %.6f,\n", acc.m_updateTime * scale);
+	fprintf (file, "\t\t\t\"frames_per_second\": %.3f,\n", (acc.m_updateTime > 0.0f) ? frames / acc.m_updateTime : 0.0f);
+	fprintf (file, "\t\t\t\"body_steps_per_second\": %.1f,\n", (acc.m_updateTime > 0.0f) ? dFloat (bodyCount) * frames / acc.m_updateTime : 0.0f);
+	if (scene.m_rayCount) {
+		fprintf (file, "\t\t\t\"rays_per_frame\": %d,\n", scene.m_rayCount);
+		fprintf (file, "\t\t\t\"ray_hits\": %d,\n", int (scene.m_rayHits));
+		fprintf (file, "\t\t\t\"ray_ms_per_frame\": %.6f,\n", rayTime * scale);
+		fprintf (file, "\t\t\t\"rays_per_second\": %.1f,\n", (rayTime > 0.0f) ? dFloat (scene.m_rayCount) * frames / rayTime : 0.0f);
+	}
+	fprintf (file, "\t\t\t\"phases_ms_per_frame\": {\n");
+	fprintf (file, "\t\t\t\t\"force_and_torque\": %.6f,\n", acc.m_forceAndTorqueTime * scale);
+	fprintf (file, "\t\t\t\t\"broad_phase\": %.6f,\n", acc.m_broadPhaseTime * scale);
+	fprintf (file, "\t\t\t\t\"narrow_phase\": %.6f,\n", acc.m_narrowPhaseTime * scale);
+	fprintf (file, "\t\t\t\t\"island_build\": %.6f,\n", acc.m_islandBuildTime * scale);
+	fprintf (file, "\t\t\t\t\"solver\": %.6f,\n", acc.m_solverTime * scale);
+	fprintf (file, "\t\t\t\t\"integration\": %.6f,\n", acc.m_integrationTime * scale);
+	fprintf (file, "\t\t\t\t\"transforms\": %.6f\n", acc.m_transformTime * scale);
+	fprintf (file, "\t\t\t},\n");
+	fprintf (file, "\t\t\t\"thread_busy_ms_per_frame\": [");
+	for (int i = 0; i < acc.m_threadsCount; i ++) {
+		fprintf (file, "%s%.6f", i ? ", " : "", acc.m_threadBusyTime[i] * scale);
+	}
+	fprintf (file, "],\n");
+	fprintf (file, "\t\t\t\"last_frame_counters\": {\n");
+	fprintf (file, "\t\t\t\t\"pairs\": %d,\n", acc.m_pairsCount);
+	fprintf (file, "\t\t\t\t\"contacts\": %d,\n", acc.m_contactsCount);
+	fprintf (file, "\t\t\t\t\"active_bodies\": %d,\n", acc.m_activeBodiesCount);
+	fprintf (file, "\t\t\t\t\"islands\": %d,\n", acc.m_islandsCount);
+	fprintf (file, "\t\t\t\t\"solver_rows\": %d\n", acc.m_solverRowsCount);
+	fprintf (file, "\t\t\t},\n");
+	fprintf (file, "\t\t\t\"checksum\": %.6f\n", checksum);
+	fprintf (file, "\t\t}");
+	fflush (file);
+}
+
+static void RunSharedPoolScene (FILE* const file, const BenchSceneDesc& desc, int threads, int frames, int worldCount, bool clientThreads, int deterministic, int compoundSplit, bool firstResult)
+{
+	// several copies of the scene share one pool of worker threads, either stepped together by the pool 
+	// or each one stepped by its own application thread that waits for its turn on the pool
+	NewtonThreadPool* const pool = NewtonCreateThreadPool(threads);
+	std::vector<NewtonWorld*> worlds;
+	std::vector<BenchScene> scenes (worldCount);
+	for (int i = 0; i < worldCount; i ++) {
+		NewtonWorld* const world = NewtonCreate();
+		NewtonSetThreadPool(world, pool);
+		NewtonSetDeterministicMode(world, deterministic);
+		NewtonSetCompoundContactSplitThreshold(world, compoundSplit);
+
+		BenchRandom random (0x5eed1234);
+		desc.m_build (world, &scenes[i], random);
+		NewtonInvalidateCache(world);
+		worlds.push_back(world);
+	}
+
+	std::chrono::steady_clock::time_point start (std::chrono::steady_clock::now());
+	if (clientThreads) {
+		std::vector<std::thread> clients;
+		for (int i = 0; i < worldCount; i ++) {
+			NewtonWorld* const world = worlds[i];
+			clients.push_back (std::thread ([world, frames]() {
+				for (int j = 0; j < frames; j ++) {
+					NewtonUpdate(world, BENCH_TIMESTEP);
+				}
+			}));
+		}
+		for (size_t i = 0; i < clients.size(); i ++) {
+			clients[i].join();
+		}
+	} else {
+		for (int i = 0; i < frames; i ++) {
+			NewtonThreadPoolUpdate(pool, (const NewtonWorld**) &worlds[0], worldCount, BENCH_TIMESTEP);
+		}
+	}
+	const dFloat totalTime = std::chrono::duration<dFloat> (std::chrono::steady_clock::now() - start).count();
+
+	int bodyCount = 0;
+	int jointCount = 0;
+	double checksum = 0.0;
+	for (int i = 0; i < worldCount; i ++) {
+		for (NewtonBody* body = NewtonWorldGetFirstBody(worlds[i]); body; body = NewtonWorldGetNextBody(worlds[i], body)) {
+			dVector posit;
+			NewtonBodyGetPosition(body, &posit[0]);
+			checksum += posit.m_x + posit.m_y + posit.m_z;
+			bodyCount ++;
+		}
+		jointCount += NewtonWorldGetConstraintCount(worlds[i]);
+		NewtonDestroy(worlds[i]);
+	}
+	NewtonDestroyThreadPool(pool);
+
+	fprintf (file, "%s\t\t{\n", firstResult ? "" : ",\n");
+	fprintf (file, "\t\t\t\"scene\": \"%s\",\n", desc.m_name);
+	fprintf (file, "\t\t\t\"threads\": %d,\n", threads);
+	fprintf (file, "\t\t\t\"worlds\": %d,\n", worldCount);
+	fprintf (file, "\t\t\t\"pool_update\": \"%s\",\n", clientThreads ? "clients" : "batch");
+	fprintf (file, "\t\t\t\"frames\": %d,\n", frames);
+	fprintf (file, "\t\t\t\"bodies\": %d,\n", bodyCount);
+	fprintf (file, "\t\t\t\"joints\": %d,\n", jointCount);
+	fprintf (file, "\t\t\t\"total_seconds\": %.6f,\n", totalTime);
+	fprintf (file, "\t\t\t\"world_frames_per_second\": %.3f,\n", (totalTime > 0.0f) ? dFloat (worldCount) * frames / totalTime : 0.0f);
+	fprintf (file, "\t\t\t\"checksum\": %.6f\n", checksum);
+	fprintf (file, "\t\t}");
+	fflush (file);
+}
+
+static const BenchSceneDesc benchScenes[] =
+{
+	{"pyramid", BuildPyramid},
+	{"rubble", BuildRubble},
+	{"ragdolls", BuildRagdolls},
+	{"vehicles", BuildVehicles},
+	{"characters", BuildCharacters},
+	{"rays", BuildRayBatch},
+	{"fractured", BuildFracturedCompounds},
+};
+
+static bool IsInList (const std::string& list, const char* const name)
+{
+	if (list.empty()) {
+		return true;
+	}
+	const std::string item (name);
+	size_t start = 0;
+	while (start <= list.size()) {
+		size_t end = list.find (',', start);
+		if (end == std::string::npos) {
+			end = list.size();
+		}
+		if (list.compare (start, end - start, item) == 0) {
+			return true;
+		}
+		start = end + 1;
+	}
+	return false;
+}
+
+static void PrintUsage ()
+{
+	printf ("usage: newton_bench [options]\n");
+	printf ("  -frames n         frames to step each scene (default %d)\n", BENCH_DEFAULT_FRAMES);
+	printf ("  -threads a,b,c    thread counts to run each scene with (default 1,2,4,8)\n");
+	printf ("  -scenes a,b,c     scenes to run (default all):");
+	for (size_t i = 0; i < sizeof (benchScenes) / sizeof (benchScenes[0]); i ++) {
+		printf (" %s", benchScenes[i].m_name);
+	}
+	printf ("\n");
+	printf ("  -rays n           rays cast per frame in the rays scene (default %d)\n", BENCH_DEFAULT_RAYS);
+	printf ("  -deterministic    results do not depend on the thread count\n");
+	printf ("  -compoundsplit n  split compound pairs whose cost exceeds n across the threads (default 0, off)\n");
+	printf ("  -worlds n         step n copies of each scene on one shared thread pool (default 0, off)\n");
+	printf ("  -poolclients      with -worlds, step each world from its own thread instead of one pool batch update\n");
+	printf ("  -o file           write the json results to a file instead of stdout\n");
+}
+
+int main (int argc, const char* argv[])
+{
+	int frames = BENCH_DEFAULT_FRAMES;
+	int rays = BENCH_DEFAULT_RAYS;
+	int deterministic = 0;
+	int compoundSplit = 0;
+	int worldCount = 0;
+	bool poolClients = false;
+	std::string sceneList;
+	std::string threadList ("1,2,4,8");
+	const char* outputName = NULL;
+
+	for (int i = 1; i < argc; i ++) {
+		const bool hasValue = (i + 1) < argc;
+		if (!strcmp (argv[i], "-frames") && hasValue) {
+			frames = atoi (argv[++ i]);
+		} else if (!strcmp (argv[i], "-threads") && hasValue) {
+			threadList = argv[++ i];
+		} else if (!strcmp (argv[i], "-scenes") && hasValue) {
+			sceneList = argv[++ i];
+		} else if (!strcmp (argv[i], "-rays") && hasValue) {
+			rays = atoi (argv[++ i]);
+		} else if (!strcmp (argv[i], "-deterministic")) {
+			deterministic = 1;
+		} else if (!strcmp (argv[i], "-compoundsplit") && hasValue) {
+			compoundSplit = atoi (argv[++ i]);
+		} else if (!strcmp (argv[i], "-worlds") && hasValue) {
+			worldCount = atoi (argv[++ i]);
+		} else if (!strcmp (argv[i], "-poolclients")) {
+			poolClients = true;
+		} else if (!strcmp (argv[i], "-o") && hasValue) {
+			outputName = argv[++ i];
+		} else {
+			PrintUsage ();
+			return (strcmp (argv[i], "-h") && strcmp (argv[i], "-help")) ? 1 : 0;
+		}
+	}
+
+	std::vector<int> threadCounts;
+	for (const char* ptr = threadList.c_str(); *ptr; ) {
+		const int count = atoi (ptr);
+		if (count > 0) {
+			threadCounts.push_back (count);
+		}
+		const char* const next = strchr (ptr, ',');
+		ptr = next ? next + 1 : ptr + strlen (ptr);
+	}
+
+	if ((frames <= 0) || threadCounts.empty()) {
+		PrintUsage ();
+		return 1;
+	}
+
+	FILE* const file = outputName ? fopen (outputName, "wt") : stdout;
+	if (!file) {
+		fprintf (stderr, "can't open %s\n", outputName);
+		return 1;
+	}
+
+	fprintf (file, "{\n");
+	fprintf (file, "\t\"benchmark\": \"newton_bench\",\n");
+	fprintf (file, "\t\"newton_version\": \"%d.%d\",\n", NEWTON_MAJOR_VERSION, NEWTON_MINOR_VERSION);
+	fprintf (file, "\t\"float_size\": %d,\n", int (sizeof (dFloat)));
+	fprintf (file, "\t\"timestep\": %.6f,\n", BENCH_TIMESTEP);
+	fprintf (file, "\t\"deterministic\": %s,\n", deterministic ? "true" : "false");
+	fprintf (file, "\t\"compound_split\": %d,\n", compoundSplit);
+	fprintf (file, "\t\"shared_pool_worlds\": %d,\n", worldCount);
+	fprintf (file, "\t\"results\": [\n");
+
+	bool firstResult = true;
+	for (size_t i = 0; i < sizeof (benchScenes) / sizeof (benchScenes[0]); i ++) {
+		if (IsInList (sceneList, benchScenes[i].m_name)) {
+			for (size_t j = 0; j < threadCounts.size(); j ++) {
+				if (worldCount > 0) {
+					RunSharedPoolScene (file, benchScenes[i], threadCounts[j], frames, worldCount, poolClients, deterministic, compoundSplit, firstResult);
+				} else {
+					RunScene (file, benchScenes[i], threadCounts[j], frames, rays, deterministic, compoundSplit, firstResult);
+				}
+				firstResult = false;
+			}
+		}
+	}
+
+	fprintf (file, "\n\t]\n");
+	fprintf (file, "}\n");
+	if (file != stdout) {
+		fclose (file);
+	}
+	return 0;
+}
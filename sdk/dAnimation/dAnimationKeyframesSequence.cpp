@@ -14,6 +14,46 @@
 #include "dAnimationKeyframesSequence.h"
 //#include "dAnimIKBlendNodeTake.h"
 
+#define D_ANIM_QUANTIZE_RANGE	dFloat(32767.0f)
+
+const void dAnimimationKeyFramesTrack::InterpolatePosition(dFloat t, dVector& posit) const
+{
+	const int size = m_position.GetSize();
+	if (size) {
+		t = dMax(t, m_position[0].m_time);
+		const int base = m_position.GetIndex(t);
+		if (base + 1 < size) {
+			const dFloat t0 = m_position[base].m_time;
+			const dFloat t1 = m_position[base + 1].m_time;
+			const dFloat param = (t - t0) / (t1 - t0 + dFloat(1.0e-6f));
+			const dVector& p0 = m_position[base].m_posit;
+			const dVector& p1 = m_position[base + 1].m_posit;
+			posit = p0 + (p1 - p0).Scale(param);
+		} else {
+			posit = m_position[base].m_posit;
+		}
+	}
+}
+
+const void dAnimimationKeyFramesTrack::InterpolateRotation(dFloat t, dQuaternion& rotation) const
+{
+	const int size = m_rotation.GetSize();
+	if (size) {
+		t = dMax(t, m_rotation[0].m_time);
+		const int base = m_rotation.GetIndex(t);
+		if (base + 1 < size) {
+			const dFloat t0 = m_rotation[base].m_time;
+			const dFloat t1 = m_rotation[base + 1].m_time;
+			const dFloat param = (t - t0) / (t1 - t0 + dFloat(1.0e-6f));
+			const dQuaternion& rot0 = m_rotation[base].m_rotation;
+			const dQuaternion& rot1 = m_rotation[base + 1].m_rotation;
+			rotation = rot0.Slerp(rot1, param);
+		} else {
+			rotation = m_rotation[base].m_rotation;
+		}
+	}
+}
+
 /*
 const void dAnimTakeData::dAnimTakeTrack::InterpolatePosition(dFloat t, dVector& posit) const
 {
@@ -120,3 +160,221 @@ dAnimationKeyframesSequence::~dAnimationKeyframesSequence()
 {
 }
 
+
+dAnimationPoseBuffer::dAnimationPoseBuffer()
+	:m_data()
+	,m_count(0)
+	,m_stride(0)
+{
+}
+
+dAnimationPoseBuffer::~dAnimationPoseBuffer()
+{
+}
+
+void dAnimationPoseBuffer::SetCount(int bonesCount)
+{
+	m_count = bonesCount;
+	m_stride = (bonesCount + 3) & -4;
+	const int size = m_stride * m_channelsCount;
+	if (size > m_data.GetSize()) {
+		m_data.Resize(size);
+	}
+}
+
+void dAnimationPoseBuffer::GetTransform(int bone, dVector& posit, dQuaternion& rotation) const
+{
+	dAssert(bone < m_count);
+	posit = dVector(GetChannel(m_positX)[bone], GetChannel(m_positY)[bone], GetChannel(m_positZ)[bone], dFloat(1.0f));
+	rotation = dQuaternion(GetChannel(m_rotationW)[bone], GetChannel(m_rotationX)[bone], GetChannel(m_rotationY)[bone], GetChannel(m_rotationZ)[bone]);
+}
+
+void dAnimationPoseBuffer::SetTransform(int bone, const dVector& posit, const dQuaternion& rotation)
+{
+	dAssert(bone < m_count);
+	GetChannel(m_positX)[bone] = posit.m_x;
+	GetChannel(m_positY)[bone] = posit.m_y;
+	GetChannel(m_positZ)[bone] = posit.m_z;
+	GetChannel(m_rotationX)[bone] = rotation.m_x;
+	GetChannel(m_rotationY)[bone] = rotation.m_y;
+	GetChannel(m_rotationZ)[bone] = rotation.m_z;
+	GetChannel(m_rotationW)[bone] = rotation.m_w;
+}
+
+void dAnimationPoseBuffer::NormalizeRotations()
+{
+	dFloat* const x = GetChannel(m_rotationX);
+	dFloat* const y = GetChannel(m_rotationY);
+	dFloat* const z = GetChannel(m_rotationZ);
+	dFloat* const w = GetChannel(m_rotationW);
+	for (int i = 0; i < m_count; i++) {
+		const dFloat invMag = dFloat(1.0f) / dSqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i] + w[i] * w[i]);
+		x[i] *= invMag;
+		y[i] *= invMag;
+		z[i] *= invMag;
+		w[i] *= invMag;
+	}
+}
+
+void dAnimationPoseBuffer::Blend(const dAnimationPoseBuffer& pose0, const dAnimationPoseBuffer& pose1, dFloat param)
+{
+	dAssert(pose0.m_count == pose1.m_count);
+	SetCount(pose0.m_count);
+	if (!m_count) {
+		return;
+	}
+
+	for (int j = m_positX; j <= m_positZ; j++) {
+		const dFloat* const src0 = pose0.GetChannel(dChannels(j));
+		const dFloat* const src1 = pose1.GetChannel(dChannels(j));
+		dFloat* const dst = GetChannel(dChannels(j));
+		for (int i = 0; i < m_count; i++) {
+			dst[i] = src0[i] + (src1[i] - src0[i]) * param;
+		}
+	}
+
+	// normalized lerp, the second pose is flipped to the hemisphere of the first one
+	const dFloat* const x0 = pose0.GetChannel(m_rotationX);
+	const dFloat* const y0 = pose0.GetChannel(m_rotationY);
+	const dFloat* const z0 = pose0.GetChannel(m_rotationZ);
+	const dFloat* const w0 = pose0.GetChannel(m_rotationW);
+	const dFloat* const x1 = pose1.GetChannel(m_rotationX);
+	const dFloat* const y1 = pose1.GetChannel(m_rotationY);
+	const dFloat* const z1 = pose1.GetChannel(m_rotationZ);
+	const dFloat* const w1 = pose1.GetChannel(m_rotationW);
+	dFloat* const x = GetChannel(m_rotationX);
+	dFloat* const y = GetChannel(m_rotationY);
+	dFloat* const z = GetChannel(m_rotationZ);
+	dFloat* const w = GetChannel(m_rotationW);
+	for (int i = 0; i < m_count; i++) {
+		const dFloat dot = x0[i] * x1[i] + y0[i] * y1[i] + z0[i] * z1[i] + w0[i] * w1[i];
+		const dFloat sign = (dot >= dFloat(0.0f)) ? dFloat(1.0f) : dFloat(-1.0f);
+		x[i] = x0[i] + (x1[i] * sign - x0[i]) * param;
+		y[i] = y0[i] + (y1[i] * sign - y0[i]) * param;
+		z[i] = z0[i] + (z1[i] * sign - z0[i]) * param;
+		w[i] = w0[i] + (w1[i] * sign - w0[i]) * param;
+	}
+	NormalizeRotations();
+}
+
+dAnimationCompressedSequence::dAnimationCompressedSequence(const dAnimationKeyframesSequence& sequence, dFloat framesPerSecond)
+	:dRefCounter()
+	,m_frames()
+	,m_positOrigin()
+	,m_positScale()
+	,m_period(sequence.m_period)
+	,m_framesPerSecond(framesPerSecond)
+	,m_tracksCount(sequence.m_tracks.GetCount())
+	,m_framesCount(0)
+	,m_frameStride(0)
+{
+	dAssert(framesPerSecond > dFloat(0.0f));
+	m_framesCount = dMax(int(dFloor(m_period * framesPerSecond + dFloat(0.5f))) + 1, 2);
+	if (m_period > dFloat(0.0f)) {
+		// snap the rate so that the last frame lands on the end of the period
+		m_framesPerSecond = dFloat(m_framesCount - 1) / m_period;
+	}
+	m_frameStride = m_tracksCount * dAnimationPoseBuffer::m_channelsCount;
+	if (!m_tracksCount) {
+		return;
+	}
+
+	m_frames.Resize(m_framesCount * m_frameStride);
+	m_positOrigin.Resize(3 * m_tracksCount);
+	m_positScale.Resize(3 * m_tracksCount);
+
+	dArray<dVector> posit(m_framesCount);
+	dArray<dQuaternion> rotation(m_framesCount);
+
+	int track = 0;
+	const int count = m_tracksCount;
+	for (dList<dAnimimationKeyFramesTrack>::dListNode* node = sequence.m_tracks.GetFirst(); node; node = node->GetNext()) {
+		const dAnimimationKeyFramesTrack& srcTrack = node->GetInfo();
+
+		// resample the track at a uniform rate
+		dVector minBox(dFloat(1.0e10f));
+		dVector maxBox(dFloat(-1.0e10f));
+		for (int i = 0; i < m_framesCount; i++) {
+			const dFloat t = dMin(dFloat(i) / m_framesPerSecond, m_period);
+			posit[i] = dVector(dFloat(0.0f), dFloat(0.0f), dFloat(0.0f), dFloat(1.0f));
+			rotation[i] = dQuaternion();
+			srcTrack.InterpolatePosition(t, posit[i]);
+			srcTrack.InterpolateRotation(t, rotation[i]);
+			if (i && (rotation[i].DotProduct(rotation[i - 1]) < dFloat(0.0f))) {
+				rotation[i].Scale(dFloat(-1.0f));
+			}
+			for (int j = 0; j < 3; j++) {
+				minBox[j] = dMin(minBox[j], posit[i][j]);
+				maxBox[j] = dMax(maxBox[j], posit[i][j]);
+			}
+		}
+
+		// positions are quantized to the track bounds, rotations to the unit range
+		dFloat invScale[3];
+		for (int j = 0; j < 3; j++) {
+			const dFloat halfExtent = (maxBox[j] - minBox[j]) * dFloat(0.5f);
+			m_positOrigin[j * count + track] = (maxBox[j] + minBox[j]) * dFloat(0.5f);
+			m_positScale[j * count + track] = halfExtent / D_ANIM_QUANTIZE_RANGE;
+			invScale[j] = (halfExtent > dFloat(1.0e-6f)) ? D_ANIM_QUANTIZE_RANGE / halfExtent : dFloat(0.0f);
+		}
+
+		for (int i = 0; i < m_framesCount; i++) {
+			short* const frame = &m_frames[i * m_frameStride];
+			for (int j = 0; j < 3; j++) {
+				const dFloat value = (posit[i][j] - m_positOrigin[j * count + track]) * invScale[j];
+				frame[(dAnimationPoseBuffer::m_positX + j) * count + track] = short(dClamp(int(dFloor(value + dFloat(0.5f))), -32767, 32767));
+			}
+			const dFloat q[] = {rotation[i].m_x, rotation[i].m_y, rotation[i].m_z, rotation[i].m_w};
+			for (int j = 0; j < 4; j++) {
+				const dFloat value = q[j] * D_ANIM_QUANTIZE_RANGE;
+				frame[(dAnimationPoseBuffer::m_rotationX + j) * count + track] = short(dClamp(int(dFloor(value + dFloat(0.5f))), -32767, 32767));
+			}
+		}
+		track++;
+	}
+}
+
+dAnimationCompressedSequence::~dAnimationCompressedSequence()
+{
+}
+
+void dAnimationCompressedSequence::CalculatePose(dAnimationPoseBuffer& output, dFloat t) const
+{
+	output.SetCount(m_tracksCount);
+	if (!m_tracksCount) {
+		return;
+	}
+
+	// uniform frames, the two bracketing keys are found directly without any search
+	const dFloat frame = dClamp(t, dFloat(0.0f), m_period) * m_framesPerSecond;
+	const int index = dMin(int(frame), m_framesCount - 2);
+	const dFloat param = frame - dFloat(index);
+	const short* const frame0 = &m_frames[index * m_frameStride];
+	const short* const frame1 = frame0 + m_frameStride;
+
+	const int count = m_tracksCount;
+	for (int j = 0; j < 3; j++) {
+		const short* const src0 = &frame0[(dAnimationPoseBuffer::m_positX + j) * count];
+		const short* const src1 = &frame1[(dAnimationPoseBuffer::m_positX + j) * count];
+		const dFloat* const origin = &m_positOrigin[j * count];
+		const dFloat* const scale = &m_positScale[j * count];
+		dFloat* const dst = output.GetChannel(dAnimationPoseBuffer::dChannels(dAnimationPoseBuffer::m_positX + j));
+		for (int i = 0; i < count; i++) {
+			const dFloat x0 = dFloat(src0[i]);
+			const dFloat x1 = dFloat(src1[i]);
+			dst[i] = origin[i] + scale[i] * (x0 + (x1 - x0) * param);
+		}
+	}
+
+	for (int j = 0; j < 4; j++) {
+		const short* const src0 = &frame0[(dAnimationPoseBuffer::m_rotationX + j) * count];
+		const short* const src1 = &frame1[(dAnimationPoseBuffer::m_rotationX + j) * count];
+		dFloat* const dst = output.GetChannel(dAnimationPoseBuffer::dChannels(dAnimationPoseBuffer::m_rotationX + j));
+		for (int i = 0; i < count; i++) {
+			const dFloat x0 = dFloat(src0[i]);
+			const dFloat x1 = dFloat(src1[i]);
+			dst[i] = x0 + (x1 - x0) * param;
+		}
+	}
+	output.NormalizeRotations();
+}
@@ -112,6 +112,67 @@ class dAnimationKeyframesSequence: public dRefCounter
 	dFloat m_period;
 };
 
+// flat pose, each channel is a contiguous plane of bone values so that poses are sampled and blended for all bones at once 
+class dAnimationPoseBuffer
+{
+	public:
+	enum dChannels
+	{
+		m_positX,
+		m_positY,
+		m_positZ,
+		m_rotationX,
+		m_rotationY,
+		m_rotationZ,
+		m_rotationW,
+		m_channelsCount,
+	};
+
+	dAnimationPoseBuffer();
+	~dAnimationPoseBuffer();
+
+	int GetCount() const { return m_count; }
+	void SetCount(int bonesCount);
+
+	dFloat* GetChannel(dChannels channel) { return &m_data[channel * m_stride]; }
+	const dFloat* GetChannel(dChannels channel) const { return &m_data[channel * m_stride]; }
+
+	void GetTransform(int bone, dVector& posit, dQuaternion& rotation) const;
+	void SetTransform(int bone, const dVector& posit, const dQuaternion& rotation);
+
+	void NormalizeRotations();
+	void Blend(const dAnimationPoseBuffer& pose0, const dAnimationPoseBuffer& pose1, dFloat param);
+
+	private:
+	dArray<dFloat> m_data;
+	int m_count;
+	int m_stride;
+};
+
+// uniformly resampled and quantized copy of a keyframe sequence, all frames are stored in one contiguous buffer
+class dAnimationCompressedSequence: public dRefCounter
+{
+	public:
+	dAnimationCompressedSequence(const dAnimationKeyframesSequence& sequence, dFloat framesPerSecond = 30.0f);
+	~dAnimationCompressedSequence();
+
+	dFloat GetPeriod() const { return m_period; }
+	int GetTracksCount() const { return m_tracksCount; }
+	int GetFramesCount() const { return m_framesCount; }
+
+	void CalculatePose(dAnimationPoseBuffer& output, dFloat t) const;
+
+	private:
+	dArray<short> m_frames;
+	dArray<dFloat> m_positOrigin;
+	dArray<dFloat> m_positScale;
+	dFloat m_period;
+	dFloat m_framesPerSecond;
+	int m_tracksCount;
+	int m_framesCount;
+	int m_frameStride;
+};
+
 /*
 class dAnimIKBlendNodeTake: public dAnimIKBlendNode
 {
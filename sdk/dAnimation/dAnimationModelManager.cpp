@@ -15,6 +15,7 @@
 dAnimationModelManager::dAnimationModelManager(NewtonWorld* const world, const char* const name)
 	:dCustomParallelListener(world, name)
 	,m_controllerList()
+	,m_items()
 	,m_timestep(0.0f)
 {
 }
@@ -85,47 +86,27 @@ void dAnimationModelManager::OnPreUpdate(dAnimationJointRoot* const model, dFloa
 	model->PreUpdate(timestep);
 }
 
-void dAnimationModelManager::PreUpdate(dFloat timestep, int threadID)
+int dAnimationModelManager::PrepareItems(dParallelPhase phase, dFloat timestep)
 {
-	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
-
+	int count = 0;
 	m_timestep = timestep;
-	dList<dAnimationJointRoot*>::dListNode* node = m_controllerList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
-	}
-	if (node) {
-		do {
-			dAnimationJointRoot* const model = node->GetInfo();
-			//model->PreUpdate(timestep);
-			OnPreUpdate(model, timestep);
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
+	if (phase != m_postStepPhase) {
+		for (dList<dAnimationJointRoot*>::dListNode* node = m_controllerList.GetFirst(); node; node = node->GetNext()) {
+			m_items[count] = node->GetInfo();
+			count++;
+		}
 	}
+	return count;
 }
 
-void dAnimationModelManager::PostUpdate(dFloat timestep, int threadID)
+void dAnimationModelManager::UpdateItem(dParallelPhase phase, dFloat timestep, int item, int threadID)
 {
 	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
-
-	dList<dAnimationJointRoot*>::dListNode* node = m_controllerList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
-	}
-	if (node) {
-		dAnimationJointRoot* const model = node->GetInfo();
+	dAnimationJointRoot* const model = m_items[item];
+	if (phase == m_preUpdatePhase) {
+		OnPreUpdate(model, timestep);
+	} else {
 		OnPostUpdate(model, timestep);
 		model->UpdateTransforms(timestep);
-		do {
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
 	}
 }
@@ -42,12 +42,13 @@ class dAnimationModelManager: public dCustomParallelListener
 	virtual void OnPostUpdate(dAnimationJointRoot* const model, dFloat timestep) {}
 
 	private:
-	void PreUpdate(dFloat timestep, int threadID);
-	void PostUpdate(dFloat timestep, int threadID);
+	int PrepareItems(dParallelPhase phase, dFloat timestep);
+	void UpdateItem(dParallelPhase phase, dFloat timestep, int item, int threadID);
 	dAnimationJoint* GetFirstJoint(const dAnimationJoint* const joint) const;
 
 	private:
 	dList<dAnimationJointRoot*> m_controllerList;
+	dArray<dAnimationJointRoot*> m_items;
 	dFloat m_timestep;
 	//unsigned m_lock;
 };
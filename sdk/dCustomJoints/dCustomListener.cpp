@@ -71,14 +71,296 @@ void dCustomListener::OnDestroyBody (const NewtonWorld* const world, void* const
 	me->OnDestroyBody(body);
 }
 
+#define D_PARALLEL_SCHEDULER_NAME		"__dCustomParallelScheduler__"
+#define D_PARALLEL_SCHEDULER_MAX_DEPTH	32
+
+class dCustomParallelScheduler: public dCustomListener
+{
+	public:
+	class dItemBatch
+	{
+		public:
+		dCustomParallelListener* m_listener;
+		int m_start;
+		int m_count;
+	};
+
+	class dItemJob
+	{
+		public:
+		const dItemBatch* m_batches;
+		dFloat m_timestep;
+		int m_batchCount;
+		int m_itemCount;
+		int m_chunkSize;
+		int m_atomicIndex;
+		dCustomParallelListener::dParallelPhase m_phase;
+	};
+
+	dCustomParallelScheduler(NewtonWorld* const world)
+		:dCustomListener(world, D_PARALLEL_SCHEDULER_NAME)
+		,m_listeners()
+		,m_batches()
+	{
+	}
+
+	static dCustomParallelScheduler* GetScheduler(NewtonWorld* const world)
+	{
+		// the world calls listeners in the order they are added, a new scheduler goes after all existing listeners
+		void* const listener = NewtonWorldGetListener(world, D_PARALLEL_SCHEDULER_NAME);
+		return listener ? (dCustomParallelScheduler*)NewtonWorldGetListenerUserData(world, listener) : new dCustomParallelScheduler(world);
+	}
+
+	void OnDestroy()
+	{
+		for (dList<dCustomParallelListener*>::dListNode* node = m_listeners.GetFirst(); node; node = node->GetNext()) {
+			node->GetInfo()->m_scheduler = NULL;
+		}
+		m_listeners.RemoveAll();
+	}
+
+	void PostStep(dFloat timestep)
+	{
+		Run(dCustomParallelListener::m_postStepPhase, timestep);
+	}
+
+	void PreUpdate(dFloat timestep)
+	{
+		Run(dCustomParallelListener::m_preUpdatePhase, timestep);
+	}
+
+	void PostUpdate(dFloat timestep)
+	{
+		Run(dCustomParallelListener::m_postUpdatePhase, timestep);
+	}
+
+	void Run(dCustomParallelListener::dParallelPhase phase, dFloat timestep)
+	{
+		D_TRACKTIME();
+		int maxLevel = -1;
+		for (dList<dCustomParallelListener*>::dListNode* node = m_listeners.GetFirst(); node; node = node->GetNext()) {
+			dCustomParallelListener* const listener = node->GetInfo();
+			const int level = listener->GetScheduleLevel(phase);
+			if (level >= 0) {
+				maxLevel = dMax(maxLevel, level + listener->GetPassCount(phase) - 1);
+			}
+		}
+
+		// each level is one parallel burst, so a listener sees the results of its dependencies and of its previous passes
+		for (int level = 0; level <= maxLevel; level++) {
+			int batchCount = 0;
+			int itemCount = 0;
+			for (dList<dCustomParallelListener*>::dListNode* node = m_listeners.GetFirst(); node; node = node->GetNext()) {
+				dCustomParallelListener* const listener = node->GetInfo();
+				const int firstLevel = listener->GetScheduleLevel(phase);
+				if ((firstLevel >= 0) && (level >= firstLevel) && (level < (firstLevel + listener->GetPassCount(phase)))) {
+					listener->m_pass = level - firstLevel;
+					const int count = listener->PrepareItems(phase, timestep);
+					dAssert(count >= 0);
+					if (count > 0) {
+						dItemBatch& batch = m_batches[batchCount];
+						batch.m_listener = listener;
+						batch.m_start = itemCount;
+						batch.m_count = count;
+						itemCount += count;
+						batchCount++;
+					}
+				}
+			}
+			RunItems(GetWorld(), &m_batches[0], batchCount, phase, timestep);
+		}
+	}
+
+	static void RunItems(NewtonWorld* const world, const dItemBatch* const batches, int batchCount, dCustomParallelListener::dParallelPhase phase, dFloat timestep)
+	{
+		int itemCount = 0;
+		for (int i = 0; i < batchCount; i++) {
+			itemCount += batches[i].m_count;
+		}
+		if (!itemCount) {
+			return;
+		}
+
+		const int threadCount = NewtonGetThreadsCount(world);
+		dItemJob job;
+		job.m_batches = batches;
+		job.m_timestep = timestep;
+		job.m_batchCount = batchCount;
+		job.m_itemCount = itemCount;
+		job.m_chunkSize = dMax(1, itemCount / (threadCount * 8));
+		job.m_atomicIndex = 0;
+		job.m_phase = phase;
+
+		const int jobCount = dMin(threadCount, (itemCount + job.m_chunkSize - 1) / job.m_chunkSize);
+		for (int i = 0; i < jobCount; i++) {
+			NewtonDispachThreadJob(world, ItemsKernel, &job, "dCustomParallelScheduler");
+		}
+		NewtonSyncThreadJobs(world);
+	}
+
+	static void ItemsKernel(NewtonWorld* const world, void* const context, int threadIndex)
+	{
+		D_TRACKTIME();
+		dItemJob* const job = (dItemJob*)context;
+		const int chunkSize = job->m_chunkSize;
+		int batchIndex = 0;
+		for (int i = NewtonAtomicAdd(&job->m_atomicIndex, chunkSize); i < job->m_itemCount; i = NewtonAtomicAdd(&job->m_atomicIndex, chunkSize)) {
+			const int end = dMin(i + chunkSize, job->m_itemCount);
+			for (int j = i; j < end; j++) {
+				while (j >= (job->m_batches[batchIndex].m_start + job->m_batches[batchIndex].m_count)) {
+					batchIndex++;
+				}
+				const dItemBatch& batch = job->m_batches[batchIndex];
+				batch.m_listener->UpdateItem(job->m_phase, job->m_timestep, j - batch.m_start, threadIndex);
+			}
+		}
+	}
+
+	dList<dCustomParallelListener*> m_listeners;
+	dArray<dItemBatch> m_batches;
+};
+
+static int dCustomParallelListenerCreationCount = 0;
+
 dCustomParallelListener::dCustomParallelListener(NewtonWorld* const world, const char* const listenerName)
 	:dCustomListener(world, listenerName)
 	,m_timestep(0.0f)
+	,m_dependencies()
+	,m_dependents()
+	,m_scheduler(NULL)
+	,m_creationIndex(NewtonAtomicAdd(&dCustomParallelListenerCreationCount, 1))
+	,m_pass(0)
+	,m_serialDependency(false)
 {
 }
 
 dCustomParallelListener::~dCustomParallelListener()
 {
+	SetBatched(false);
+
+	// unlink this listener from both ends of its dependencies so that no listener is left pointing to it
+	for (dList<dCustomParallelListener*>::dListNode* node = m_dependents.GetFirst(); node; node = node->GetNext()) {
+		dList<const dCustomParallelListener*>& dependencies = node->GetInfo()->m_dependencies;
+		for (dList<const dCustomParallelListener*>::dListNode* link = dependencies.GetFirst(); link; ) {
+			dList<const dCustomParallelListener*>::dListNode* const nextLink = link->GetNext();
+			if (link->GetInfo() == this) {
+				dependencies.Remove(link);
+			}
+			link = nextLink;
+		}
+	}
+	for (dList<const dCustomParallelListener*>::dListNode* node = m_dependencies.GetFirst(); node; node = node->GetNext()) {
+		dList<dCustomParallelListener*>& dependents = ((dCustomParallelListener*)node->GetInfo())->m_dependents;
+		for (dList<dCustomParallelListener*>::dListNode* link = dependents.GetFirst(); link; ) {
+			dList<dCustomParallelListener*>::dListNode* const nextLink = link->GetNext();
+			if (link->GetInfo() == this) {
+				dependents.Remove(link);
+			}
+			link = nextLink;
+		}
+	}
+}
+
+void dCustomParallelListener::SetBatched(bool state)
+{
+	if (state && !m_scheduler) {
+		// keep the batched listeners in creation order, which is the order the world calls them when not batched
+		m_scheduler = dCustomParallelScheduler::GetScheduler(GetWorld());
+		dList<dCustomParallelListener*>& listeners = m_scheduler->m_listeners;
+		dList<dCustomParallelListener*>::dListNode* node = listeners.GetLast();
+		for (; node && (node->GetInfo()->m_creationIndex > m_creationIndex); node = node->GetPrev());
+		if (node) {
+			listeners.InsertAfter(node, listeners.Append(this));
+		} else {
+			listeners.Addtop(this);
+		}
+	} else if (!state && m_scheduler) {
+		for (dList<dCustomParallelListener*>::dListNode* node = m_scheduler->m_listeners.GetFirst(); node; node = node->GetNext()) {
+			if (node->GetInfo() == this) {
+				m_scheduler->m_listeners.Remove(node);
+				break;
+			}
+		}
+		m_scheduler = NULL;
+	}
+}
+
+void dCustomParallelListener::AddDependency(const dCustomParallelListener* const listener)
+{
+	m_dependencies.Append(listener);
+	((dCustomParallelListener*)listener)->m_dependents.Append(this);
+}
+
+void dCustomParallelListener::AddDependency(const dCustomListener* const listener)
+{
+	m_serialDependency = true;
+}
+
+bool dCustomParallelListener::IsScheduled(int depth) const
+{
+	if (!m_scheduler || m_serialDependency || (depth > D_PARALLEL_SCHEDULER_MAX_DEPTH)) {
+		return false;
+	}
+	for (dList<const dCustomParallelListener*>::dListNode* node = m_dependencies.GetFirst(); node; node = node->GetNext()) {
+		const dCustomParallelListener* const dependency = node->GetInfo();
+		if ((dependency->m_scheduler != m_scheduler) || !dependency->IsScheduled(depth + 1)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int dCustomParallelListener::GetScheduleLevel(dParallelPhase phase, int depth) const
+{
+	if (!IsScheduled()) {
+		return -1;
+	}
+	int level = 0;
+	if (depth <= D_PARALLEL_SCHEDULER_MAX_DEPTH) {
+		for (dList<const dCustomParallelListener*>::dListNode* node = m_dependencies.GetFirst(); node; node = node->GetNext()) {
+			const dCustomParallelListener* const dependency = node->GetInfo();
+			level = dMax(level, dependency->GetScheduleLevel(phase, depth + 1) + dependency->GetPassCount(phase));
+		}
+	}
+	return level;
+}
+
+void dCustomParallelListener::DispatchPhase(dParallelPhase phase, dFloat timestep)
+{
+	m_timestep = timestep;
+	if (IsScheduled()) {
+		// the world scheduler runs this phase together with all other batched listeners
+		return;
+	}
+
+	m_pass = 0;
+	const int count = PrepareItems(phase, timestep);
+	if (count >= 0) {
+		dCustomParallelScheduler::dItemBatch batch;
+		batch.m_listener = this;
+		batch.m_start = 0;
+		batch.m_count = count;
+		dCustomParallelScheduler::RunItems(GetWorld(), &batch, 1, phase, timestep);
+
+		const int passCount = GetPassCount(phase);
+		for (m_pass = 1; m_pass < passCount; m_pass++) {
+			batch.m_count = PrepareItems(phase, timestep);
+			dCustomParallelScheduler::RunItems(GetWorld(), &batch, 1, phase, timestep);
+		}
+	} else {
+		NewtonWorld* const world = GetWorld();
+		NewtonJobTask callback = ParallerListenPostStepCallback;
+		if (phase == m_preUpdatePhase) {
+			callback = ParallerListenPreUpdateCallback;
+		} else if (phase == m_postUpdatePhase) {
+			callback = ParallerListenPostUpdateCallback;
+		}
+		const int threadCount = NewtonGetThreadsCount(world);
+		for (int i = 0; i < threadCount; i++) {
+			NewtonDispachThreadJob(world, callback, this, "dCustomParallelListener");
+		}
+		NewtonSyncThreadJobs(world);
+	}
 }
 
 void dCustomParallelListener::ParallerListenPostStepCallback(NewtonWorld* const world, void* const context, int threadIndex)
@@ -104,37 +386,15 @@ void dCustomParallelListener::ParallerListenPostUpdateCallback(NewtonWorld* cons
 
 void dCustomParallelListener::PostStep(dFloat timestep)
 {
-	m_timestep = timestep;
-	NewtonWorld* const world = GetWorld();
-
-	int threadCount = NewtonGetThreadsCount(world);
-	for (int i = 0; i < threadCount; i++) {
-		NewtonDispachThreadJob(world, ParallerListenPostStepCallback, this, "dCustomParallelListener");
-	}
-	NewtonSyncThreadJobs(world);
+	DispatchPhase(m_postStepPhase, timestep);
 }
 
 void dCustomParallelListener::PreUpdate(dFloat timestep)
 {
-	m_timestep = timestep;
-	NewtonWorld* const world = GetWorld();
-
-	int threadCount = NewtonGetThreadsCount(world);
-	for (int i = 0; i < threadCount; i ++) {
-		NewtonDispachThreadJob(world, ParallerListenPreUpdateCallback, this, "dCustomParallelListener");
-	}
-	NewtonSyncThreadJobs(world);
+	DispatchPhase(m_preUpdatePhase, timestep);
 }
 
 void dCustomParallelListener::PostUpdate(dFloat timestep)
 {
-	m_timestep = timestep;
-	NewtonWorld* const world = GetWorld();
-
-	int threadCount = NewtonGetThreadsCount(world);
-	for (int i = 0; i < threadCount; i++) {
-		NewtonDispachThreadJob(world, ParallerListenPostUpdateCallback, this, "dCustomParallelListener");
-	}
-	NewtonSyncThreadJobs(world);
+	DispatchPhase(m_postUpdatePhase, timestep);
 }
-
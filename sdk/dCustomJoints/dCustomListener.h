@@ -44,26 +44,76 @@ class dCustomListener: public dCustomAlloc
 };
 
 
+class dCustomParallelScheduler;
+
 class dCustomParallelListener: public dCustomListener
 {
 	public:
+	enum dParallelPhase
+	{
+		m_postStepPhase,
+		m_preUpdatePhase,
+		m_postUpdatePhase,
+	};
+
 	CUSTOM_JOINTS_API dCustomParallelListener(NewtonWorld* const world, const char* const listenerName);
 	CUSTOM_JOINTS_API virtual ~dCustomParallelListener();
 
+	// a batched listener runs its items in one combined parallel phase with all other batched listeners of the world,
+	// instead of in its own callback. Batching is off by default, once on the listener no longer runs at its own place 
+	// among the non batched listeners, and its items run concurrently with the items of the other batched listeners, 
+	// which are prepared in the order the listeners were created.
+	// The combined phase runs at the place of a scheduler listener that the first call to SetBatched appends to the world,
+	// so it runs after every listener that existed at that time and before the listeners created after it, whether or 
+	// not those are batched. Batch the listeners before creating the ones that must see their results.
+	CUSTOM_JOINTS_API void SetBatched(bool state);
+	bool IsBatched() const {return m_scheduler ? true : false;}
+
+	// items of a batched listener run after the items of its batched dependencies,
+	// a dependency on a listener that is not batched takes this listener out of the combined phase.
+	// A dependency is removed when the listener it names is destroyed.
+	CUSTOM_JOINTS_API void AddDependency(const dCustomParallelListener* const listener);
+	CUSTOM_JOINTS_API void AddDependency(const dCustomListener* const listener);
+
 	virtual void PostStep(dFloat timestep, int threadID) {}
 	virtual void PreUpdate(dFloat timestep, int threadID) {}
 	virtual void PostUpdate(dFloat timestep, int threadID) {}
 
+	// item interface, a listener that returns a count >= 0 is called once per item from any thread,
+	// with items handed out dynamically, instead of once per thread. Batched listeners must implement it.
+	virtual int PrepareItems(dParallelPhase phase, dFloat timestep) {return -1;}
+	virtual void UpdateItem(dParallelPhase phase, dFloat timestep, int item, int threadID) {}
+
+	// an item listener can split a phase in several passes, each pass is a separate parallel burst
+	// that sees the results of the previous one, GetPass tells PrepareItems and UpdateItem which one is running
+	virtual int GetPassCount(dParallelPhase phase) const {return 1;}
+	int GetPass() const {return m_pass;}
+
 	private:
 	static void ParallerListenPostStepCallback (NewtonWorld* const world, void* const userData, int threadIndex);
 	static void ParallerListenPreUpdateCallback (NewtonWorld* const world, void* const userData, int threadIndex);
 	static void ParallerListenPostUpdateCallback(NewtonWorld* const world, void* const userData, int threadIndex);
 
+	bool IsScheduled(int depth = 0) const;
+	int GetScheduleLevel(dParallelPhase phase, int depth = 0) const;
+
 	protected:
 	CUSTOM_JOINTS_API virtual void PostStep(dFloat timestep);
 	CUSTOM_JOINTS_API virtual void PreUpdate(dFloat timestep);
 	CUSTOM_JOINTS_API virtual void PostUpdate(dFloat timestep);
+	CUSTOM_JOINTS_API void DispatchPhase(dParallelPhase phase, dFloat timestep);
+
 	dFloat m_timestep;
+
+	private:
+	dList<const dCustomParallelListener*> m_dependencies;
+	dList<dCustomParallelListener*> m_dependents;
+	dCustomParallelScheduler* m_scheduler;
+	int m_creationIndex;
+	int m_pass;
+	bool m_serialDependency;
+
+	friend class dCustomParallelScheduler;
 };
 
 #endif
\ No newline at end of file
@@ -22,24 +22,46 @@
 #define D_MAX_CONTACTS				6
 #define D_MAX_ROWS					(3 * D_MAX_CONTACTS) 
 #define D_MAX_COLLISION_PENETRATION	dFloat (5.0e-3f)
+#define D_CANDIDATES_PADDING		dFloat (0.125f)
 
 class dCustomPlayerController::dContactSolver
 {
 	public: 
-	dContactSolver(dCustomPlayerController* const controller)
-		:m_controller(controller)
+	dContactSolver(int threadIndex)
+		:m_controller(NULL)
 		,m_contactCount(0)
+		,m_threadIndex(threadIndex)
 	{
 	}
 
+	void Reset(dCustomPlayerController* const controller)
+	{
+		m_controller = controller;
+		m_contactCount = 0;
+	}
+
 	void CalculateContacts()
 	{
-		dMatrix matrix;
-		NewtonWorld* const world = m_controller->m_manager->GetWorld();
-		NewtonCollision* const shape = NewtonBodyGetCollision(m_controller->m_kinematicBody);
+		// a player whose swept volume did not overlap any other body can not find contacts this step
+		m_contactCount = 0;
+		if (m_controller->m_hasCandidates) {
+			dMatrix matrix;
+			NewtonWorld* const world = m_controller->m_manager->GetWorld();
+			NewtonCollision* const shape = NewtonBodyGetCollision(m_controller->m_kinematicBody);
+
+			NewtonBodyGetMatrix(m_controller->m_kinematicBody, &matrix[0][0]);
+			m_contactCount = NewtonWorldCollide(world, &matrix[0][0], shape, m_controller, PrefilterCallback, m_contactBuffer, D_MAX_CONTACTS, m_threadIndex);
+		}
+	}
 
-		NewtonBodyGetMatrix(m_controller->m_kinematicBody, &matrix[0][0]);
-		m_contactCount = NewtonWorldCollide(world, &matrix[0][0], shape, m_controller, PrefilterCallback, m_contactBuffer, D_MAX_CONTACTS, 0);
+	static int CandidatesCallback(const NewtonBody* const body, void* const userData)
+	{
+		dCustomPlayerController* const controller = (dCustomPlayerController*)userData;
+		if (controller->GetBody() == body) {
+			return 1;
+		}
+		controller->m_hasCandidates = true;
+		return 0;
 	}
 
 	static unsigned PrefilterCallback(const NewtonBody* const body, const NewtonCollision* const collision, void* const userData)
@@ -54,13 +76,27 @@ class dCustomPlayerController::dContactSolver
 	NewtonWorldConvexCastReturnInfo m_contactBuffer[D_MAX_ROWS];
 	dCustomPlayerController* m_controller;
 	int m_contactCount;
+	int m_threadIndex;
+};
+
+class dCustomPlayerController::dReaction
+{
+	public:
+	dVector m_force;
+	dVector m_torque;
+	const NewtonBody* m_body;
 };
 
 class dCustomPlayerController::dImpulseSolver 
 {
 	public: 
-	dImpulseSolver (dCustomPlayerController* const controller)
+	dImpulseSolver ()
 		:m_zero(0.0f)
+		,m_rowCount(0)
+	{
+	}
+
+	void Init (dCustomPlayerController* const controller)
 	{
 		m_mass = controller->m_mass;
 		m_invMass = controller->m_invMass;
@@ -220,15 +256,18 @@ class dCustomPlayerController::dImpulseSolver
 		return netImpulse;
 	}
 
-	void ApplyReaction(dFloat timestep)
+	// reactions are only recorded in the player here, several players can push the same body,
+	// so the manager adds them to the bodies in player order after all players are resolved
+	void ApplyReaction(dCustomPlayerController* const controller, dFloat timestep)
 	{
 		dFloat invTimeStep = 0.1f / timestep;
 		for (int i = 0; i < m_rowCount; i++) {
 			if (m_contactPoint[i]) {
-				dVector force (m_jacobianPairs[i].m_jacobian_J10.m_linear.Scale (m_impulseMag[i] * invTimeStep));
-				dVector torque (m_jacobianPairs[i].m_jacobian_J10.m_angular.Scale (m_impulseMag[i] * invTimeStep));
-				NewtonBodyAddForce(m_contactPoint[i]->m_hitBody, &force[0]);
-				NewtonBodyAddTorque(m_contactPoint[i]->m_hitBody, &torque[0]);
+				dReaction& reaction = controller->m_reactions[controller->m_reactionCount];
+				reaction.m_force = m_jacobianPairs[i].m_jacobian_J10.m_linear.Scale (m_impulseMag[i] * invTimeStep);
+				reaction.m_torque = m_jacobianPairs[i].m_jacobian_J10.m_angular.Scale (m_impulseMag[i] * invTimeStep);
+				reaction.m_body = m_contactPoint[i]->m_hitBody;
+				controller->m_reactionCount++;
 			}
 		}
 	}
@@ -251,6 +290,10 @@ class dCustomPlayerController::dImpulseSolver
 dCustomPlayerControllerManager::dCustomPlayerControllerManager(NewtonWorld* const world)
 	:dCustomParallelListener(world, PLAYER_PLUGIN_NAME)
 	,m_playerList()
+	,m_items()
+	,m_contactSolvers()
+	,m_impulseSolvers()
+	,m_threadSolverCount(0)
 {
 }
 
@@ -258,27 +301,64 @@ dCustomPlayerControllerManager::~dCustomPlayerControllerManager()
 {
 	m_playerList.RemoveAll();
 	dAssert(m_playerList.GetCount() == 0);
+	for (int i = 0; i < m_threadSolverCount; i++) {
+		delete m_contactSolvers[i];
+		delete m_impulseSolvers[i];
+	}
 }
 
-void dCustomPlayerControllerManager::PreUpdate(dFloat timestep, int threadID)
+void dCustomPlayerControllerManager::ReserveThreadSolvers(int threadCount)
 {
-	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
+	// each thread reuses the same contact and impulse buffers for all the players it resolves
+	for (int i = m_threadSolverCount; i < threadCount; i++) {
+		m_contactSolvers[i] = new dCustomPlayerController::dContactSolver(i);
+		m_impulseSolvers[i] = new dCustomPlayerController::dImpulseSolver();
+	}
+	m_threadSolverCount = dMax(m_threadSolverCount, threadCount);
+}
 
-	dList<dCustomPlayerController>::dListNode* node = m_playerList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
+void dCustomPlayerControllerManager::ApplyReactions()
+{
+	// players are visited in list order so the sums on shared bodies do not depend on the thread schedule
+	for (dList<dCustomPlayerController>::dListNode* node = m_playerList.GetFirst(); node; node = node->GetNext()) {
+		node->GetInfo().ApplyReactions();
 	}
+}
+
+int dCustomPlayerControllerManager::GetPassCount(dParallelPhase phase) const
+{
+	// pass 0 applies the moves and gathers each player's swept volume candidates,
+	// pass 1 resolves the players, and pass 2 adds the recorded contact reactions serially
+	return (phase == m_preUpdatePhase) ? 3 : 1;
+}
 
-	if (node) {
-		do {
-			dCustomPlayerController* const controller = &node->GetInfo();
-			controller->PreUpdate(timestep);
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
+int dCustomPlayerControllerManager::PrepareItems(dParallelPhase phase, dFloat timestep)
+{
+	int count = 0;
+	if (phase == m_preUpdatePhase) {
+		if (GetPass() == 0) {
+			ReserveThreadSolvers(dMax(NewtonGetThreadsCount(GetWorld()), 1));
+			for (dList<dCustomPlayerController>::dListNode* node = m_playerList.GetFirst(); node; node = node->GetNext()) {
+				m_items[count] = &node->GetInfo();
+				count++;
 			}
-		} while (node);
+		} else if (GetPass() == 1) {
+			count = m_playerList.GetCount();
+		} else {
+			ApplyReactions();
+		}
+	}
+	return count;
+}
+
+void dCustomPlayerControllerManager::UpdateItem(dParallelPhase phase, dFloat timestep, int item, int threadID)
+{
+	D_TRACKTIME();
+	if (GetPass() == 0) {
+		m_items[item]->PrepareMove(timestep);
+	} else {
+		dAssert(threadID < m_threadSolverCount);
+		m_items[item]->PreUpdate(timestep, *m_contactSolvers[threadID], *m_impulseSolvers[threadID]);
 	}
 }
 
@@ -299,9 +379,12 @@ dCustomPlayerController::dCustomPlayerController()
 	,m_userData(NULL)
 	,m_kinematicBody(NULL)
 	,m_manager(NULL)
+	,m_reactions()
+	,m_reactionCount(0)
 	,m_isAirbone(false)
 	,m_isOnFloor(false)
 	,m_isCrouched(false)
+	,m_hasCandidates(true)
 {
 }
 
@@ -403,7 +486,7 @@ void dCustomPlayerController::SetFrame(const dMatrix& frame)
 	NewtonCollisionSetMatrix(capsule, &newMatrix[0][0]);
 }
 
-void dCustomPlayerController::ResolveStep(dFloat timestep, dContactSolver& contactSolver)
+void dCustomPlayerController::ResolveStep(dFloat timestep, dContactSolver& contactSolver, dImpulseSolver& impulseSolver)
 {
 	dMatrix matrix;
 	dVector zero(0.0f);
@@ -416,7 +499,7 @@ void dCustomPlayerController::ResolveStep(dFloat timestep, dContactSolver& conta
 	NewtonBodyGetVelocity(m_kinematicBody, &saveVeloc[0]);
 
 	dMatrix startMatrix(matrix);
-	dImpulseSolver impulseSolver(this);
+	impulseSolver.Init(this);
 
 	dFloat invTimeStep = 1.0f / timestep;
 	bool hasStartMatrix = false;
@@ -677,7 +760,7 @@ void dCustomPlayerController::ResolveInterpenetrations(dContactSolver& contactSo
 	SetVelocity(savedVeloc);
 }
 
-void dCustomPlayerController::ResolveCollision(dContactSolver& contactSolver, dFloat timestep)
+void dCustomPlayerController::ResolveCollision(dContactSolver& contactSolver, dImpulseSolver& impulseSolver, dFloat timestep)
 {
 	dMatrix matrix;
 	NewtonBodyGetMatrix(m_kinematicBody, &matrix[0][0]);
@@ -692,7 +775,7 @@ void dCustomPlayerController::ResolveCollision(dContactSolver& contactSolver, dF
 		maxPenetration = dMax (contactSolver.m_contactBuffer[i].m_penetration, maxPenetration);
 	}
 
-	dImpulseSolver impulseSolver(this);
+	impulseSolver.Init(this);
 	if (maxPenetration > D_MAX_COLLISION_PENETRATION) {
 		ResolveInterpenetrations(contactSolver, impulseSolver);
 		NewtonBodyGetMatrix(m_kinematicBody, &matrix[0][0]);
@@ -740,7 +823,7 @@ void dCustomPlayerController::ResolveCollision(dContactSolver& contactSolver, dF
 	impulseSolver.AddAngularRows();
 
 	veloc += impulseSolver.CalculateImpulse().Scale(m_invMass);
-	impulseSolver.ApplyReaction(timestep);
+	impulseSolver.ApplyReaction(this, timestep);
 
 	SetVelocity(veloc);
 }
@@ -769,14 +852,20 @@ void dCustomPlayerController::UpdatePlayerStatus(dContactSolver& contactSolver)
 	}
 }
 
-void dCustomPlayerController::PreUpdate(dFloat timestep)
+void dCustomPlayerController::ApplyReactions()
 {
-	dContactSolver contactSolver (this);
-
-	dFloat timeLeft = timestep;
-	const dFloat timeEpsilon = timestep * (1.0f / 16.0f);
+	for (int i = 0; i < m_reactionCount; i++) {
+		const dReaction& reaction = m_reactions[i];
+		NewtonBodyAddForce(reaction.m_body, &reaction.m_force[0]);
+		NewtonBodyAddTorque(reaction.m_body, &reaction.m_torque[0]);
+	}
+	m_reactionCount = 0;
+}
 
+void dCustomPlayerController::PrepareMove(dFloat timestep)
+{
 	m_impulse = dVector(0.0f);
+	m_reactionCount = 0;
 	m_manager->ApplyMove(this, timestep);
 
 #if 0
@@ -807,13 +896,37 @@ void dCustomPlayerController::PreUpdate(dFloat timestep)
 	dVector veloc(GetVelocity() + m_impulse.Scale(m_invMass));
 	SetVelocity(veloc);
 
+	// gather the swept volume of the step, padded by the step height, 
+	// if no other body is in it the player moves freely and skips all contact queries
+	dVector p0(0.0f);
+	dVector p1(0.0f);
+	NewtonBodyGetAABB(m_kinematicBody, &p0[0], &p1[0]);
+	dVector step(veloc.Scale(timestep));
+	dVector padding(m_stepHeight + D_CANDIDATES_PADDING);
+	dVector q0(p0 + step);
+	dVector q1(p1 + step);
+	for (int i = 0; i < 3; i++) {
+		q0[i] = dMin(p0[i], q0[i]) - padding[i];
+		q1[i] = dMax(p1[i], q1[i]) + padding[i];
+	}
+	m_hasCandidates = false;
+	NewtonWorldForEachBodyInAABBDo(m_manager->GetWorld(), &q0[0], &q1[0], dContactSolver::CandidatesCallback, this);
+}
+
+void dCustomPlayerController::PreUpdate(dFloat timestep, dContactSolver& contactSolver, dImpulseSolver& impulseSolver)
+{
+	dFloat timeLeft = timestep;
+	const dFloat timeEpsilon = timestep * (1.0f / 16.0f);
+
+	contactSolver.Reset(this);
+
 	// determine if player has to step over obstacles lower than step hight
-	ResolveStep(timestep, contactSolver);
+	ResolveStep(timestep, contactSolver, impulseSolver);
 
 	// advance player until it hit a collision point, until there is not more time left
 	for (int i = 0; (i < D_DESCRETE_MOTION_STEPS) && (timeLeft > timeEpsilon); i++) {
 		if (timeLeft > timeEpsilon) {
-			ResolveCollision(contactSolver, timestep);
+			ResolveCollision(contactSolver, impulseSolver, timestep);
 		}
 
 		dFloat predicetdTime = PredictTimestep(timeLeft, contactSolver);
@@ -31,6 +31,7 @@ class dCustomPlayerController
 {
 	class dContactSolver;
 	class dImpulseSolver;
+	class dReaction;
 
 	public:
 	CUSTOM_JOINTS_API dCustomPlayerController();
@@ -74,13 +75,15 @@ class dCustomPlayerController
 		m_deepPenetration,
 	};
 
-	void PreUpdate(dFloat timestep);
+	void PrepareMove(dFloat timestep);
+	void PreUpdate(dFloat timestep, dContactSolver& contactSolver, dImpulseSolver& impulseSolver);
 	void UpdatePlayerStatus(dContactSolver& contactSolver);
-	void ResolveStep(dFloat timestep, dContactSolver& contactSolver);
-	void ResolveCollision(dContactSolver& contactSolver, dFloat timestep);
+	void ResolveStep(dFloat timestep, dContactSolver& contactSolver, dImpulseSolver& impulseSolver);
+	void ResolveCollision(dContactSolver& contactSolver, dImpulseSolver& impulseSolver, dFloat timestep);
 	dFloat PredictTimestep(dFloat timestep, dContactSolver& contactSolver);
 	void ResolveInterpenetrations(dContactSolver& contactSolver, dImpulseSolver& impulseSolver);
 	dCollisionState TestPredictCollision(const dContactSolver& contactSolver, const dVector& veloc) const;
+	void ApplyReactions();
 
 	dMatrix m_localFrame;
 	dVector m_impulse;
@@ -97,9 +100,12 @@ class dCustomPlayerController
 	void* m_userData;
 	NewtonBody* m_kinematicBody;
 	dCustomPlayerControllerManager* m_manager;
+	dArray<dReaction> m_reactions;
+	int m_reactionCount;
 	bool m_isAirbone;
 	bool m_isOnFloor;
 	bool m_isCrouched;
+	bool m_hasCandidates;
 	friend class dCustomPlayerControllerManager;
 };
 
@@ -118,10 +124,19 @@ class dCustomPlayerControllerManager: public dCustomParallelListener
 
 	protected:
 	virtual void PostUpdate(dFloat timestep) {}
-	CUSTOM_JOINTS_API virtual void PreUpdate(dFloat timestep, int threadID);
+	CUSTOM_JOINTS_API virtual int GetPassCount(dParallelPhase phase) const;
+	CUSTOM_JOINTS_API virtual int PrepareItems(dParallelPhase phase, dFloat timestep);
+	CUSTOM_JOINTS_API virtual void UpdateItem(dParallelPhase phase, dFloat timestep, int item, int threadID);
 
 	private:
+	void ReserveThreadSolvers(int threadCount);
+	void ApplyReactions();
+
 	dList<dCustomPlayerController> m_playerList;
+	dArray<dCustomPlayerController*> m_items;
+	dArray<dCustomPlayerController::dContactSolver*> m_contactSolvers;
+	dArray<dCustomPlayerController::dImpulseSolver*> m_impulseSolvers;
+	int m_threadSolverCount;
 	friend class dCustomPlayerController;
 };
 
@@ -20,9 +20,11 @@
 dCustomTriggerManager::dCustomTriggerManager(NewtonWorld* const world)
 	:dCustomParallelListener(world, TRIGGER_PLUGIN_NAME)
 	,m_triggerList()
-	,m_pairCache ()
+	,m_items()
+	,m_eventBuffers()
 	,m_timestep(0.0f)
-	,m_cacheCount(0)
+	,m_itemCount(0)
+	,m_eventBufferCount(0)
 	,m_lock(0)
 	,m_lru(0)
 {
@@ -31,6 +33,9 @@ dCustomTriggerManager::dCustomTriggerManager(NewtonWorld* const world)
 dCustomTriggerManager::~dCustomTriggerManager()
 {
 	dAssert (m_triggerList.GetCount()== 0);
+	for (int i = 0; i < m_eventBufferCount; i++) {
+		delete m_eventBuffers[i];
+	}
 }
 
 void dCustomTriggerManager::OnDestroy()
@@ -93,71 +98,119 @@ void dCustomTriggerManager::OnDebug(dCustomJoint::dDebugDisplay* const debugCont
 	}
 }
 
-void dCustomTriggerManager::PreUpdate(dFloat timestep, int threadID)
+int dCustomTriggerManager::GetPassCount(dParallelPhase phase) const
 {
-	D_TRACKTIME();
+	// pass 0 gathers the guests of each trigger, pass 1 calls OnEnter serially and WhileIn on the new 
+	// guests so they get it the same frame they enter, and pass 2 calls OnExit serially
+	return (phase == m_preUpdatePhase) ? 3 : 1;
+}
 
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
-
-	for (int i = threadID; i < m_cacheCount; i += threadCount) {
-		dTriggerGuestPair& cacheEntry = m_pairCache[i];
-		if (cacheEntry.m_bodyNode->GetInfo() != m_lru) {
-			cacheEntry.m_bodyNode->GetInfo() = m_lru;
-//			dTrace(("in trigger body:%d lru:%d frame:%d\n", NewtonBodyGetID(cacheEntry.m_bodyNode->GetKey()), cacheEntry.m_bodyNode->GetInfo(), xxxxx));
-			WhileIn (cacheEntry.m_trigger, cacheEntry.m_bodyNode->GetKey());
+int dCustomTriggerManager::PrepareItems(dParallelPhase phase, dFloat timestep)
+{
+	int count = 0;
+	if (phase == m_preUpdatePhase) {
+		if (GetPass() == 0) {
+			m_lru++;
+			m_timestep = timestep;
+			for (dList<dCustomTriggerController>::dListNode* node = m_triggerList.GetFirst(); node; node = node->GetNext()) {
+				m_items[count] = &node->GetInfo();
+				count++;
+			}
+			for (int i = m_eventBufferCount; i < count; i++) {
+				m_eventBuffers[i] = new dTriggerEventBuffer();
+			}
+			m_eventBufferCount = dMax(m_eventBufferCount, count);
+			m_itemCount = count;
+		} else if (GetPass() == 1) {
+			FlushEnterEvents();
+			count = m_itemCount;
+		} else {
+			FlushExitEvents();
 		}
 	}
+	return count;
 }
 
-void dCustomTriggerManager::PreUpdate(dFloat timestep)
+void dCustomTriggerManager::UpdateItem(dParallelPhase phase, dFloat timestep, int item, int threadID)
 {
-	m_lru++;
-	m_cacheCount = 0;
-	m_timestep = timestep;
-
-	for (dList<dCustomTriggerController>::dListNode* triggerNode = GetControllersList().GetFirst(); triggerNode; triggerNode = triggerNode->GetNext()) {
-		dCustomTriggerController& controller = triggerNode->GetInfo();
-
-		NewtonBody* const triggerBody = controller.GetBody();
-		dCustomTriggerController::dTriggerManifest& manifest = controller.m_manifest;
-
-		for (NewtonJoint* joint = NewtonBodyGetFirstContactJoint(triggerBody); joint; joint = NewtonBodyGetNextContactJoint(triggerBody, joint)) {
-			dAssert(NewtonJointIsActive(joint));
-			NewtonBody* const body0 = NewtonJointGetBody0(joint);
-			NewtonBody* const body1 = NewtonJointGetBody1(joint);
-			NewtonBody* cargoBody = (body0 != triggerBody) ? body0 : body1;
-			dCustomTriggerController::dTriggerManifest::dTreeNode* uniqueEntryNode = manifest.Find(cargoBody);
-			if (!uniqueEntryNode) {
-				dCustomScopeLock lock(&m_lock);
-				uniqueEntryNode = manifest.Insert(m_lru, cargoBody);
-//				dTrace(("entering trigger body:%d lru:%d frame:%d\n", NewtonBodyGetID(cargoBody), m_lru, xxxxx));
-				OnEnter(&controller, cargoBody);
+	D_TRACKTIME();
+	dTriggerEventBuffer& buffer = *m_eventBuffers[item];
+	if (GetPass() == 0) {
+		UpdateTrigger(m_items[item], buffer);
+	} else {
+		for (int i = 0; i < buffer.m_count; i++) {
+			const dTriggerEvent& event = buffer.m_events[i];
+			if (!event.m_exitNode) {
+				WhileIn(event.m_trigger, event.m_body);
 			}
-			dTriggerGuestPair& cacheEntry = m_pairCache[m_cacheCount];
-			cacheEntry.m_trigger = &controller;
-			cacheEntry.m_bodyNode = uniqueEntryNode;
-			m_cacheCount++;
 		}
 	}
+}
 
-	dCustomParallelListener::PreUpdate(timestep);
+void dCustomTriggerManager::UpdateTrigger(dCustomTriggerController* const controller, dTriggerEventBuffer& buffer)
+{
+	// each trigger only reads its own manifest here, new and departed guests are recorded
+	// in the trigger's event buffer and the manifest is edited serially in trigger order
+	NewtonBody* const triggerBody = controller->GetBody();
+	dCustomTriggerController::dTriggerManifest& manifest = controller->m_manifest;
+
+	buffer.m_count = 0;
+	for (NewtonJoint* joint = NewtonBodyGetFirstContactJoint(triggerBody); joint; joint = NewtonBodyGetNextContactJoint(triggerBody, joint)) {
+		dAssert(NewtonJointIsActive(joint));
+		NewtonBody* const body0 = NewtonJointGetBody0(joint);
+		NewtonBody* const body1 = NewtonJointGetBody1(joint);
+		NewtonBody* const cargoBody = (body0 != triggerBody) ? body0 : body1;
+		dCustomTriggerController::dTriggerManifest::dTreeNode* const node = manifest.Find(cargoBody);
+		if (node) {
+			node->GetInfo() = m_lru;
+			WhileIn(controller, cargoBody);
+		} else {
+			dTriggerEvent& event = buffer.m_events[buffer.m_count];
+			event.m_trigger = controller;
+			event.m_body = cargoBody;
+			event.m_exitNode = NULL;
+			buffer.m_count++;
+		}
+	}
 
-	for (dList<dCustomTriggerController>::dListNode* controllerNode = GetControllersList().GetFirst(); controllerNode; controllerNode = controllerNode->GetNext()) {
-		dCustomTriggerController* const controller = &controllerNode->GetInfo();
-		dCustomTriggerController::dTriggerManifest::Iterator iter(controller->m_manifest);
+	dCustomTriggerController::dTriggerManifest::Iterator iter(manifest);
+	for (iter.Begin(); iter; iter++) {
+		dCustomTriggerController::dTriggerManifest::dTreeNode* const node = iter.GetNode();
+		if (node->GetInfo() != m_lru) {
+			dTriggerEvent& event = buffer.m_events[buffer.m_count];
+			event.m_trigger = controller;
+			event.m_body = node->GetKey();
+			event.m_exitNode = node;
+			buffer.m_count++;
+		}
+	}
+}
 
-		for (iter.Begin(); iter;) {
-			dCustomTriggerController::dTriggerManifest::dTreeNode* const node = iter.GetNode();
-			iter++;
-			if (node->GetInfo() != m_lru) {
-				NewtonBody* const cargoBody = node->GetKey();
+void dCustomTriggerManager::FlushEnterEvents()
+{
+	for (int i = 0; i < m_itemCount; i++) {
+		dTriggerEventBuffer& buffer = *m_eventBuffers[i];
+		for (int j = 0; j < buffer.m_count; j++) {
+			const dTriggerEvent& event = buffer.m_events[j];
+			if (!event.m_exitNode) {
+				event.m_trigger->m_manifest.Insert(m_lru, event.m_body);
+				OnEnter(event.m_trigger, event.m_body);
+			}
+		}
+	}
+}
 
-//				dTrace(("exiting trigger body:%d lru:%d frame:%d\n\n", NewtonBodyGetID(cargoBody), node->GetInfo(), xxxxx));
-				OnExit(controller, cargoBody);
-				dCustomScopeLock lock(&m_lock);
-				controller->m_manifest.Remove(cargoBody);
+void dCustomTriggerManager::FlushExitEvents()
+{
+	for (int i = 0; i < m_itemCount; i++) {
+		dTriggerEventBuffer& buffer = *m_eventBuffers[i];
+		for (int j = 0; j < buffer.m_count; j++) {
+			const dTriggerEvent& event = buffer.m_events[j];
+			if (event.m_exitNode) {
+				OnExit(event.m_trigger, event.m_body);
+				event.m_trigger->m_manifest.Remove(event.m_exitNode);
 			}
 		}
+		buffer.m_count = 0;
 	}
-}
\ No newline at end of file
+}
@@ -65,11 +65,25 @@ class dCustomTriggerController
 
 class dCustomTriggerManager: public dCustomParallelListener
 {
-	class dTriggerGuestPair
+	class dTriggerEvent
 	{
 		public:
 		dCustomTriggerController* m_trigger;
-		dCustomTriggerController::dTriggerManifest::dTreeNode* m_bodyNode;
+		NewtonBody* m_body;
+		dCustomTriggerController::dTriggerManifest::dTreeNode* m_exitNode;
+	};
+
+	class dTriggerEventBuffer
+	{
+		public:
+		dTriggerEventBuffer()
+			:m_events()
+			,m_count(0)
+		{
+		}
+
+		dArray<dTriggerEvent> m_events;
+		int m_count;
 	};
 
 	public:
@@ -88,15 +102,15 @@ class dCustomTriggerManager: public dCustomParallelListener
 
 	protected:
 	CUSTOM_JOINTS_API virtual void OnDestroy();
-	CUSTOM_JOINTS_API void PreUpdate(dFloat timestep, int threadID);
+	CUSTOM_JOINTS_API int GetPassCount(dParallelPhase phase) const;
+	CUSTOM_JOINTS_API int PrepareItems(dParallelPhase phase, dFloat timestep);
+	CUSTOM_JOINTS_API void UpdateItem(dParallelPhase phase, dFloat timestep, int item, int threadID);
 	CUSTOM_JOINTS_API virtual void OnDestroyBody (NewtonBody* const body); 
 
 	virtual void OnDebug(dCustomJoint::dDebugDisplay* const debugContext, const dCustomTriggerController* const controller, const NewtonBody* const guess) const 
 	{
 	}
 
-	CUSTOM_JOINTS_API virtual void PreUpdate(dFloat timestep);
-
 	virtual void PostUpdate(dFloat timestep)
 	{
 		// bypass the entire Post Update call by not calling the base class
@@ -104,11 +118,16 @@ class dCustomTriggerManager: public dCustomParallelListener
 
 	private:
 	CUSTOM_JOINTS_API void OnDebug(dCustomJoint::dDebugDisplay* const debugContext);
+	void UpdateTrigger(dCustomTriggerController* const controller, dTriggerEventBuffer& buffer);
+	void FlushEnterEvents();
+	void FlushExitEvents();
 
 	dList<dCustomTriggerController> m_triggerList;
-	dArray<dTriggerGuestPair> m_pairCache;
+	dArray<dCustomTriggerController*> m_items;
+	dArray<dTriggerEventBuffer*> m_eventBuffers;
 	dFloat m_timestep;
-	int m_cacheCount;
+	int m_itemCount;
+	int m_eventBufferCount;
 	unsigned m_lock;
 	unsigned m_lru;
 };
@@ -85,70 +85,34 @@ void dModelManager::UpdateLocalTranforms(dModelRootNode* const model) const
 	}
 }
 
-void dModelManager::PreUpdate(dFloat timestep, int threadID)
+int dModelManager::PrepareItems(dParallelPhase phase, dFloat timestep)
 {
-	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
-
-	dList<dModelRootNode*>::dListNode* node = m_modelList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
-	}
-
-	if (node) {
-		do {
-			dModelRootNode* const model = node->GetInfo();
-			OnPreUpdate(model, timestep);
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
+	int count = 0;
+	for (dList<dModelRootNode*>::dListNode* node = m_modelList.GetFirst(); node; node = node->GetNext()) {
+		m_items[count] = node->GetInfo();
+		count++;
 	}
+	return count;
 }
 
-void dModelManager::PostUpdate(dFloat timestep, int threadID)
+void dModelManager::UpdateItem(dParallelPhase phase, dFloat timestep, int item, int threadID)
 {
 	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
-
-	dList<dModelRootNode*>::dListNode* node = m_modelList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
-	}
+	dModelRootNode* const model = m_items[item];
+	switch (phase)
+	{
+		case m_preUpdatePhase:
+			OnPreUpdate(model, timestep);
+			break;
 
-	if (node) {
-		do {
-			dModelRootNode* const model = node->GetInfo();
+		case m_postUpdatePhase:
 			OnPostUpdate(model, timestep);
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
-	}
-}
+			break;
 
-void dModelManager::PostStep(dFloat timestep, int threadID)
-{
-	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
-
-	dList<dModelRootNode*>::dListNode* node = m_modelList.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
-	}
-
-	if (node) {
-		do {
-			dModelRootNode* const model = node->GetInfo();
+		case m_postStepPhase:
 			if (model->m_localTransformMode) {
 				UpdateLocalTranforms(model);
 			}
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
+			break;
 	}
 }
@@ -36,15 +36,15 @@ class dModelManager: public dCustomParallelListener
 	virtual void OnDebug(dModelRootNode* const model, dCustomJoint::dDebugDisplay* const debugContext) {}
 
 	protected:
-	void PostStep(dFloat timestep, int threadID);
-	void PreUpdate(dFloat timestep, int threadID);
-	void PostUpdate(dFloat timestep, int threadID);
+	int PrepareItems(dParallelPhase phase, dFloat timestep);
+	void UpdateItem(dParallelPhase phase, dFloat timestep, int item, int threadID);
 
 	private:
 	void UpdateLocalTranforms(dModelRootNode* const model) const;
 	void OnDebug(dCustomJoint::dDebugDisplay* const debugContext);
 	
 	dList<dModelRootNode*> m_modelList;
+	dArray<dModelRootNode*> m_items;
 };
 
 
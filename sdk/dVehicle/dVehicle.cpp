@@ -26,6 +26,9 @@ dVehicle::dVehicle(NewtonBody* const body, const dMatrix& localFrame, dFloat gra
 	,m_newtonBody(body)
 	,m_managerNode(NULL)
 	,m_manager(NULL)
+	,m_lodTier(m_fullTier)
+	,m_lodCounter(0)
+	,m_lodPhase(0)
 {
 	m_localFrame.m_posit = dVector(0.0f, 0.0f, 0.0f, 1.0f);
 	dAssert(m_localFrame.TestOrthogonal());
@@ -48,3 +51,12 @@ dVehicle::~dVehicle()
 		m_manager->RemoveRoot(this);
 	}
 }
+
+void dVehicle::SetLodTier(dLodTier tier)
+{
+	if (tier != m_lodTier) {
+		// force a low rate vehicle to update on the first step after the switch
+		m_lodTier = tier;
+		m_lodCounter = 0x3fffffff;
+	}
+}
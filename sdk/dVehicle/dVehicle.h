@@ -24,6 +24,13 @@ class dVehicleManager;
 class dVehicle: public dVehicleNode
 {
 	public:
+	enum dLodTier
+	{
+		m_fullTier,
+		m_reducedTier,
+		m_lowRateTier,
+	};
+
 	class dDriverInput
 	{
 		public:
@@ -61,10 +68,22 @@ class dVehicle: public dVehicleNode
 
 	virtual void ApplyDriverInputs(const dDriverInput& driveInputs, dFloat timestep) {}
 
+	dLodTier GetLodTier() const {return m_lodTier;}
+	DVEHICLE_API virtual void SetLodTier(dLodTier tier);
+
 	protected:
 	virtual void PreUpdate(dFloat timestep) {};
 	virtual void PostUpdate(dFloat timestep) {};
 
+	// the manager splits the pre update in three stages, so that the tire contact queries of all vehicles
+	// are spread across the thread pool as one batch. By default all the work is done in the first stage.
+	// A fourth stage runs serially and adds the forces the vehicle recorded for other bodies.
+	virtual void PreUpdateBegin(dFloat timestep) {PreUpdate(timestep);}
+	virtual int GetTireQueryCount() const {return 0;}
+	virtual void UpdateTireQuery(int index, int threadIndex) {}
+	virtual void PreUpdateEnd(dFloat timestep) {}
+	virtual void ApplyReactions() {}
+
 	dMatrix m_localFrame;
 	dVector m_gravity;
 	dVector m_obbSize;
@@ -72,6 +91,9 @@ class dVehicle: public dVehicleNode
 	NewtonBody* m_newtonBody;
 	void* m_managerNode;
 	dVehicleManager* m_manager;
+	dLodTier m_lodTier;
+	int m_lodCounter;
+	int m_lodPhase;
 
 	friend class dVehicleTire;
 	friend class dVehicleManager;
@@ -17,6 +17,11 @@
 dVehicleManager::dVehicleManager(NewtonWorld* const world)
 	:dCustomParallelListener(world, D_VEHICLE_MANAGER_NAME)
 	,m_list()
+	,m_items()
+	,m_tireQueries()
+	,m_fullTierImportance(0.5f)
+	,m_reducedTierImportance(0.1f)
+	,m_lowRateInterval(4)
 {
 }
 
@@ -33,6 +38,7 @@ void dVehicleManager::AddRoot(dVehicle* const root)
 	dAssert(!root->m_managerNode);
 	root->m_managerNode = m_list.Append(root);
 	root->m_manager = this;
+	root->m_lodPhase = m_list.GetCount();
 }
 
 void dVehicleManager::RemoveRoot(dVehicle* const root)
@@ -51,6 +57,29 @@ void dVehicleManager::RemoveAndDeleteRoot(dVehicle* const root)
 	delete root;
 }
 
+void dVehicleManager::SetLodThresholds(dFloat fullTierImportance, dFloat reducedTierImportance)
+{
+	m_fullTierImportance = fullTierImportance;
+	m_reducedTierImportance = dMin(reducedTierImportance, fullTierImportance);
+}
+
+void dVehicleManager::SetLowRateInterval(int steps)
+{
+	m_lowRateInterval = dMax(steps, 1);
+}
+
+void dVehicleManager::UpdateLodTier(dVehicle* const vehicle) const
+{
+	dVehicle::dLodTier tier = dVehicle::m_lowRateTier;
+	const dFloat importance = CalculateLodImportance(vehicle);
+	if (importance >= m_fullTierImportance) {
+		tier = dVehicle::m_fullTier;
+	} else if (importance >= m_reducedTierImportance) {
+		tier = dVehicle::m_reducedTier;
+	}
+	vehicle->SetLodTier(tier);
+}
+
 void dVehicleManager::OnDebug(dCustomJoint::dDebugDisplay* const debugContext)
 {
 	for (dList<dVehicle*>::dListNode* vehicleNode = m_list.GetFirst(); vehicleNode; vehicleNode = vehicleNode->GetNext()) {
@@ -60,70 +89,72 @@ void dVehicleManager::OnDebug(dCustomJoint::dDebugDisplay* const debugContext)
 	}
 }
 
-void dVehicleManager::PostUpdate(dFloat timestep, int threadID)
+int dVehicleManager::GetPassCount(dParallelPhase phase) const
 {
-	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
-
-	dList<dVehicle*>::dListNode* node = m_list.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
-	}
+	// the pre update runs vehicles, then the tire queries of all vehicles, then vehicles again,
+	// and finally adds the recorded tire reactions serially
+	return (phase == m_preUpdatePhase) ? 4 : 1;
+}
 
-	if (node) {
-		do {
-			dVehicle* const vehicle = node->GetInfo();
-			OnPostUpdate(vehicle, timestep);
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
+int dVehicleManager::PrepareItems(dParallelPhase phase, dFloat timestep)
+{
+	int count = 0;
+	if ((phase == m_preUpdatePhase) && (GetPass() == 1)) {
+		for (int i = 0; i < m_list.GetCount(); i++) {
+			dVehicle* const vehicle = m_items[i];
+			const int queryCount = vehicle->GetTireQueryCount();
+			for (int j = 0; j < queryCount; j++) {
+				dTireQueryItem& item = m_tireQueries[count];
+				item.m_vehicle = vehicle;
+				item.m_index = j;
+				count++;
 			}
-		} while (node);
+		}
+	} else if ((phase == m_preUpdatePhase) && (GetPass() == 3)) {
+		// several vehicles can stand on the same body, or on each other, so their reactions are added in list order here
+		for (int i = 0; i < m_list.GetCount(); i++) {
+			m_items[i]->ApplyReactions();
+		}
+	} else if (GetPass() == 0) {
+		for (dList<dVehicle*>::dListNode* node = m_list.GetFirst(); node; node = node->GetNext()) {
+			m_items[count] = node->GetInfo();
+			count++;
+		}
+	} else {
+		count = m_list.GetCount();
 	}
+	return count;
 }
 
-void dVehicleManager::PreUpdate(dFloat timestep, int threadID)
+void dVehicleManager::UpdateItem(dParallelPhase phase, dFloat timestep, int item, int threadID)
 {
 	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
-
-	dList<dVehicle*>::dListNode* node = m_list.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
+	if ((phase == m_preUpdatePhase) && (GetPass() == 1)) {
+		const dTireQueryItem& query = m_tireQueries[item];
+		query.m_vehicle->UpdateTireQuery(query.m_index, threadID);
+		return;
 	}
 
-	if (node) {
-		do {
-			dVehicle* const vehicle = node->GetInfo();
-			OnPreUpdate(vehicle, timestep);
-			vehicle->PreUpdate(timestep);
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
+	dVehicle* const vehicle = m_items[item];
+	switch (phase)
+	{
+		case m_preUpdatePhase:
+			if (GetPass() == 0) {
+				OnPreUpdate(vehicle, timestep);
+				UpdateLodTier(vehicle);
+				vehicle->PreUpdateBegin(timestep);
+			} else {
+				vehicle->PreUpdateEnd(timestep);
 			}
-		} while (node);
-	}
-}
+			break;
 
-void dVehicleManager::PostStep(dFloat timestep, int threadID)
-{
-	D_TRACKTIME();
-	NewtonWorld* const world = GetWorld();
-	const int threadCount = NewtonGetThreadsCount(world);
-
-	dList<dVehicle*>::dListNode* node = m_list.GetFirst();
-	for (int i = 0; i < threadID; i++) {
-		node = node ? node->GetNext() : NULL;
-	}
+		case m_postUpdatePhase:
+			OnPostUpdate(vehicle, timestep);
+			break;
 
-	if (node) {
-		do {
-			dVehicle* const vehicle = node->GetInfo();
+		case m_postStepPhase:
 			OnUpdateTransform(vehicle);
-			for (int i = 0; i < threadCount; i++) {
-				node = node ? node->GetNext() : NULL;
-			}
-		} while (node);
+			break;
 	}
 }
 
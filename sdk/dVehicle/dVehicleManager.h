@@ -23,6 +23,13 @@ class dVehicleNode;
 
 class dVehicleManager: public dCustomParallelListener
 {
+	class dTireQueryItem
+	{
+		public:
+		dVehicle* m_vehicle;
+		int m_index;
+	};
+
 	public:
 	DVEHICLE_API dVehicleManager(NewtonWorld* const world);
 	DVEHICLE_API virtual ~dVehicleManager();
@@ -32,18 +39,34 @@ class dVehicleManager: public dCustomParallelListener
 	DVEHICLE_API void RemoveAndDeleteRoot(dVehicle* const root);
 	DVEHICLE_API virtual void UpdateDriverInput(dVehicle* const vehicle, dFloat timestep) {}
 
+	// vehicles with importance at or above the full threshold run the complete multibody model,
+	// at or above the reduced threshold run raycast suspension with a lumped drivetrain, 
+	// and below that run the reduced model once every low rate interval steps.
+	DVEHICLE_API void SetLodThresholds(dFloat fullTierImportance, dFloat reducedTierImportance);
+	DVEHICLE_API void SetLowRateInterval(int steps);
+	int GetLowRateInterval() const {return m_lowRateInterval;}
+
+	// called from worker threads, must not modify shared state
+	virtual dFloat CalculateLodImportance(const dVehicle* const vehicle) const {return 1.0f;}
+
 	virtual void OnUpdateTransform(const dVehicle* const vehicle) const {}
 	virtual void OnPreUpdate(dVehicle* const model, dFloat timestep) const {};
 	virtual void OnPostUpdate(dVehicle* const model, dFloat timestep) const {};
 	virtual void OnDebug(dVehicle* const model, dCustomJoint::dDebugDisplay* const debugContext) {}
 
 	protected:
-	DVEHICLE_API void PostStep(dFloat timestep, int threadID);
-	DVEHICLE_API void PreUpdate(dFloat timestep, int threadID);
-	DVEHICLE_API void PostUpdate(dFloat timestep, int threadID);
+	DVEHICLE_API int GetPassCount(dParallelPhase phase) const;
+	DVEHICLE_API int PrepareItems(dParallelPhase phase, dFloat timestep);
+	DVEHICLE_API void UpdateItem(dParallelPhase phase, dFloat timestep, int item, int threadID);
 	DVEHICLE_API void OnDebug(dCustomJoint::dDebugDisplay* const debugContext);
+	DVEHICLE_API void UpdateLodTier(dVehicle* const vehicle) const;
 
 	dList<dVehicle*> m_list;
+	dArray<dVehicle*> m_items;
+	dArray<dTireQueryItem> m_tireQueries;
+	dFloat m_fullTierImportance;
+	dFloat m_reducedTierImportance;
+	int m_lowRateInterval;
 };
 
 
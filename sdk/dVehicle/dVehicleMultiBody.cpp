@@ -23,7 +23,13 @@ dVehicleMultiBody::dVehicleMultiBody(NewtonBody* const body, const dMatrix& loca
 	:dVehicle(body, localFrame, gravityMag)
 	,dVehicleSolver()
 	,m_collidingNodes(8)
+	,m_queryTires()
+	,m_queryBodies(body)
 	,m_collidingIndex(0)
+	,m_lodTimestep(0.0f)
+	,m_queryTireCount(0)
+	,m_lodHold(false)
+	,m_lodGrounded(false)
 {
 	m_brakeControl.Init(this);
 	m_engineControl.Init(this);
@@ -576,27 +582,97 @@ int dVehicleMultiBody::OnAABBOverlap(const NewtonBody * const body, void* const
 	return 1;
 }
 
-void dVehicleMultiBody::CalculateTireContacts(dFloat timestep)
+void dVehicleMultiBody::CollectTireQueries()
 {
-	const dMatrix& matrix = m_proxyBody.GetMatrix();
-	dVector origin(matrix.TransformVector(m_obbOrigin));
-	dVector size(matrix.m_front.Abs().Scale(m_obbSize.m_x) + matrix.m_up.Abs().Scale(m_obbSize.m_y) + matrix.m_right.Abs().Scale(m_obbSize.m_z));
-
-	dVector p0 (origin - size);
-	dVector p1 (origin + size);
+	// the reduced tiers cast one ray per tire and do not need the colliding bodies
+	m_queryBodies.m_count = 0;
+	if (m_lodTier == m_fullTier) {
+		const dMatrix& matrix = m_proxyBody.GetMatrix();
+		dVector origin(matrix.TransformVector(m_obbOrigin));
+		dVector size(matrix.m_front.Abs().Scale(m_obbSize.m_x) + matrix.m_up.Abs().Scale(m_obbSize.m_y) + matrix.m_right.Abs().Scale(m_obbSize.m_z));
+
+		dVector p0 (origin - size);
+		dVector p1 (origin + size);
+
+		NewtonWorld* const world = NewtonBodyGetWorld(GetBody());
+		NewtonWorldForEachBodyInAABBDo(world, &p0.m_x, &p1.m_x, OnAABBOverlap, &m_queryBodies);
+	}
 
-	dCollectCollidingBodies bodyList(GetBody());
-	NewtonWorld* const world = NewtonBodyGetWorld(GetBody());
-	NewtonWorldForEachBodyInAABBDo(world, &p0.m_x, &p1.m_x, OnAABBOverlap, &bodyList);
-	
+	m_queryTireCount = 0;
 	for (dVehicleNodeChildrenList::dListNode* node = m_children.GetFirst(); node; node = node->GetNext()) {
 		dVehicleTire* const tire = node->GetInfo()->GetAsTire();
 		if (tire) {
-			tire->CalculateContacts(bodyList, timestep);
+			m_queryTires[m_queryTireCount] = tire;
+			m_queryTireCount++;
 		}
 	}
 }
 
+void dVehicleMultiBody::CalculateTireContacts(dFloat timestep)
+{
+	for (int i = 0; i < m_queryTireCount; i++) {
+		m_queryTires[i]->CalculateContacts(m_queryBodies, timestep);
+	}
+}
+
+void dVehicleMultiBody::CalculateReducedForces(dFloat timestep)
+{
+	int groundedCount = 0;
+	dFloat averageOmega = 0.0f;
+	for (int i = 0; i < m_queryTireCount; i++) {
+		dVehicleTire* const tire = m_queryTires[i];
+		if (m_lodHold) {
+			tire->ProjectSuspensionRay();
+		}
+		groundedCount += tire->HasRayContact() ? 1 : 0;
+	}
+	if (!m_lodHold) {
+		m_lodGrounded = (groundedCount == m_queryTireCount);
+	}
+
+	// lumped drivetrain: the engine torque in first gear is split evenly between the grounded tires
+	dFloat driveTorque = 0.0f;
+	dVehicleEngine* const engine = m_engineControl.GetEngine();
+	if (engine && groundedCount) {
+		const dEngineInfo& info = engine->GetInfo();
+		const dMatrix& matrix = m_proxyBody.GetMatrix();
+		dFloat forwardSpeed = m_proxyBody.GetVelocity().DotProduct3(matrix.RotateVector(m_localFrame.m_front));
+		if (forwardSpeed < info.m_topSpeedInMetersPerSeconds) {
+			driveTorque = m_engineControl.GetParam() * info.m_peakTorque * info.m_crownGear * info.m_gearRatios[dEngineInfo::m_firstGear] / groundedCount;
+		}
+	}
+
+	dVector force(0.0f);
+	dVector torque(0.0f);
+	const dFloat massShare = m_proxyBody.GetMass() / dMax(groundedCount, 1);
+	for (int i = 0; i < m_queryTireCount; i++) {
+		dVehicleTire* const tire = m_queryTires[i];
+		tire->CalculateReducedForces(timestep, driveTorque, massShare, force, torque);
+		averageOmega += dAbs(tire->m_omega);
+		if (!m_lodHold) {
+			tire->m_brakeTorque = 0.0f;
+		}
+	}
+
+	// keep the engine spinning with the wheels so that switching back to the full model is smooth
+	if (engine && m_queryTireCount) {
+		const dEngineInfo& info = engine->GetInfo();
+		dFloat omega = averageOmega * info.m_crownGear * info.m_gearRatios[dEngineInfo::m_firstGear] / m_queryTireCount;
+		engine->m_omega = dMin(omega, engine->m_metricInfo.m_rpmAtRedLine);
+	}
+
+	NewtonBodyAddForce(m_newtonBody, &force[0]);
+	NewtonBodyAddTorque(m_newtonBody, &torque[0]);
+	NewtonBodySetSleepState(m_newtonBody, 0);
+}
+
+void dVehicleMultiBody::ApplyReactions()
+{
+	for (int i = 0; i < m_queryTireCount; i++) {
+		m_queryTires[i]->ApplyReducedReaction();
+	}
+}
+
 void dVehicleMultiBody::Integrate(dFloat timestep)
 {
 	m_proxyBody.IntegrateForce(timestep, m_proxyBody.GetForce(), m_proxyBody.GetTorque());
@@ -631,18 +707,76 @@ void dVehicleMultiBody::CalculateFreeDof()
 }
 
 void dVehicleMultiBody::PreUpdate(dFloat timestep)
+{
+	PreUpdateBegin(timestep);
+	const int queryCount = GetTireQueryCount();
+	for (int i = 0; i < queryCount; i++) {
+		UpdateTireQuery(i, 0);
+	}
+	PreUpdateEnd(timestep);
+	ApplyReactions();
+}
+
+void dVehicleMultiBody::PreUpdateBegin(dFloat timestep)
 {
 //xxxxx++;
 //dTrace(("%d\n", xxxxx));
 
-	m_manager->UpdateDriverInput(this, timestep);
-	m_brakeControl.Update(timestep);
-	m_handBrakeControl.Update(timestep);
-	m_steeringControl.Update(timestep);
-	m_engineControl.Update(timestep);
+	m_lodHold = false;
+	m_lodTimestep += timestep;
+	if (m_lodTier == m_lowRateTier) {
+		// low rate steps skip the controls and the ray casts and reuse the last contact planes,
+		// a vehicle with a tire off the ground keeps casting every step until it lands.
+		const int interval = m_manager->GetLowRateInterval();
+		m_lodCounter++;
+		if ((m_lodCounter < interval) && m_lodGrounded) {
+			m_lodHold = true;
+		} else {
+			// after a tier switch the update phase is staggered so that vehicles do not all update on the same step
+			m_lodCounter = (m_lodCounter > interval) ? (m_lodPhase % interval) : 0;
+		}
+	}
+
+	if (!m_lodHold) {
+		// controls advance by the time elapsed since the last update
+		const dFloat controlTimestep = m_lodTimestep;
+		m_lodTimestep = 0.0f;
+
+		m_manager->UpdateDriverInput(this, controlTimestep);
+		m_brakeControl.Update(controlTimestep);
+		m_handBrakeControl.Update(controlTimestep);
+		m_steeringControl.Update(controlTimestep);
+		m_engineControl.Update(controlTimestep);
+	}
 
 	ApplyExternalForce();
-	CalculateSuspensionForces(timestep);
+	if (m_lodTier == m_fullTier) {
+		CalculateSuspensionForces(timestep);
+	}
+	CollectTireQueries();
+}
+
+int dVehicleMultiBody::GetTireQueryCount() const
+{
+	return m_lodHold ? 0 : m_queryTireCount;
+}
+
+void dVehicleMultiBody::UpdateTireQuery(int index, int threadIndex)
+{
+	if (m_lodTier == m_fullTier) {
+		m_queryTires[index]->CollideBodies(m_queryBodies, threadIndex);
+	} else {
+		m_queryTires[index]->CastSuspensionRay(threadIndex);
+	}
+}
+
+void dVehicleMultiBody::PreUpdateEnd(dFloat timestep)
+{
+	if (m_lodTier != m_fullTier) {
+		CalculateReducedForces(timestep);
+		return;
+	}
+
 	CalculateTireContacts(timestep);
 	dVehicleSolver::Update(timestep);
 	Integrate(timestep);
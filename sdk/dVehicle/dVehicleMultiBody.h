@@ -64,8 +64,10 @@ class dVehicleMultiBody: public dVehicle, public dVehicleSolver
 	void CalculateFreeDof();
 	void ApplyExternalForce();
 	void Integrate(dFloat timestep);
+	void CollectTireQueries();
 	void CalculateTireContacts(dFloat timestep);
 	void CalculateSuspensionForces(dFloat timestep);
+	void CalculateReducedForces(dFloat timestep);
 	virtual int GetKinematicLoops(dVehicleLoopJoint** const jointArray);
 	virtual void ApplyDriverInputs(const dDriverInput& driveInputs, dFloat timestep);
 
@@ -73,15 +75,26 @@ class dVehicleMultiBody: public dVehicle, public dVehicleSolver
 
 	void PreUpdate(dFloat timestep);
 	//void PostUpdate(dFloat timestep);
+	void PreUpdateBegin(dFloat timestep);
+	int GetTireQueryCount() const;
+	void UpdateTireQuery(int index, int threadIndex);
+	void PreUpdateEnd(dFloat timestep);
+	void ApplyReactions();
 
 	static int OnAABBOverlap(const NewtonBody * const body, void* const me);
 
 	dArray<dVehicleCollidingNode> m_collidingNodes;
+	dArray<dVehicleTire*> m_queryTires;
+	dCollectCollidingBodies m_queryBodies;
 	dVehicleBrakeControl m_brakeControl;
 	dVehicleEngineControl m_engineControl;
 	dVehicleBrakeControl m_handBrakeControl;
 	dVehicleSteeringControl m_steeringControl;
 	int m_collidingIndex;
+	dFloat m_lodTimestep;
+	int m_queryTireCount;
+	bool m_lodHold;
+	bool m_lodGrounded;
 
 	friend class dVehicleTire;
 	friend class dVehicleSolver;
@@ -19,6 +19,9 @@
 #define D_DIAG_REGULARIZER		dFloat(1.0e-4f)
 #define D_MAX_FRICTION_BOUND	(D_COMPLEMENTARITY_MAX_FRICTION_BOUND * dFloat(0.5f))
 
+// number of right hand sides solved together by the lane forward and backward passes
+#define D_SOLVER_LANES			4
+
 class dVehicleSolver::dMatrixData
 {
 	public:
@@ -41,6 +44,15 @@ class dVehicleSolver::dVectorPair
 	dSpatialVector m_body;
 };
 
+// spatial vector pairs for D_SOLVER_LANES right hand sides, the lane index is the fastest changing 
+// so that the inner loops of the lane passes map directly to simd registers.
+class dVehicleSolver::dLaneVectorPair
+{
+	public:
+	dFloat m_joint[6][D_SOLVER_LANES];
+	dFloat m_body[6][D_SOLVER_LANES];
+};
+
 class dVehicleSolver::dBodyJointMatrixDataPair
 {
 	public:
@@ -491,50 +503,52 @@ void dVehicleSolver::InitLoopMassMatrix()
 
 	CalculateLoopMassMatrixCoefficients();
 
-	const dSpatialVector zero(0.0f);
-	dVectorPair* const accelPair = dAlloca(dVectorPair, m_nodeCount);
-	dVectorPair* const forcePair = dAlloca(dVectorPair, m_nodeCount);
+	// each auxiliary row needs one forward and backward solve with the same factorization, 
+	// so the rows are solved D_SOLVER_LANES at a time.
+	dLaneVectorPair* const accelPair = dAlloca(dLaneVectorPair, m_nodeCount);
+	dLaneVectorPair* const forcePair = dAlloca(dLaneVectorPair, m_nodeCount);
 
-	accelPair[m_nodeCount - 1].m_body = zero;
-	accelPair[m_nodeCount - 1].m_joint = zero;
-	for (int i = 0; i < auxiliaryIndex; i++) {
-		int entry = 0;
+	memset(accelPair, 0, m_nodeCount * sizeof(dLaneVectorPair));
+	for (int i = 0; i < auxiliaryIndex; i += D_SOLVER_LANES) {
 		int startjoint = m_nodeCount;
-		const dFloat* const matrixRow10 = &m_massMatrix10[i * primaryCount];
-
-		for (int j = 0; j < nodeCount; j++) {
-			dVehicleNode* const node = m_nodesOrder[j];
-			const int index = node->m_index;
-			const dComplementaritySolver::dBilateralJoint* const joint = node->GetJoint();
-
-			accelPair[index].m_body = zero;
-			dSpatialVector& a = accelPair[index].m_joint;
-
-			const int count = joint->m_dof;
-			for (int k = 0; k < count; k++) {
-				const dFloat value = matrixRow10[entry];
-				a[k] = value;
-				startjoint = (value == 0.0f) ? startjoint : dMin(startjoint, index);
-				entry++;
+		const int lanes = dMin(auxiliaryIndex - i, D_SOLVER_LANES);
+		for (int lane = 0; lane < D_SOLVER_LANES; lane++) {
+			int entry = 0;
+			const dFloat* const matrixRow10 = &m_massMatrix10[(i + lane) * primaryCount];
+			for (int j = 0; j < nodeCount; j++) {
+				dVehicleNode* const node = m_nodesOrder[j];
+				const int index = node->m_index;
+				const dComplementaritySolver::dBilateralJoint* const joint = node->GetJoint();
+
+				dLaneVectorPair& a = accelPair[index];
+				const int count = joint->m_dof;
+				for (int k = 0; k < count; k++) {
+					const dFloat value = (lane < lanes) ? matrixRow10[entry] : dFloat(0.0f);
+					a.m_joint[k][lane] = value;
+					startjoint = (value == 0.0f) ? startjoint : dMin(startjoint, index);
+					entry++;
+				}
 			}
 		}
 
-		entry = 0;
 		startjoint = (startjoint == m_nodeCount) ? 0 : startjoint;
 		dAssert(startjoint < m_nodeCount);
-		SolveForward(forcePair, accelPair, startjoint);
-		SolveBackward(forcePair, forcePair);
-
-		dFloat* const deltaForcePtr = &m_deltaForce[i * primaryCount];
-		for (int j = 0; j < nodeCount; j++) {
-			dVehicleNode* const node = m_nodesOrder[j];
-			const dComplementaritySolver::dBilateralJoint* const joint = node->GetJoint();
-			const int index = node->m_index;
-			const dSpatialVector& f = forcePair[index].m_joint;
-			const int count = joint->m_dof;
-			for (int k = 0; k < count; k++) {
-				deltaForcePtr[entry] = f[k];
-				entry++;
+		SolveForwardLanes(forcePair, accelPair, startjoint);
+		SolveBackwardLanes(forcePair);
+
+		for (int lane = 0; lane < lanes; lane++) {
+			int entry = 0;
+			dFloat* const deltaForcePtr = &m_deltaForce[(i + lane) * primaryCount];
+			for (int j = 0; j < nodeCount; j++) {
+				dVehicleNode* const node = m_nodesOrder[j];
+				const dComplementaritySolver::dBilateralJoint* const joint = node->GetJoint();
+				const int index = node->m_index;
+				const dLaneVectorPair& f = forcePair[index];
+				const int count = joint->m_dof;
+				for (int k = 0; k < count; k++) {
+					deltaForcePtr[entry] = f.m_joint[k][lane];
+					entry++;
+				}
 			}
 		}
 	}
@@ -825,6 +839,115 @@ void dVehicleSolver::SolveBackward(dVectorPair* const force, const dVectorPair*
 	}
 }
 
+void dVehicleSolver::SolveForwardLanes(dLaneVectorPair* const force, const dLaneVectorPair* const accel, int startNode) const
+{
+	// same as SolveForward, for D_SOLVER_LANES right hand sides at once
+	memset(force, 0, startNode * sizeof(dLaneVectorPair));
+
+	const int n = m_nodeCount - 1;
+	for (int i = startNode; i <= n; i++) {
+		dVehicleNode* const node = m_nodesOrder[i];
+		dAssert(i == node->m_index);
+
+		dLaneVectorPair& f = force[i];
+		f = accel[i];
+		if (i == n) {
+			memset(f.m_joint, 0, sizeof(f.m_joint));
+		}
+
+		for (dVehicleNodeChildrenList::dListNode* childNode = node->m_children.GetFirst(); childNode; childNode = childNode->GetNext()) {
+			dVehicleNode* const child = childNode->GetInfo();
+			dAssert(child->GetParent()->m_index == i);
+			const dLaneVectorPair& childForce = force[child->m_index];
+			const dSpatialMatrix& jointJ = m_data[child->m_index].m_joint.m_jt;
+			const int dof = child->GetJoint()->m_dof;
+			for (int j = 0; j < dof; j++) {
+				for (int k = 0; k < 6; k++) {
+					const dFloat J = jointJ[j][k];
+					for (int lane = 0; lane < D_SOLVER_LANES; lane++) {
+						f.m_body[k][lane] -= J * childForce.m_joint[j][lane];
+					}
+				}
+			}
+		}
+
+		if (i < n) {
+			const dSpatialMatrix& bodyJt = m_data[i].m_body.m_jt;
+			const int dof = node->GetJoint()->m_dof;
+			for (int j = 0; j < dof; j++) {
+				for (int k = 0; k < 6; k++) {
+					const dFloat J = bodyJt[j][k];
+					for (int lane = 0; lane < D_SOLVER_LANES; lane++) {
+						f.m_joint[j][lane] -= J * f.m_body[k][lane];
+					}
+				}
+			}
+		}
+	}
+
+	for (int i = startNode; i <= n; i++) {
+		dLaneVectorPair& f = force[i];
+		dFloat tmp[6][D_SOLVER_LANES];
+
+		const dSpatialMatrix& bodyInvMass = m_data[i].m_body.m_invMass;
+		memset(tmp, 0, sizeof(tmp));
+		for (int j = 0; j < 6; j++) {
+			for (int k = 0; k < 6; k++) {
+				const dFloat m = bodyInvMass[j][k];
+				for (int lane = 0; lane < D_SOLVER_LANES; lane++) {
+					tmp[k][lane] += m * f.m_body[j][lane];
+				}
+			}
+		}
+		memcpy(f.m_body, tmp, sizeof(tmp));
+
+		if (i < n) {
+			const dSpatialMatrix& jointInvMass = m_data[i].m_joint.m_invMass;
+			const int dof = m_nodesOrder[i]->GetJoint()->m_dof;
+			memset(tmp, 0, sizeof(tmp));
+			for (int j = 0; j < dof; j++) {
+				for (int k = 0; k < 6; k++) {
+					const dFloat m = jointInvMass[j][k];
+					for (int lane = 0; lane < D_SOLVER_LANES; lane++) {
+						tmp[k][lane] += m * f.m_joint[j][lane];
+					}
+				}
+			}
+			memcpy(f.m_joint, tmp, sizeof(tmp));
+		}
+	}
+}
+
+void dVehicleSolver::SolveBackwardLanes(dLaneVectorPair* const force) const
+{
+	// same as SolveBackward, for D_SOLVER_LANES right hand sides at once
+	for (int i = m_nodeCount - 2; i >= 0; i--) {
+		dVehicleNode* const node = m_nodesOrder[i];
+		dAssert(i == node->m_index);
+		dLaneVectorPair& f = force[i];
+		const dLaneVectorPair& parentForce = force[node->GetParent()->m_index];
+		const dSpatialMatrix& jointJ = m_data[i].m_joint.m_jt;
+		const dSpatialMatrix& bodyJt = m_data[i].m_body.m_jt;
+		const int dof = node->GetJoint()->m_dof;
+		for (int j = 0; j < dof; j++) {
+			for (int k = 0; k < 6; k++) {
+				const dFloat J = jointJ[j][k];
+				for (int lane = 0; lane < D_SOLVER_LANES; lane++) {
+					f.m_joint[j][lane] -= J * parentForce.m_body[k][lane];
+				}
+			}
+		}
+		for (int j = 0; j < dof; j++) {
+			for (int k = 0; k < 6; k++) {
+				const dFloat J = bodyJt[j][k];
+				for (int lane = 0; lane < D_SOLVER_LANES; lane++) {
+					f.m_body[k][lane] -= J * f.m_joint[j][lane];
+				}
+			}
+		}
+	}
+}
+
 void dVehicleSolver::CalculateOpenLoopForce(dVectorPair* const force, const dVectorPair* const accel) const
 {
 	SolveForward(force, accel, 0);
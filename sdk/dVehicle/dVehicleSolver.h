@@ -23,6 +23,7 @@ class dVehicleSolver
 {
 	class dNodePair;
 	class dVectorPair;
+	class dLaneVectorPair;
 	class dMatrixData;
 	class dBodyJointMatrixDataPair;
 
@@ -57,6 +58,8 @@ class dVehicleSolver
 
 	void SolveBackward(dVectorPair* const force, const dVectorPair* const accel) const;
 	void SolveForward(dVectorPair* const force, const dVectorPair* const accel, int startNode) const;
+	void SolveBackwardLanes(dLaneVectorPair* const force) const;
+	void SolveForwardLanes(dLaneVectorPair* const force, const dLaneVectorPair* const accel, int startNode) const;
 
 	void BodyDiagInvTimeSolution(dVehicleNode* const node, dVectorPair& force) const;
 	void JointDiagInvTimeSolution(dVehicleNode* const node, dVectorPair& force) const;
@@ -23,6 +23,14 @@ dVehicleTire::dVehicleTire(dVehicleMultiBody* const chassis, const dMatrix& loca
 	,dBilateralJoint()
 	,m_matrix(dGetIdentityMatrix())
 	,m_bindingRotation(dGetIdentityMatrix())
+	,m_rayPoint(0.0f)
+	,m_rayNormal(0.0f)
+	,m_rayReactionForce(0.0f)
+	,m_rayReactionTorque(0.0f)
+	,m_rayBody(NULL)
+	,m_rayReactionBody(NULL)
+	,m_rayParam(1.0f)
+	,m_hasRayPlane(false)
 	,m_info(info)
 	,m_tireShape(NULL)
 	,m_omega(0.0f)
@@ -33,6 +41,7 @@ dVehicleTire::dVehicleTire(dVehicleMultiBody* const chassis, const dMatrix& loca
 	,m_steeringAngle(0.0f)
 	,m_invSuspensionLength(m_info.m_suspensionLength > 0.0f ? 1.0f / m_info.m_suspensionLength : 0.0f)
 	,m_contactCount(0)
+	,m_queryContactCount(0)
 {
 	Init(&m_proxyBody, &GetParent()->GetProxyBody());
 	
@@ -133,56 +142,87 @@ int dVehicleTire::GetKinematicLoops(dVehicleLoopJoint** const jointArray)
 	return count;
 }
 
-void dVehicleTire::CalculateContacts(const dCollectCollidingBodies& bodyArray, dFloat timestep)
+void dVehicleTire::CollideBodies(const dCollectCollidingBodies& bodyArray, int threadIndex)
 {
-	for (int i = 0; i < sizeof(m_contactsJoints) / sizeof(m_contactsJoints[0]); i++) {
-		m_contactsJoints[i].ResetContact();
-	}
-
-	int contactCount = 0;
-	dFloat friction = m_info.m_frictionCoefficient;
-
 	dVehicleMultiBody* const chassisNode = GetParent()->GetAsVehicleMultiBody();
 	NewtonWorld* const world = NewtonBodyGetWorld(chassisNode->GetBody());
-	dComplementaritySolver::dBodyState* const chassisBody = &chassisNode->GetProxyBody();
+	m_queryMatrix = GetHardpointMatrix(m_position * m_invSuspensionLength) * chassisNode->GetProxyBody().GetMatrix();
+
+	// the chassis box collects bodies near every tire, skip the ones this tire can not touch
+	dVector tireMinP(0.0f);
+	dVector tireMaxP(0.0f);
+	const dVector padding(0.1f, 0.1f, 0.1f, 0.0f);
+	CalculateNodeAABB(m_queryMatrix, tireMinP, tireMaxP);
+	tireMinP -= padding;
+	tireMaxP += padding;
 
 	dMatrix matrixB;
-	dMatrix tireMatrix (GetHardpointMatrix(m_position * m_invSuspensionLength) * chassisBody->GetMatrix());
-	
-	const int maxContactCount = sizeof (m_contactsJoints) / sizeof (m_contactsJoints[0]);
+	const int maxContactCount = sizeof (m_queryContacts) / sizeof (m_queryContacts[0]);
 	dFloat points[maxContactCount][3];
 	dFloat normals[maxContactCount][3];
 	dFloat penetrations[maxContactCount];
 	dLong attributeA[maxContactCount];
 	dLong attributeB[maxContactCount];
 
-	for (int i = 0; (i < bodyArray.m_count) && (contactCount < maxContactCount); i++) {
-		// calculate tire contact collision with rigid bodies
+	m_queryContactCount = 0;
+	for (int i = 0; (i < bodyArray.m_count) && (m_queryContactCount < maxContactCount); i++) {
+		dVector minP(0.0f);
+		dVector maxP(0.0f);
+		NewtonBody* const body = bodyArray.m_array[i];
+		NewtonBodyGetAABB(body, &minP[0], &maxP[0]);
+		if ((minP.m_x > tireMaxP.m_x) || (minP.m_y > tireMaxP.m_y) || (minP.m_z > tireMaxP.m_z) ||
+			(maxP.m_x < tireMinP.m_x) || (maxP.m_y < tireMinP.m_y) || (maxP.m_z < tireMinP.m_z)) {
+			continue;
+		}
 
-		NewtonBodyGetMatrix(bodyArray.m_array[i], &matrixB[0][0]);
-		NewtonCollision* const otherShape = NewtonBodyGetCollision(bodyArray.m_array[i]);
+		// calculate tire contact collision with rigid bodies
+		NewtonBodyGetMatrix(body, &matrixB[0][0]);
+		NewtonCollision* const otherShape = NewtonBodyGetCollision(body);
 		int count = NewtonCollisionCollide(world, maxContactCount, 
-										   m_tireShape, &tireMatrix[0][0], 
+										   m_tireShape, &m_queryMatrix[0][0], 
 										   otherShape, &matrixB[0][0],
-										   &points[0][0], &normals[0][0], penetrations, attributeA, attributeB, 0);
-
-		for (int j = 0; (j < count) && (contactCount < maxContactCount); j ++) {
-			dVector normal (normals[j][0], normals[j][1], normals[j][2], dFloat (0.0f));
-			dVector longitudinalDir(normal.CrossProduct(tireMatrix.m_front));
-			if (longitudinalDir.DotProduct3(longitudinalDir) < 0.1f) {
-				longitudinalDir = normal.CrossProduct(tireMatrix.m_up.CrossProduct(normal));
-				dAssert(longitudinalDir.DotProduct3(longitudinalDir) > 0.1f);
-			}
+										   &points[0][0], &normals[0][0], penetrations, attributeA, attributeB, threadIndex);
+
+		for (int j = 0; (j < count) && (m_queryContactCount < maxContactCount); j ++) {
+			dTireQueryContact& contact = m_queryContacts[m_queryContactCount];
+			contact.m_point = dVector (points[j][0], points[j][1], points[j][2], dFloat (1.0f));
+			contact.m_normal = dVector (normals[j][0], normals[j][1], normals[j][2], dFloat (0.0f));
+			contact.m_penetration = penetrations[j];
+			contact.m_bodyIndex = i;
+			m_queryContactCount++;
+		}
+	}
+}
+
+void dVehicleTire::CalculateContacts(const dCollectCollidingBodies& bodyArray, dFloat timestep)
+{
+	for (int i = 0; i < sizeof(m_contactsJoints) / sizeof(m_contactsJoints[0]); i++) {
+		m_contactsJoints[i].ResetContact();
+	}
 
-			longitudinalDir = longitudinalDir.Normalize();
-			dVehicleCollidingNode* const collidingNode = chassisNode->FindCollideNode(this, bodyArray.m_array[i]);
-			m_contactsJoints[contactCount].SetOwners(this, collidingNode);
+	int contactCount = 0;
+	dFloat friction = m_info.m_frictionCoefficient;
+
+	dVehicleMultiBody* const chassisNode = GetParent()->GetAsVehicleMultiBody();
+	const dMatrix& tireMatrix = m_queryMatrix;
+	const int maxContactCount = sizeof (m_contactsJoints) / sizeof (m_contactsJoints[0]);
 
-			dVector contact (points[j][0], points[j][1], points[j][2], dFloat (1.0f));
-			m_contactsJoints[contactCount].SetContact(collidingNode, contact, normal, longitudinalDir, penetrations[j], friction, false);
-			contactCount++;
-			dAssert(contactCount <= sizeof(m_contactsJoints) / sizeof(m_contactsJoints[0]));
+	// colliding nodes are shared by all tires of the chassis, so this part runs once per vehicle
+	for (int i = 0; i < m_queryContactCount; i++) {
+		const dTireQueryContact& queryContact = m_queryContacts[i];
+		const dVector& normal = queryContact.m_normal;
+		dVector longitudinalDir(normal.CrossProduct(tireMatrix.m_front));
+		if (longitudinalDir.DotProduct3(longitudinalDir) < 0.1f) {
+			longitudinalDir = normal.CrossProduct(tireMatrix.m_up.CrossProduct(normal));
+			dAssert(longitudinalDir.DotProduct3(longitudinalDir) > 0.1f);
 		}
+
+		longitudinalDir = longitudinalDir.Normalize();
+		dVehicleCollidingNode* const collidingNode = chassisNode->FindCollideNode(this, bodyArray.m_array[queryContact.m_bodyIndex]);
+		m_contactsJoints[contactCount].SetOwners(this, collidingNode);
+		m_contactsJoints[contactCount].SetContact(collidingNode, queryContact.m_point, normal, longitudinalDir, queryContact.m_penetration, friction, false);
+		contactCount++;
+		dAssert(contactCount <= maxContactCount);
 	}
 
 	if (contactCount > 1) {
@@ -213,8 +253,163 @@ void dVehicleTire::CalculateContacts(const dCollectCollidingBodies& bodyArray, d
 				}
 			}
 		}
+	}
+	m_contactCount = contactCount; 
+}
+
+unsigned dVehicleTire::OnSuspensionRayPrefilter(const NewtonBody* const body, const NewtonCollision* const collision, void* const userData)
+{
+	const dVehicleTire* const tire = (dVehicleTire*)userData;
+	const dVehicleMultiBody* const chassis = tire->GetParent()->GetAsVehicleMultiBody();
+	return (body != chassis->GetBody()) ? 1 : 0;
+}
+
+dFloat dVehicleTire::OnSuspensionRayHit(const NewtonBody* const body, const NewtonCollision* const shapeHit, const dFloat* const hitContact, const dFloat* const hitNormal, dLong collisionID, void* const userData, dFloat intersectParam)
+{
+	dVehicleTire* const tire = (dVehicleTire*)userData;
+	if (intersectParam < tire->m_rayParam) {
+		tire->m_rayParam = intersectParam;
+		tire->m_rayBody = (NewtonBody*)body;
+		tire->m_rayPoint = dVector(hitContact[0], hitContact[1], hitContact[2], 1.0f);
+		tire->m_rayNormal = dVector(hitNormal[0], hitNormal[1], hitNormal[2], 0.0f);
+	}
+	return intersectParam;
+}
 
-		m_contactCount = contactCount; 
+void dVehicleTire::CastSuspensionRay(int threadIndex)
+{
+	// cast from the fully compressed hardpoint down to the bottom of the fully extended tire
+	dVehicleMultiBody* const chassis = GetParent()->GetAsVehicleMultiBody();
+	dMatrix matrix(GetHardpointMatrix(1.0f) * chassis->GetProxyBody().GetMatrix());
+
+	dVector p0(matrix.m_posit);
+	dVector p1(p0 - matrix.m_right.Scale(m_info.m_suspensionLength + m_info.m_radio));
+
+	m_rayParam = 1.0f;
+	m_rayBody = NULL;
+	NewtonWorld* const world = NewtonBodyGetWorld(chassis->GetBody());
+	NewtonWorldRayCast(world, &p0[0], &p1[0], OnSuspensionRayHit, this, OnSuspensionRayPrefilter, threadIndex);
+	m_hasRayPlane = m_rayBody ? true : false;
+}
+
+void dVehicleTire::ProjectSuspensionRay()
+{
+	// intersect the suspension line with the contact plane found by the last ray cast,
+	// the body that was hit may have been destroyed since, so it gets no reaction during a hold
+	m_rayBody = NULL;
+	if (m_hasRayPlane) {
+		dVehicleMultiBody* const chassis = GetParent()->GetAsVehicleMultiBody();
+		dMatrix matrix(GetHardpointMatrix(1.0f) * chassis->GetProxyBody().GetMatrix());
+		dFloat den = m_rayNormal.DotProduct3(matrix.m_right);
+		m_rayParam = 1.0f;
+		if (den > 1.0e-3f) {
+			dFloat dist = m_rayNormal.DotProduct3(matrix.m_posit - m_rayPoint) / den;
+			m_rayParam = dMax(dist / (m_info.m_suspensionLength + m_info.m_radio), dFloat(0.0f));
+		}
+	}
+}
+
+void dVehicleTire::CalculateReducedForces(dFloat timestep, dFloat driveTorque, dFloat massShare, dVector& force, dVector& torque)
+{
+	// raycast suspension with a friction circle tire, the suspension state is kept in the same 
+	// variables the full model uses so that the vehicle can switch tiers at any time.
+	dVehicleMultiBody* const chassis = GetParent()->GetAsVehicleMultiBody();
+	const dComplementaritySolver::dBodyState& chassisBody = chassis->GetProxyBody();
+	const dMatrix& chassisMatrix = chassisBody.GetMatrix();
+
+	dFloat position = 0.0f;
+	if (HasRayContact()) {
+		position = dClamp((1.0f - m_rayParam) * (m_info.m_suspensionLength + m_info.m_radio), dFloat(0.0f), m_info.m_suspensionLength);
+	}
+	m_speed = (position - m_position) / timestep;
+	m_position = position;
+
+	m_contactCount = 0;
+	for (int i = 0; i < sizeof (m_contactsJoints) / sizeof (m_contactsJoints[0]); i ++) {
+		m_contactsJoints[i].m_isActive = false;
+	}
+
+	dMatrix matrix(GetHardpointMatrix(m_position * m_invSuspensionLength) * chassisMatrix);
+	dVector contactPoint(matrix.m_posit - matrix.m_right.Scale(m_info.m_radio));
+	dVector veloc(chassisBody.CalculatePointVelocity(contactPoint));
+	dVector rollDir(matrix.m_front.CrossProduct(matrix.m_right));
+	m_omega = veloc.DotProduct3(rollDir) / m_info.m_radio;
+	m_tireAngle += m_omega * timestep;
+	while (m_tireAngle < 0.0f) {
+		m_tireAngle += 2.0f * dPi;
+	}
+	m_tireAngle = dMod(m_tireAngle, dFloat(2.0f * dPi));
+
+	dFloat brakeTorque = m_brakeTorque;
+	if (!HasRayContact()) {
+		return;
+	}
+
+	// same implicit spring damper the full model uses, so both tiers settle at the same ride height
+	const dFloat tireInvMass = m_proxyBody.GetInvMass();
+	const dFloat kv = m_info.m_dampingRatio * tireInvMass;
+	const dFloat ks = m_info.m_springStiffness * tireInvMass;
+	dFloat load = -NewtonCalculateSpringDamperAcceleration(timestep, ks, m_position, kv, m_speed) * m_info.m_mass;
+	load = dMax(load, dFloat(0.0f));
+
+	dVector lateralDir(matrix.m_front - m_rayNormal.Scale(matrix.m_front.DotProduct3(m_rayNormal)));
+	lateralDir = lateralDir.Scale(1.0f / dSqrt(lateralDir.DotProduct3(lateralDir) + 1.0e-12f));
+	dVector longitudinalDir(m_rayNormal.CrossProduct(lateralDir));
+	dVector forwardDir(chassisMatrix.RotateVector(chassis->GetLocalFrame().m_front));
+	if (longitudinalDir.DotProduct3(forwardDir) < 0.0f) {
+		longitudinalDir = longitudinalDir.Scale(-1.0f);
+	}
+
+	// friction forces try to cancel the contact slip velocity over one step
+	dFloat longitudinalSpeed = veloc.DotProduct3(longitudinalDir);
+	dFloat lateralForce = -0.5f * massShare * veloc.DotProduct3(lateralDir) / timestep;
+	dFloat longitudinalForce = driveTorque / m_info.m_radio;
+	if (brakeTorque > 0.0f) {
+		dFloat brakeForce = brakeTorque / m_info.m_radio;
+		longitudinalForce -= dClamp(massShare * longitudinalSpeed / timestep, -brakeForce, brakeForce);
+	}
+
+	dFloat maxFriction = m_info.m_frictionCoefficient * load;
+	dFloat frictionMag2 = lateralForce * lateralForce + longitudinalForce * longitudinalForce;
+	if (frictionMag2 > maxFriction * maxFriction) {
+		dFloat scale = maxFriction / dSqrt(frictionMag2);
+		lateralForce *= scale;
+		longitudinalForce *= scale;
+	}
+
+	dVector tireForce(matrix.m_right.Scale(load) + lateralDir.Scale(lateralForce) + longitudinalDir.Scale(longitudinalForce));
+	dVector chassisOrigin(chassisMatrix.TransformVector(chassisBody.GetCOM()));
+	force += tireForce;
+	torque += (contactPoint - chassisOrigin).CrossProduct(tireForce);
+
+	if (!m_rayBody) {
+		return;
+	}
+
+	dFloat invMass;
+	dFloat invIxx;
+	dFloat invIyy;
+	dFloat invIzz;
+	NewtonBodyGetInvMass(m_rayBody, &invMass, &invIxx, &invIyy, &invIzz);
+	if (invMass > 0.0f) {
+		// the reaction is only recorded here, vehicles update in parallel and several of them
+		// can stand on the same body, so the manager adds it after all vehicles are updated
+		dMatrix bodyMatrix;
+		dVector com;
+		NewtonBodyGetMatrix(m_rayBody, &bodyMatrix[0][0]);
+		NewtonBodyGetCentreOfMass(m_rayBody, &com[0]);
+		m_rayReactionForce = tireForce.Scale(-1.0f);
+		m_rayReactionTorque = (contactPoint - bodyMatrix.TransformVector(com)).CrossProduct(m_rayReactionForce);
+		m_rayReactionBody = m_rayBody;
+	}
+}
+
+void dVehicleTire::ApplyReducedReaction()
+{
+	if (m_rayReactionBody) {
+		NewtonBodyAddForce(m_rayReactionBody, &m_rayReactionForce[0]);
+		NewtonBodyAddTorque(m_rayReactionBody, &m_rayReactionTorque[0]);
+		m_rayReactionBody = NULL;
 	}
 }
 
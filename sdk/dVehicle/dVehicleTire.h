@@ -72,6 +72,15 @@ class dTireInfo
 
 class dVehicleTire: public dVehicleNode, public dComplementaritySolver::dBilateralJoint
 {
+	class dTireQueryContact
+	{
+		public:
+		dVector m_point;
+		dVector m_normal;
+		dFloat m_penetration;
+		int m_bodyIndex;
+	};
+
 	public:
 	DVEHICLE_API dVehicleTire(dVehicleMultiBody* const chassis, const dMatrix& locationInGlobalSpace, const dTireInfo& info);
 	DVEHICLE_API virtual ~dVehicleTire();
@@ -92,7 +101,13 @@ class dVehicleTire: public dVehicleNode, public dComplementaritySolver::dBilater
 	dMatrix GetHardpointMatrix (dFloat param) const;
 	int GetKinematicLoops(dVehicleLoopJoint** const jointArray);
 	void CalculateNodeAABB(const dMatrix& matrix, dVector& minP, dVector& maxP) const;
+	void CollideBodies(const dCollectCollidingBodies& bodyArray, int threadIndex);
 	void CalculateContacts(const dCollectCollidingBodies& bodyArray, dFloat timestep);
+	void CastSuspensionRay(int threadIndex);
+	void ProjectSuspensionRay();
+	bool HasRayContact() const {return m_rayParam < 1.0f;}
+	void CalculateReducedForces(dFloat timestep, dFloat driveTorque, dFloat massShare, dVector& force, dVector& torque);
+	void ApplyReducedReaction();
 
 	private: 
 	void CalculateFreeDof();
@@ -101,6 +116,8 @@ class dVehicleTire: public dVehicleNode, public dComplementaritySolver::dBilater
 	dComplementaritySolver::dBilateralJoint* GetJoint() {return this;}
 	const void Debug(dCustomJoint::dDebugDisplay* const debugContext) const;
 	static void RenderDebugTire(void* userData, int vertexCount, const dFloat* const faceVertec, int id);
+	static unsigned OnSuspensionRayPrefilter(const NewtonBody* const body, const NewtonCollision* const collision, void* const userData);
+	static dFloat OnSuspensionRayHit(const NewtonBody* const body, const NewtonCollision* const shapeHit, const dFloat* const hitContact, const dFloat* const hitNormal, dLong collisionID, void* const userData, dFloat intersectParam);
 
 	void JacobianDerivative(dComplementaritySolver::dParamInfo* const constraintParams);
 	void UpdateSolverForces(const dComplementaritySolver::dJacobianPair* const jacobians) const;
@@ -108,6 +125,16 @@ class dVehicleTire: public dVehicleNode, public dComplementaritySolver::dBilater
 	dMatrix m_matrix;
 	dMatrix m_bindingRotation;
 	dVehicleTireContact m_contactsJoints[3];
+	dTireQueryContact m_queryContacts[3];
+	dMatrix m_queryMatrix;
+	dVector m_rayPoint;
+	dVector m_rayNormal;
+	dVector m_rayReactionForce;
+	dVector m_rayReactionTorque;
+	NewtonBody* m_rayBody;
+	NewtonBody* m_rayReactionBody;
+	dFloat m_rayParam;
+	bool m_hasRayPlane;
 	dTireInfo m_info;
 	NewtonCollision* m_tireShape;
 	dFloat m_omega;
@@ -118,6 +145,7 @@ class dVehicleTire: public dVehicleNode, public dComplementaritySolver::dBilater
 	dFloat m_steeringAngle;
 	dFloat m_invSuspensionLength;
 	int m_contactCount;
+	int m_queryContactCount;
 	friend class dVehicleMultiBody;
 };
 
@@ -23,6 +23,11 @@
 #include "dgThread.h"
 #include "dgProfiler.h"
 
+#if defined (__linux__) && !defined (DG_USE_THREAD_EMULATION)
+	#include <sched.h>
+	#include <pthread.h>
+#endif
+
 dgThread::dgThread ()
 	:m_id(0)
 	,m_terminate(0)
@@ -52,6 +57,15 @@ bool dgThread::IsThreadActive() const
 	return m_threadRunning ? true : false;
 }
 
+bool dgThread::IsCallingThread() const
+{
+	#ifdef DG_USE_THREAD_EMULATION
+		return false;
+	#else
+		return m_handle.get_id() == std::this_thread::get_id();
+	#endif
+}
+
 #ifdef DG_USE_THREAD_EMULATION
 
 dgThread::dgSemaphore::dgSemaphore ()
@@ -71,6 +85,10 @@ void dgThread::dgSemaphore::Wait()
 {
 }
 
+void dgThread::dgSemaphore::Wait(dgInt32 spinCount)
+{
+}
+
 dgThread::~dgThread ()
 {
 }
@@ -91,6 +109,10 @@ void dgThread::Wait (dgInt32 count, dgSemaphore* const semArray)
 {
 }
 
+void dgThread::SetAffinity (dgInt32 firstCpu, dgInt32 cpuCount)
+{
+}
+
 void* dgThread::dgThreadSystemCallback(void* threadData)
 {
 	return 0;
@@ -125,6 +147,17 @@ void dgThread::dgSemaphore::Wait()
 	m_count --;
 }
 
+void dgThread::dgSemaphore::Wait(dgInt32 spinCount)
+{
+	// short waits are cheaper to spin than to park the thread in the kernel, 
+	// the count is only read as a hint, the blocking wait does the actual synchronization
+	const volatile dgInt32* const count = &m_count;
+	for (dgInt32 i = 0; (i < spinCount) && !*count; i ++) {
+		dgThreadPause();
+	}
+	Wait();
+}
+
 dgThread::~dgThread ()
 {
 }
@@ -157,6 +190,42 @@ void dgThread::SetName()
 	__except (EXCEPTION_EXECUTE_HANDLER)
 	{
 	}
+#elif defined (__linux__)
+	// linux thread names are limited to 15 characters
+	char name[16];
+	strncpy (name, m_name, sizeof (name) - 1);
+	name[sizeof (name) - 1] = 0;
+	pthread_setname_np(m_handle.native_handle(), name);
+#endif
+}
+
+void dgThread::SetAffinity (dgInt32 firstCpu, dgInt32 cpuCount)
+{
+	// a cpu count of zero lets the thread run on any cpu
+#if (defined (_WIN_32_VER) || defined (_WIN_64_VER))
+	DWORD_PTR mask = 0;
+	for (dgInt32 i = 0; i < cpuCount; i ++) {
+		const dgInt32 cpu = firstCpu + i;
+		if ((cpu >= 0) && (cpu < dgInt32 (sizeof (DWORD_PTR) * 8))) {
+			mask |= DWORD_PTR (1) << cpu;
+		}
+	}
+	SetThreadAffinityMask(m_handle.native_handle(), mask ? mask : ~DWORD_PTR (0));
+#elif defined (__linux__)
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	for (dgInt32 i = 0; i < cpuCount; i ++) {
+		const dgInt32 cpu = firstCpu + i;
+		if ((cpu >= 0) && (cpu < CPU_SETSIZE)) {
+			CPU_SET(cpu, &cpuSet);
+		}
+	}
+	if (!CPU_COUNT(&cpuSet)) {
+		for (dgInt32 i = 0; i < CPU_SETSIZE; i ++) {
+			CPU_SET(i, &cpuSet);
+		}
+	}
+	pthread_setaffinity_np(m_handle.native_handle(), sizeof (cpuSet), &cpuSet);
 #endif
 }
 
@@ -36,6 +36,7 @@ class dgThread
 		dgSemaphore ();
 		~dgSemaphore ();
 		void Wait();
+		void Wait(dgInt32 spinCount);
 		void Release();
 
 		dgInt32 GetCount() const 
@@ -64,7 +65,9 @@ class dgThread
 	virtual void Execute (dgInt32 threadId) = 0;
 	
 	bool IsThreadActive() const;
+	bool IsCallingThread() const;
 	void Wait (dgInt32 count, dgSemaphore* const mutexes);
+	void SetAffinity (dgInt32 firstCpu, dgInt32 cpuCount);
 
 	protected:
 	void Init ();
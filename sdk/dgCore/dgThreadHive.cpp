@@ -30,6 +30,7 @@ dgThreadHive::dgWorkerThread::dgWorkerThread()
 	:dgThread()
 	,m_hive(NULL)
 	,m_allocator(NULL)
+	,m_busyTime(0)
 	,m_isBusy(0)
 	,m_jobsCount(0)
 	,m_workerSemaphore()
@@ -69,7 +70,7 @@ void dgThreadHive::dgWorkerThread::Execute (dgInt32 threadId)
 
 	while (!m_terminate) {
 		dgInterlockedExchange(&m_isBusy, 0);
-		m_workerSemaphore.Wait();
+		m_workerSemaphore.Wait(m_hive->m_spinCount);
 		dgInterlockedExchange(&m_isBusy, 1);
 		if (!m_terminate) {
 			RunNextJobInQueue(threadId);
@@ -92,25 +93,39 @@ dgInt32 dgThreadHive::dgWorkerThread::PushJob(const dgThreadJob& job)
 
 void dgThreadHive::dgWorkerThread::RunNextJobInQueue(dgInt32 threadId)
 {
+	const dgUnsigned64 startTime = dgGetTimeInMicrosenconds();
 	for (dgInt32 i = 0; i < m_jobsCount; i ++) {
 		const dgThreadJob& job = m_jobPool[i];
 		job.m_callback (job.m_context0, job.m_context1, m_id);
 	}
 	m_jobsCount = 0;
+	m_busyTime += dgGetTimeInMicrosenconds() - startTime;
 }
 
 dgThreadHive::dgThreadHive(dgMemoryAllocator* const allocator)
-	:m_parentThread(NULL)
+	:m_sharedHive(NULL)
+	,m_parentThread(NULL)
 	,m_workerThreads(NULL)
 	,m_allocator(allocator)
 	,m_jobsCount(0)
 	,m_workerThreadsCount(0)
+	,m_sharedClientsCount(0)
+	,m_spinCount(DG_THREAD_POOL_SPIN_COUNT)
 	,m_globalCriticalSection(0)
+	,m_sharedSectionFirstWaiter(NULL)
+	,m_sharedSectionLastWaiter(NULL)
+	,m_sharedSectionLock(0)
+	,m_sharedSectionBusy(0)
 {
+	memset (m_affinityFirstCpu, 0, sizeof (m_affinityFirstCpu));
+	memset (m_affinityCpuCount, 0, sizeof (m_affinityCpuCount));
+	strcpy (m_threadsName, "dgWorkerThread");
 }
 
 dgThreadHive::~dgThreadHive()
 {
+	dgAssert (!m_sharedClientsCount);
+	SetSharedThreadHive (NULL);
 	DestroyThreads();
 }
 
@@ -142,14 +157,20 @@ void dgThreadHive::SetThreadsCount (dgInt32 threads)
 
 		for (dgInt32 i = 0; i < m_workerThreadsCount; i ++) {
 			char name[256];
-			sprintf (name, "dgWorkerThread%d", i);
+			sprintf (name, "%s%d", m_threadsName, i);
 			m_workerThreads[i].SetUp(m_allocator, name, i, this);
+			m_workerThreads[i].SetAffinity(m_affinityFirstCpu[i], m_affinityCpuCount[i]);
 		}
 	}
 }
 
 void dgThreadHive::QueueJob (dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, const char* const functionName)
 {
+	if (m_sharedHive) {
+		m_sharedHive->QueueJob (callback, context0, context1, functionName);
+		return;
+	}
+
 	if (!m_workerThreadsCount) {
 		//DG_TRACKTIME(functionName);
 		callback (context0, context1, 0);
@@ -178,14 +199,37 @@ void dgThreadHive::OnEndWorkerThread (dgInt32 threadId)
 {
 }
 
+void dgThreadHive::BeginSection()
+{
+	if (m_sharedHive) {
+		m_sharedHive->LockSharedSection();
+		m_sharedHive->BeginSection();
+	}
+}
+
+void dgThreadHive::EndSection()
+{
+	if (m_sharedHive) {
+		m_sharedHive->EndSection();
+		m_sharedHive->UnlockSharedSection();
+	}
+}
+
 void dgThreadHive::SynchronizationBarrier ()
 {
+	if (m_sharedHive) {
+		m_sharedHive->SynchronizationBarrier();
+		return;
+	}
+
 	if (m_workerThreadsCount) {
 		//DG_TRACKTIME();
 		for (dgInt32 i = 0; i < m_workerThreadsCount; i ++) {
 			m_workerThreads[i].m_workerSemaphore.Release();
 		}
-		m_parentThread->Wait(m_workerThreadsCount, m_beginSectionSemaphores);
+		for (dgInt32 i = 0; i < m_workerThreadsCount; i ++) {
+			m_beginSectionSemaphores[i].Wait(m_spinCount);
+		}
 	}
 	m_jobsCount = 0;
 }
@@ -197,6 +241,7 @@ dgThreadHive::dgWorkerThread::dgWorkerThread()
 	,m_workerSemaphore()
 	,m_hive(NULL)
 	,m_allocator(NULL)
+	,m_busyTime(0)
 	,m_concurrentWork(0)
 	,m_pendingWork(0)
 	,m_jobsCount(0)
@@ -219,10 +264,12 @@ void dgThreadHive::dgWorkerThread::SetUp(dgMemoryAllocator* const allocator, con
 
 void dgThreadHive::dgWorkerThread::RunNextJobInQueue(dgInt32 threadId)
 {
+	const dgUnsigned64 startTime = dgGetTimeInMicrosenconds();
 	for (dgInt32 i = 0; i < m_jobsCount; i++) {
 		const dgThreadJob& job = m_jobPool[i];
 		job.m_callback(job.m_context0, job.m_context1, m_id);
 	}
+	m_busyTime += dgGetTimeInMicrosenconds() - startTime;
 }
 
 dgInt32 dgThreadHive::dgWorkerThread::PushJob(const dgThreadJob& job)
@@ -252,7 +299,7 @@ void dgThreadHive::dgWorkerThread::Execute(dgInt32 threadId)
 	m_hive->OnBeginWorkerThread(threadId);
 
 	while (!m_terminate) {
-		m_workerSemaphore.Wait();
+		m_workerSemaphore.Wait(m_hive->m_spinCount);
 		if (!m_terminate) {
 			m_concurrentWork = 1;
 			m_hive->m_beginSectionSemaphores[threadId].Release();
@@ -265,18 +312,30 @@ void dgThreadHive::dgWorkerThread::Execute(dgInt32 threadId)
 }
 
 dgThreadHive::dgThreadHive(dgMemoryAllocator* const allocator)
-	:m_parentThread(NULL)
+	:m_sharedHive(NULL)
+	,m_parentThread(NULL)
 	,m_workerThreads(NULL)
 	,m_allocator(allocator)
 	,m_syncLock(0)
 	,m_jobsCount(0)
 	,m_workerThreadsCount(0)
+	,m_sharedClientsCount(0)
+	,m_spinCount(DG_THREAD_POOL_SPIN_COUNT)
 	,m_globalCriticalSection(0)
+	,m_sharedSectionFirstWaiter(NULL)
+	,m_sharedSectionLastWaiter(NULL)
+	,m_sharedSectionLock(0)
+	,m_sharedSectionBusy(0)
 {
+	memset (m_affinityFirstCpu, 0, sizeof (m_affinityFirstCpu));
+	memset (m_affinityCpuCount, 0, sizeof (m_affinityCpuCount));
+	strcpy (m_threadsName, "dgWorkerThread");
 }
 
 dgThreadHive::~dgThreadHive()
 {
+	dgAssert (!m_sharedClientsCount);
+	SetSharedThreadHive (NULL);
 	DestroyThreads();
 }
 
@@ -295,28 +354,49 @@ void dgThreadHive::OnEndWorkerThread(dgInt32 threadId)
 
 void dgThreadHive::BeginSection()
 {
+	if (m_sharedHive) {
+		m_sharedHive->LockSharedSection();
+		m_sharedHive->BeginSection();
+		return;
+	}
+
 	if (m_workerThreadsCount) {
 		//DG_TRACKTIME();
 		for (dgInt32 i = 0; i < m_workerThreadsCount; i++) {
 			m_workerThreads[i].m_workerSemaphore.Release();
 		}
-		m_parentThread->Wait(m_workerThreadsCount, m_beginSectionSemaphores);
+		for (dgInt32 i = 0; i < m_workerThreadsCount; i++) {
+			m_beginSectionSemaphores[i].Wait(m_spinCount);
+		}
 	}
 }
 
 void dgThreadHive::EndSection()
 {
+	if (m_sharedHive) {
+		m_sharedHive->EndSection();
+		m_sharedHive->UnlockSharedSection();
+		return;
+	}
+
 	if (m_workerThreadsCount) {
 		//DG_TRACKTIME();
 		for (dgInt32 i = 0; i < m_workerThreadsCount; i++) {
 			dgInterlockedExchange(&m_workerThreads[i].m_concurrentWork, 0);
 		}
-		m_parentThread->Wait(m_workerThreadsCount, m_endSectionSemaphores);
+		for (dgInt32 i = 0; i < m_workerThreadsCount; i++) {
+			m_endSectionSemaphores[i].Wait(m_spinCount);
+		}
 	}
 }
 
 void dgThreadHive::QueueJob(dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, const char* const functionName)
 {
+	if (m_sharedHive) {
+		m_sharedHive->QueueJob(callback, context0, context1, functionName);
+		return;
+	}
+
 	if (!m_workerThreadsCount) {
 		//DG_TRACKTIME(functionName);
 		callback(context0, context1, 0);
@@ -350,14 +430,20 @@ void dgThreadHive::SetThreadsCount(dgInt32 threads)
 
 		for (dgInt32 i = 0; i < m_workerThreadsCount; i++) {
 			char name[256];
-			sprintf(name, "dgWorkerThread%d", i);
+			sprintf(name, "%s%d", m_threadsName, i);
 			m_workerThreads[i].SetUp(m_allocator, name, i, this);
+			m_workerThreads[i].SetAffinity(m_affinityFirstCpu[i], m_affinityCpuCount[i]);
 		}
 	}
 }
 
 void dgThreadHive::SynchronizationBarrier()
 {
+	if (m_sharedHive) {
+		m_sharedHive->SynchronizationBarrier();
+		return;
+	}
+
 	if (m_workerThreadsCount) {
 		//DG_TRACKTIME();
 
@@ -383,4 +469,152 @@ void dgThreadHive::DestroyThreads()
 	}
 }
 
-#endif
\ No newline at end of file
+#endif
+
+
+void dgThreadHive::SetSharedThreadHive (dgThreadHive* const sharedHive)
+{
+	// a hive attached to a shared hive does not own worker threads, 
+	// all of its jobs are executed by the workers of the shared hive
+	dgAssert (sharedHive != this);
+	dgAssert (!sharedHive || !sharedHive->m_sharedHive);
+	if (m_sharedHive) {
+		dgAtomicExchangeAndAdd (&m_sharedHive->m_sharedClientsCount, -1);
+	}
+	m_sharedHive = sharedHive;
+	if (m_sharedHive) {
+		DestroyThreads();
+		dgAtomicExchangeAndAdd (&m_sharedHive->m_sharedClientsCount, 1);
+	}
+}
+
+dgInt32 dgThreadHive::GetSharedClientsCount() const
+{
+	return m_sharedClientsCount;
+}
+
+bool dgThreadHive::IsWorkerThread() const
+{
+	// true when called from inside a job, such a caller can not queue jobs and wait on the barrier
+	if (m_sharedHive) {
+		return m_sharedHive->IsWorkerThread();
+	}
+	for (dgInt32 i = 0; i < m_workerThreadsCount; i ++) {
+		if (m_workerThreads[i].IsCallingThread()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+class dgThreadHive::dgSharedSectionWaiter
+{
+	public:
+	dgSharedSectionWaiter()
+		:m_semaphore()
+		,m_next(NULL)
+	{
+	}
+
+	dgThread::dgSemaphore m_semaphore;
+	dgSharedSectionWaiter* m_next;
+};
+
+void dgThreadHive::LockSharedSection()
+{
+	// the job queues of a hive can only be fed by one client at a time, other clients sleep here 
+	// until the current one ends its section. Clients are served in the order they arrive, 
+	// so a client that updates in a tight loop can not keep the pool from the others
+	dgSharedSectionWaiter waiter;
+	dgSpinLock (&m_sharedSectionLock);
+	if (!m_sharedSectionBusy) {
+		m_sharedSectionBusy = 1;
+		dgSpinUnlock (&m_sharedSectionLock);
+		return;
+	}
+	if (m_sharedSectionLastWaiter) {
+		m_sharedSectionLastWaiter->m_next = &waiter;
+	} else {
+		m_sharedSectionFirstWaiter = &waiter;
+	}
+	m_sharedSectionLastWaiter = &waiter;
+	dgSpinUnlock (&m_sharedSectionLock);
+
+	// the section is handed over by the client that ends it, it is never released in between
+	waiter.m_semaphore.Wait();
+}
+
+void dgThreadHive::UnlockSharedSection()
+{
+	dgSpinLock (&m_sharedSectionLock);
+	dgSharedSectionWaiter* const waiter = m_sharedSectionFirstWaiter;
+	if (waiter) {
+		m_sharedSectionFirstWaiter = waiter->m_next;
+		if (!m_sharedSectionFirstWaiter) {
+			m_sharedSectionLastWaiter = NULL;
+		}
+	} else {
+		m_sharedSectionBusy = 0;
+	}
+	dgSpinUnlock (&m_sharedSectionLock);
+
+	if (waiter) {
+		waiter->m_semaphore.Release();
+	}
+}
+
+dgInt32 dgThreadHive::GetSpinCount() const
+{
+	return m_sharedHive ? m_sharedHive->GetSpinCount() : m_spinCount;
+}
+
+dgUnsigned64 dgThreadHive::GetThreadBusyTime(dgInt32 threadIndex) const
+{
+	// accumulated time in microseconds the worker thread spent running jobs, 
+	// only consistent when read between synchronization barriers
+	if (m_sharedHive) {
+		return m_sharedHive->GetThreadBusyTime(threadIndex);
+	}
+	return ((threadIndex >= 0) && (threadIndex < m_workerThreadsCount)) ? m_workerThreads[threadIndex].m_busyTime : 0;
+}
+
+void dgThreadHive::SetSpinCount (dgInt32 spinCount)
+{
+	// number of pauses a thread spins at a barrier before it blocks on the semaphore
+	if (m_sharedHive) {
+		m_sharedHive->SetSpinCount (spinCount);
+	} else {
+		m_spinCount = dgMax (spinCount, 0);
+	}
+}
+
+void dgThreadHive::SetThreadsName (const char* const name)
+{
+	if (m_sharedHive) {
+		// the workers belong to the shared hive and other clients may be running jobs on them, 
+		// they can only be renamed on the shared hive while holding its shared section
+		dgAssert (0);
+	} else {
+		// leave room for the thread index, the profiler only takes the name when the thread starts
+		// so the worker threads are recreated
+		strncpy (m_threadsName, name, sizeof (m_threadsName) - 3);
+		m_threadsName[sizeof (m_threadsName) - 3] = 0;
+		if (m_workerThreadsCount) {
+			SetThreadsCount (m_workerThreadsCount);
+		}
+	}
+}
+
+void dgThreadHive::SetThreadAffinity (dgInt32 threadIndex, dgInt32 firstCpu, dgInt32 cpuCount)
+{
+	if (m_sharedHive) {
+		// same as the names, the affinity of shared workers can only be changed on the shared hive
+		dgAssert (0);
+	} else if ((threadIndex >= 0) && (threadIndex < DG_MAX_THREADS_HIVE_COUNT)) {
+		m_affinityFirstCpu[threadIndex] = firstCpu;
+		m_affinityCpuCount[threadIndex] = dgMax (cpuCount, 0);
+		if (threadIndex < m_workerThreadsCount) {
+			m_workerThreads[threadIndex].SetAffinity(firstCpu, cpuCount);
+		}
+	}
+}
@@ -28,6 +28,7 @@
 #include "dgFastQueue.h"
 
 #define DG_THREAD_POOL_JOB_SIZE (256)
+#define DG_THREAD_POOL_SPIN_COUNT (1024)
 typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const context1, dgInt32 threadID);
 
 #ifndef WIN32
@@ -76,6 +77,7 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 
 			dgThreadHive* m_hive;
 			dgMemoryAllocator* m_allocator; 
+			dgUnsigned64 m_busyTime;
 			dgInt32 m_isBusy;
 			dgInt32 m_jobsCount;
 			dgSemaphore m_workerSemaphore;
@@ -88,11 +90,18 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 		virtual void OnBeginWorkerThread (dgInt32 threadId);
 		virtual void OnEndWorkerThread (dgInt32 threadId);
 
-		void BeginSection() {}
-		void EndSection() {}
+		void BeginSection();
+		void EndSection();
 
 		void SetParentThread (dgThread* const mastertThread);
 
+		dgThreadHive* GetSharedThreadHive() const;
+		void SetSharedThreadHive (dgThreadHive* const sharedHive);
+		dgInt32 GetSharedClientsCount() const;
+		bool IsWorkerThread() const;
+		void LockSharedSection();
+		void UnlockSharedSection();
+
 		void GlobalLock() const;
 		void GlobalUnlock() const;
 
@@ -103,10 +112,20 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 		dgInt32 GetMaxThreadCount() const;
 		void SetThreadsCount (dgInt32 count);
 
+		dgInt32 GetSpinCount() const;
+		dgUnsigned64 GetThreadBusyTime(dgInt32 threadIndex) const;
+		void SetSpinCount (dgInt32 spinCount);
+		void SetThreadsName (const char* const name);
+		void SetThreadAffinity (dgInt32 threadIndex, dgInt32 firstCpu, dgInt32 cpuCount);
+
 		virtual void QueueJob (dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, const char* const functionName);
 		virtual void SynchronizationBarrier ();
 
+		protected:
+		dgThreadHive* m_sharedHive;
+
 		private:
+		class dgSharedSectionWaiter;
 		void DestroyThreads();
 
 		dgThread* m_parentThread;
@@ -114,15 +133,32 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 		dgMemoryAllocator* m_allocator;
 		dgInt32 m_jobsCount;
 		dgInt32 m_workerThreadsCount;
+		dgInt32 m_sharedClientsCount;
+		dgInt32 m_spinCount;
 		mutable dgInt32 m_globalCriticalSection;
+		dgInt32 m_affinityFirstCpu[DG_MAX_THREADS_HIVE_COUNT];
+		dgInt32 m_affinityCpuCount[DG_MAX_THREADS_HIVE_COUNT];
+		char m_threadsName[16];
+		dgSharedSectionWaiter* m_sharedSectionFirstWaiter;
+		dgSharedSectionWaiter* m_sharedSectionLastWaiter;
+		dgInt32 m_sharedSectionLock;
+		dgInt32 m_sharedSectionBusy;
 		dgThread::dgSemaphore m_beginSectionSemaphores[DG_MAX_THREADS_HIVE_COUNT];
 	};
 
 	DG_INLINE dgInt32 dgThreadHive::GetThreadCount() const
 	{
+		if (m_sharedHive) {
+			return m_sharedHive->GetThreadCount();
+		}
 		return m_workerThreadsCount ? m_workerThreadsCount : 1;
 	}
 
+	DG_INLINE dgThreadHive* dgThreadHive::GetSharedThreadHive() const
+	{
+		return m_sharedHive;
+	}
+
 	DG_INLINE dgInt32 dgThreadHive::GetMaxThreadCount() const
 	{
 		return DG_MAX_THREADS_HIVE_COUNT;
@@ -141,14 +177,14 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 
 	DG_INLINE void dgThreadHive::GetIndirectLock (dgInt32* const criticalSectionLock) const
 	{
-		if (m_workerThreadsCount) {	
+		if (m_workerThreadsCount || m_sharedHive) {	
 			dgSpinLock(criticalSectionLock);
 		}
 	}
 
 	DG_INLINE void dgThreadHive::ReleaseIndirectLock (dgInt32* const criticalSectionLock) const
 	{
-		if (m_workerThreadsCount) {	
+		if (m_workerThreadsCount || m_sharedHive) {	
 			dgSpinUnlock(criticalSectionLock);
 		}
 	}
@@ -200,6 +236,7 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 			dgSemaphore m_workerSemaphore;
 			dgThreadHive* m_hive;
 			dgMemoryAllocator* m_allocator;
+			dgUnsigned64 m_busyTime;
 			dgInt32 m_concurrentWork;
 			dgInt32 m_pendingWork;
 			dgInt32 m_jobsCount;
@@ -218,6 +255,13 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 
 		void SetParentThread(dgThread* const mastertThread);
 
+		dgThreadHive* GetSharedThreadHive() const;
+		void SetSharedThreadHive(dgThreadHive* const sharedHive);
+		dgInt32 GetSharedClientsCount() const;
+		bool IsWorkerThread() const;
+		void LockSharedSection();
+		void UnlockSharedSection();
+
 		void GlobalLock() const;
 		void GlobalUnlock() const;
 
@@ -228,10 +272,20 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 		dgInt32 GetMaxThreadCount() const;
 		void SetThreadsCount(dgInt32 count);
 
+		dgInt32 GetSpinCount() const;
+		dgUnsigned64 GetThreadBusyTime(dgInt32 threadIndex) const;
+		void SetSpinCount(dgInt32 spinCount);
+		void SetThreadsName(const char* const name);
+		void SetThreadAffinity(dgInt32 threadIndex, dgInt32 firstCpu, dgInt32 cpuCount);
+
 		virtual void QueueJob(dgWorkerThreadTaskCallback callback, void* const context0, void* const context1, const char* const functionName);
 		virtual void SynchronizationBarrier();
 
+		protected:
+		dgThreadHive* m_sharedHive;
+
 		private:
+		class dgSharedSectionWaiter;
 		void DestroyThreads();
 
 		dgThread* m_parentThread;
@@ -240,16 +294,33 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 		dgInt32 m_syncLock;
 		dgInt32 m_jobsCount;
 		dgInt32 m_workerThreadsCount;
+		dgInt32 m_sharedClientsCount;
+		dgInt32 m_spinCount;
 		mutable dgInt32 m_globalCriticalSection;
+		dgInt32 m_affinityFirstCpu[DG_MAX_THREADS_HIVE_COUNT];
+		dgInt32 m_affinityCpuCount[DG_MAX_THREADS_HIVE_COUNT];
+		char m_threadsName[16];
+		dgSharedSectionWaiter* m_sharedSectionFirstWaiter;
+		dgSharedSectionWaiter* m_sharedSectionLastWaiter;
+		dgInt32 m_sharedSectionLock;
+		dgInt32 m_sharedSectionBusy;
 		dgThread::dgSemaphore m_endSectionSemaphores[DG_MAX_THREADS_HIVE_COUNT];
 		dgThread::dgSemaphore m_beginSectionSemaphores[DG_MAX_THREADS_HIVE_COUNT];
 	};
 
 	DG_INLINE dgInt32 dgThreadHive::GetThreadCount() const
 	{
+		if (m_sharedHive) {
+			return m_sharedHive->GetThreadCount();
+		}
 		return m_workerThreadsCount ? m_workerThreadsCount : 1;
 	}
 
+	DG_INLINE dgThreadHive* dgThreadHive::GetSharedThreadHive() const
+	{
+		return m_sharedHive;
+	}
+
 	DG_INLINE dgInt32 dgThreadHive::GetMaxThreadCount() const
 	{
 		return DG_MAX_THREADS_HIVE_COUNT;
@@ -267,14 +338,14 @@ typedef void (*dgWorkerThreadTaskCallback) (void* const context0, void* const co
 
 	DG_INLINE void dgThreadHive::GetIndirectLock(dgInt32* const criticalSectionLock) const
 	{
-		if (m_workerThreadsCount) {
+		if (m_workerThreadsCount || m_sharedHive) {
 			dgSpinLock(criticalSectionLock);
 		}
 	}
 
 	DG_INLINE void dgThreadHive::ReleaseIndirectLock(dgInt32* const criticalSectionLock) const
 	{
-		if (m_workerThreadsCount) {
+		if (m_workerThreadsCount || m_sharedHive) {
 			dgSpinUnlock(criticalSectionLock);
 		}
 	}
@@ -605,7 +605,7 @@ DG_INLINE void dgThreadYield()
 DG_INLINE void dgThreadPause()
 {
 #ifndef DG_USE_THREAD_EMULATION
-	#if defined (_WIN_32_VER) || defined (_WIN_64_VER) || defined (WIN32) || defined (i386_) || defined (x86_64_)
+	#if defined (_WIN_32_VER) || defined (_WIN_64_VER) || defined (WIN32) || defined (i386_) || defined (x86_64_) || defined (__i386__) || defined (__x86_64__)
 		_mm_pause();
 	#else 
 		std::this_thread::yield();
@@ -235,6 +235,45 @@ void NewtonSetContactMergeTolerance (const NewtonWorld* const newtonWorld, dFloa
 	world->SetContactMergeTolerance(tolerance);
 }
 
+/*!
+  Get the cost above which a compound contact pair is split across the worker threads.
+
+  @param *newtonWorld is the pointer to the Newton world.
+
+  @return the current split threshold, zero means large compound pairs are never split.
+
+  See also: ::NewtonSetCompoundContactSplitThreshold
+*/
+int NewtonGetCompoundContactSplitThreshold (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	return world->GetCompoundContactSplitThreshold();
+}
+
+/*!
+  Set the cost above which a compound contact pair is split across the worker threads.
+
+  @param *newtonWorld is the pointer to the Newton world.
+  @param threshold estimated number of child pairs (leaf count of one compound times the leaf count of the other, or times 16 against a collision tree).
+
+  @return Nothing.
+
+  Compound vs compound and compound vs collision tree pairs whose estimated cost exceeds this value have their
+  tree traversal split into subtree tasks that all threads process after the regular contact update.
+  Each task collides into its own buffer and the results of a pair are merged in a fixed order, so the contacts
+  do not depend on the thread count. Pairs whose material has a compound collision callback are never split.
+  The default is zero, each pair is processed on a single thread.
+
+  See also: ::NewtonGetCompoundContactSplitThreshold, ::NewtonSetThreadsCount
+*/
+void NewtonSetCompoundContactSplitThreshold (const NewtonWorld* const newtonWorld, int threshold)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *) newtonWorld;
+	world->SetCompoundContactSplitThreshold(threshold);
+}
+
 
 /*!
   Reset all internal engine states.
@@ -314,6 +353,231 @@ void NewtonDeserializeFromFile (const NewtonWorld* const newtonWorld, const char
 	}
 }
 
+/*!
+  Return the number of bytes needed to save a snapshot of the current state of the world.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  @return the snapshot size in bytes.
+
+  The size changes as contacts are created and destroyed, so applications that keep a ring of snapshots
+  should allocate each slot with some slack and check the value returned by ::NewtonWorldSaveSnapshot.
+
+  See also: ::NewtonWorldSaveSnapshot, ::NewtonWorldRestoreSnapshot
+*/
+int NewtonWorldGetSnapshotSize (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetSnapshotSize();
+}
+
+/*!
+  Copy the mutable simulation state of the world into a flat memory buffer.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *buffer memory that receives the snapshot.
+  @param bufferSize size of the buffer in bytes.
+
+  @return the number of bytes written, or zero if the buffer is too small.
+
+  The snapshot holds body matrices, velocities, accelerations, sleep state and broadphase boxes, the contact
+  cache with the accumulated contact impulses used for warm starting and the compound sub shape of each contact point,
+  and the accumulated forces of the bilateral joints. Shapes, materials, mass properties and callbacks are not part of the snapshot, nor is the state that custom joints
+  keep in their own classes.
+
+  The snapshot can only be restored into the same world, with the same bodies and joints.
+  This function must not be called while an asynchronous update is running.
+
+  See also: ::NewtonWorldGetSnapshotSize, ::NewtonWorldRestoreSnapshot
+*/
+int NewtonWorldSaveSnapshot (const NewtonWorld* const newtonWorld, void* const buffer, int bufferSize)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->SaveSnapshot(buffer, bufferSize);
+}
+
+/*!
+  Set the world back to the state saved by ::NewtonWorldSaveSnapshot.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *buffer snapshot memory.
+  @param bufferSize size of the buffer in bytes.
+
+  @return 1 if the snapshot was restored, 0 if it does not match the bodies, joints or compound sub shapes of this world, in which case the world is not modified.
+
+  Bodies and shapes are restored in place and no body is allocated, contacts that do not exist any more are recreated
+  and contacts created after the snapshot was taken are destroyed. The transform callback of every body is called on the next update.
+
+  Replaying the same inputs after a restore reproduces the original simulation bit for bit only when the world runs in
+  deterministic mode, see ::NewtonSetDeterministicMode.
+
+  See also: ::NewtonWorldGetSnapshotSize, ::NewtonWorldSaveSnapshot
+*/
+int NewtonWorldRestoreSnapshot (const NewtonWorld* const newtonWorld, const void* const buffer, int bufferSize)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->RestoreSnapshot(buffer, bufferSize) ? 1 : 0;
+}
+
+/*!
+  Return the size in bytes of the baseline used by ::NewtonWorldEncodeStateDelta.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  @return the baseline size in bytes.
+
+  A baseline records, for each body, the state a receiver last got from the sender.
+  A baseline filled with zeros is empty, and the first delta encoded against it has every body.
+
+  See also: ::NewtonWorldEncodeStateDelta, ::NewtonWorldGetStateDeltaMaxSize
+*/
+int NewtonWorldGetStateBaselineSize (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetStateBaselineSize();
+}
+
+/*!
+  Return the largest size in bytes that ::NewtonWorldEncodeStateDelta can write, which is when every body is sent.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  @return the size in bytes.
+
+  See also: ::NewtonWorldEncodeStateDelta
+*/
+int NewtonWorldGetStateDeltaMaxSize (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetStateDeltaMaxSize();
+}
+
+/*!
+  Write a compact binary delta of the body transforms and velocities that changed since a baseline.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *params quantization steps and change tolerances.
+  @param *baseline baseline memory of at least ::NewtonWorldGetStateBaselineSize bytes, it is updated with the bodies written to the delta.
+  @param baselineSize size of the baseline in bytes.
+  @param *delta memory of at least ::NewtonWorldGetStateDeltaMaxSize bytes that receives the delta.
+  @param deltaSize size of the delta buffer in bytes.
+
+  @return the number of bytes written to the delta, or zero if one of the buffers is too small.
+
+  Each body in the delta takes 33 bytes: its unique ID, a quantized position, the rotation in smallest three form with
+  ten bits per component, quantized linear and angular velocities, and a sleep flag. Only bodies that moved, turned or changed
+  velocity beyond the tolerances are written. A body that falls asleep is written once with zero velocity and the sleep flag,
+  and is then omitted for as long as it stays asleep and does not move.
+
+  The baseline holds the values as the receiver decodes them, so quantization errors do not accumulate. Keep one baseline per receiver.
+  On an unreliable channel, copy the baseline before encoding and go back to the copy if the receiver does not acknowledge the delta.
+  A baseline made for other precisions or for a different number of bodies is reset, and all bodies are sent.
+
+  See also: ::NewtonWorldApplyStateDelta, ::NewtonWorldGetStateBaselineSize
+*/
+int NewtonWorldEncodeStateDelta (const NewtonWorld* const newtonWorld, const NewtonStateDeltaParams* const params, void* const baseline, int baselineSize, void* const delta, int deltaSize)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	dgWorldStateDeltaParams deltaParams;
+	deltaParams.m_positionPrecision = params->m_positionPrecision;
+	deltaParams.m_velocityPrecision = params->m_velocityPrecision;
+	deltaParams.m_positionTolerance = params->m_positionTolerance;
+	deltaParams.m_rotationTolerance = params->m_rotationTolerance;
+	deltaParams.m_velocityTolerance = params->m_velocityTolerance;
+	return world->EncodeStateDelta(deltaParams, baseline, baselineSize, delta, deltaSize);
+}
+
+/*!
+  Update the bodies of a world with a delta written by ::NewtonWorldEncodeStateDelta.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *delta delta memory.
+  @param deltaSize size of the delta in bytes.
+
+  @return the number of bodies updated, or -1 if the buffer is not a valid delta.
+
+  Bodies are matched by unique ID, so the receiving world must create its bodies in the same order as the sender.
+  Records for bodies that do not exist in this world are ignored. Updated bodies are woken up, unless the delta says they are asleep.
+
+  See also: ::NewtonWorldEncodeStateDelta
+*/
+int NewtonWorldApplyStateDelta (const NewtonWorld* const newtonWorld, const void* const delta, int deltaSize)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->ApplyStateDelta(delta, deltaSize);
+}
+
+static void dgBodyStateArraysFromNewton (dgBodyStateArrays& dst, const NewtonBodyStateArrays* const src)
+{
+	dst.m_posit = (dgFloat32*) src->m_position;
+	dst.m_rotation = (dgFloat32*) src->m_rotation;
+	dst.m_veloc = (dgFloat32*) src->m_veloc;
+	dst.m_omega = (dgFloat32*) src->m_omega;
+	dst.m_sleeping = (dgInt32*) src->m_sleeping;
+	dst.m_positStride = src->m_positionStride;
+	dst.m_rotationStride = src->m_rotationStride;
+	dst.m_velocStride = src->m_velocStride;
+	dst.m_omegaStride = src->m_omegaStride;
+	dst.m_sleepingStride = src->m_sleepingStride;
+}
+
+/*!
+  Copy the state of many bodies to caller arrays in one call.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *bodies array of bodies to read, or NULL for all bodies of the world.
+  @param count number of entries in the bodies array, ignored when bodies is NULL.
+  @param *arrays destination arrays, see ::NewtonBodyStateArrays.
+
+  @return the number of bodies written.
+
+  Entry i of each array receives the state of bodies[i]. When bodies is NULL the entries follow
+  the order of ::NewtonWorldGetFirstBody and ::NewtonWorldGetNextBody, and the arrays must hold ::NewtonWorldGetBodyCount entries.
+  The work is split across the worker threads of the world, this function can not be called from inside an update.
+
+  See also: ::NewtonWorldSetBodyStates
+*/
+int NewtonWorldGetBodyStates (const NewtonWorld* const newtonWorld, const NewtonBody* const* const bodies, int count, const NewtonBodyStateArrays* const arrays)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	dgBodyStateArrays bodyArrays;
+	dgBodyStateArraysFromNewton (bodyArrays, arrays);
+	return world->GetBodyStates ((dgBody* const*) bodies, count, bodyArrays);
+}
+
+/*!
+  Set the state of many bodies from caller arrays in one call.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *bodies array of bodies to write, or NULL for all bodies of the world.
+  @param count number of entries in the bodies array, ignored when bodies is NULL.
+  @param *arrays source arrays, see ::NewtonBodyStateArrays.
+
+  @return the number of bodies updated.
+
+  Only the fields with a non NULL array are changed. When only one of position or rotation is given the other keeps its current value.
+  Moved bodies are woken up, like ::NewtonBodySetMatrix, unless a sleeping array puts them back to sleep.
+  The work is split across the worker threads of the world, this function can not be called from inside an update.
+
+  See also: ::NewtonWorldGetBodyStates
+*/
+int NewtonWorldSetBodyStates (const NewtonWorld* const newtonWorld, const NewtonBody* const* const bodies, int count, const NewtonBodyStateArrays* const arrays)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	dgBodyStateArrays bodyArrays;
+	dgBodyStateArraysFromNewton (bodyArrays, arrays);
+	return world->SetBodyStates ((dgBody* const*) bodies, count, bodyArrays);
+}
+
 NewtonBody* NewtonFindSerializedBody(const NewtonWorld* const newtonWorld, int bodySerializedID)
 {
 	TRACE_FUNCTION(__FUNCTION__);
@@ -530,6 +794,89 @@ int NewtonGetMaxThreadsCount(const NewtonWorld* const newtonWorld)
 }
 
 
+/*!
+  Set the number of pause instructions a thread spins at a synchronization point before it blocks.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param spinCount number of spins, zero blocks immediately.
+
+  @return Nothing
+
+  Spinning keeps the worker threads hot between the many short parallel phases of an update
+  at the cost of burning cpu cycles, applications sharing the cpu with other heavy threads
+  may want to lower this value.
+
+  See also: ::NewtonGetThreadsSpinCount, ::NewtonSetThreadsCount
+*/
+void NewtonSetThreadsSpinCount (const NewtonWorld* const newtonWorld, int spinCount)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->SetSpinCount(spinCount);
+}
+
+/*!
+  Return the number of pause instructions a thread spins at a synchronization point before it blocks.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  @return spin count
+
+  See also: ::NewtonSetThreadsSpinCount
+*/
+int NewtonGetThreadsSpinCount (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetSpinCount();
+}
+
+/*!
+  Set the name prefix of the engine worker threads.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *name name prefix, the thread index is appended to it.
+
+  @return Nothing
+
+  The names show up in debuggers and profilers. The worker threads are recreated.
+  The call is ignored on a world attached to a shared thread pool, the pool threads 
+  are named with ::NewtonThreadPoolSetThreadsName.
+
+  See also: ::NewtonSetThreadsCount
+*/
+void NewtonSetThreadsName (const NewtonWorld* const newtonWorld, const char* const name)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->SetThreadsName(name);
+}
+
+/*!
+  Bind an engine worker thread to a range of logical cpus.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param threadIndex index of the worker thread.
+  @param firstCpu first logical cpu of the range.
+  @param cpuCount number of logical cpus in the range, zero lets the thread run on any cpu.
+
+  @return Nothing
+
+  The setting is kept when the thread count changes. To bind workers to a NUMA node pass the
+  cpu range of that node. Only supported on windows and linux.
+  The call is ignored on a world attached to a shared thread pool, the pool threads 
+  are bound with ::NewtonThreadPoolSetThreadAffinity.
+
+  See also: ::NewtonSetThreadsCount
+*/
+void NewtonSetThreadAffinity (const NewtonWorld* const newtonWorld, int threadIndex, int firstCpu, int cpuCount)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->SetThreadAffinity(threadIndex, firstCpu, cpuCount);
+}
+
+
 /*!
   Enable/disable multi-threaded constraint resolution for large islands
   (disabled by default).
@@ -578,6 +925,205 @@ void NewtonSyncThreadJobs(const NewtonWorld* const newtonWorld)
 	world->SynchronizationBarrier();
 }
 
+/*!
+  Create a pool of worker threads that can be shared by several worlds.
+
+  @param threads number of worker threads owned by the pool.
+
+  @return a pointer to the thread pool.
+
+  Processes hosting many worlds should create one pool with as many threads as there are cores,
+  and attach every world to it with ::NewtonSetThreadPool, instead of giving each world its own threads.
+
+  See also: ::NewtonDestroyThreadPool, ::NewtonSetThreadPool, ::NewtonThreadPoolUpdate
+*/
+NewtonThreadPool* NewtonCreateThreadPool (int threads)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgMemoryAllocator* const allocator = new dgMemoryAllocator();
+	return (NewtonThreadPool*) new (allocator) dgWorldSharedThreadPool (allocator, threads);
+}
+
+/*!
+  Destroy a shared thread pool.
+
+  @param *threadPool pointer to the thread pool.
+
+  @return 1 if the pool was destroyed, 0 if worlds are still attached to it.
+
+  All worlds attached to the pool must be destroyed or detached before the pool is destroyed, 
+  the call is refused and the pool is left untouched while any world still uses it.
+
+  See also: ::NewtonCreateThreadPool, ::NewtonSetThreadPool
+*/
+int NewtonDestroyThreadPool (const NewtonThreadPool* const threadPool)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgWorldSharedThreadPool* const pool = (dgWorldSharedThreadPool*) threadPool;
+	if (pool->GetSharedClientsCount()) {
+		return 0;
+	}
+	dgMemoryAllocator* const allocator = pool->GetAllocator();
+
+	delete pool;
+	delete allocator;
+	return 1;
+}
+
+/*!
+  Return the number of worker threads of a shared thread pool.
+
+  @param *threadPool pointer to the thread pool.
+
+  @return Number threads.
+
+  See also: ::NewtonCreateThreadPool
+*/
+int NewtonThreadPoolGetThreadsCount (const NewtonThreadPool* const threadPool)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgWorldSharedThreadPool* const pool = (dgWorldSharedThreadPool*) threadPool;
+	return pool->GetThreadCount();
+}
+
+/*!
+  Set the name prefix of the worker threads of a shared thread pool.
+
+  @param *threadPool pointer to the thread pool.
+  @param *name name prefix, the thread index is appended to it.
+
+  @return Nothing
+
+  The worker threads are recreated, the call waits until no world attached to the pool is updating.
+  It must not be called from inside an update of a world attached to the pool.
+
+  See also: ::NewtonSetThreadsName, ::NewtonCreateThreadPool
+*/
+void NewtonThreadPoolSetThreadsName (const NewtonThreadPool* const threadPool, const char* const name)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgWorldSharedThreadPool* const pool = (dgWorldSharedThreadPool*) threadPool;
+	pool->SetWorkersName (name);
+}
+
+/*!
+  Bind a worker thread of a shared thread pool to a range of logical cpus.
+
+  @param *threadPool pointer to the thread pool.
+  @param threadIndex index of the worker thread.
+  @param firstCpu first logical cpu of the range.
+  @param cpuCount number of logical cpus in the range, zero lets the thread run on any cpu.
+
+  @return Nothing
+
+  The call waits until no world attached to the pool is updating.
+  It must not be called from inside an update of a world attached to the pool.
+
+  See also: ::NewtonSetThreadAffinity, ::NewtonCreateThreadPool
+*/
+void NewtonThreadPoolSetThreadAffinity (const NewtonThreadPool* const threadPool, int threadIndex, int firstCpu, int cpuCount)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgWorldSharedThreadPool* const pool = (dgWorldSharedThreadPool*) threadPool;
+	pool->SetWorkerAffinity (threadIndex, firstCpu, cpuCount);
+}
+
+/*!
+  Advance a batch of worlds by the same amount of time on the workers of a shared thread pool.
+
+  @param *threadPool pointer to the thread pool.
+  @param **newtonWorlds array of worlds to update.
+  @param worldCount number of worlds in the array.
+  @param timestep time step in seconds.
+
+  @return Nothing
+
+  Each world of the batch is stepped in full by a single worker, so the workers run as many worlds 
+  in parallel as the pool has threads. Worlds with higher priority are dispatched first.
+  This is much cheaper than calling ::NewtonUpdate on each world when the worlds are small.
+  The function returns after all worlds of the batch finished their update.
+
+  See also: ::NewtonSetThreadPoolPriority, ::NewtonUpdate
+*/
+void NewtonThreadPoolUpdate (const NewtonThreadPool* const threadPool, const NewtonWorld** const newtonWorlds, int worldCount, dFloat timestep)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgWorldSharedThreadPool* const pool = (dgWorldSharedThreadPool*) threadPool;
+	pool->Update ((dgWorld**) newtonWorlds, worldCount, timestep);
+}
+
+/*!
+  Attach a world to a shared thread pool.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *threadPool pointer to the thread pool, NULL detaches the world.
+
+  @return Nothing
+
+  The world releases its own worker threads and runs its jobs on the workers of the pool. 
+  While a world holds the pool during ::NewtonUpdate, the updates of the other worlds that share it wait for their turn, 
+  turns are taken in the order the worlds asked for the pool.
+  A detached world runs single threaded until ::NewtonSetThreadsCount is called.
+  Calling ::NewtonSetThreadsCount detaches the world from the pool.
+
+  See also: ::NewtonCreateThreadPool, ::NewtonGetThreadPool
+*/
+void NewtonSetThreadPool (const NewtonWorld* const newtonWorld, const NewtonThreadPool* const threadPool)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->SetSharedThreadPool ((dgWorldSharedThreadPool*) threadPool);
+}
+
+/*!
+  Return the shared thread pool a world is attached to.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  @return pointer to the thread pool, NULL if the world own its threads.
+
+  See also: ::NewtonSetThreadPool
+*/
+NewtonThreadPool* NewtonGetThreadPool (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return (NewtonThreadPool*) world->GetSharedThreadPool();
+}
+
+/*!
+  Set the priority of a world in the batch updates of a shared thread pool.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param priority worlds with higher values are dispatched first, default is 0.
+
+  @return Nothing
+
+  See also: ::NewtonThreadPoolUpdate, ::NewtonGetThreadPoolPriority
+*/
+void NewtonSetThreadPoolPriority (const NewtonWorld* const newtonWorld, int priority)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->SetThreadPoolPriority (priority);
+}
+
+/*!
+  Return the priority of a world in the batch updates of a shared thread pool.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  @return the world priority.
+
+  See also: ::NewtonSetThreadPoolPriority
+*/
+int NewtonGetThreadPoolPriority (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetThreadPoolPriority ();
+}
+
 int NewtonGetParallelSolverOnLargeIsland(const NewtonWorld* const newtonWorld)
 {
 	TRACE_FUNCTION(__FUNCTION__);
@@ -585,6 +1131,132 @@ int NewtonGetParallelSolverOnLargeIsland(const NewtonWorld* const newtonWorld)
 	return world->GetParallelSolverOnLargeIsland();
 }
 
+/*!
+  Enable/disable results that do not depend on the number of threads.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param mode 1: enabled  0: disabled (default)
+
+  @return Nothing
+
+  In deterministic mode the new contacts found each step are sorted by the unique id of their bodies,
+  islands are sorted serially and bodies woken by contact changes are updated after all contacts, so that
+  contact lists, islands and joint orders are the same for any thread count. Large islands are not split
+  across threads by the parallel solver, and large compound pairs are not split either. Two worlds built in the same order and
+  stepped with the same time steps then produce bit identical results regardless of ::NewtonSetThreadsCount,
+  as required by lock step networking and replays. Broadphase leaf boxes are not reset when the tree is rebuilt,
+  so a world restored with ::NewtonWorldRestoreSnapshot replays the same steps bit for bit.
+
+  The application must still call ::NewtonInvalidateCache after building or deserializing a world.
+  These costs are only paid when the mode is enabled.
+
+  See also: ::NewtonGetDeterministicMode, ::NewtonSetParallelSolverOnLargeIsland, ::NewtonInvalidateCache, ::NewtonWorldSaveSnapshot
+*/
+void NewtonSetDeterministicMode (const NewtonWorld* const newtonWorld, int mode)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->SetDeterministicMode (mode);
+}
+
+/*!
+  Return the deterministic mode state.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  @return 1 if the mode is enabled, 0 otherwise.
+
+  See also: ::NewtonSetDeterministicMode
+*/
+int NewtonGetDeterministicMode (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetDeterministicMode ();
+}
+
+/*!
+  Enable or disable the published state of the bodies.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param mode 1 to enable, 0 to disable.
+
+  @return Nothing
+
+  While the mode is enabled every update also copies the position, rotation, velocities and sleep state
+  of all bodies into one of two buffers, and makes it the current one once the step is complete.
+  Other threads can then read the last complete step with ::NewtonBodyGetPublishedMatrix and ::NewtonWorldGetPublishedBodyStates
+  while ::NewtonUpdateAsync runs the next one, without waiting for ::NewtonWaitForUpdateToFinish.
+  Readers never block the update, a read that overlaps the publication of two new steps is simply retried.
+
+  See also: ::NewtonGetPublishedStateMode, ::NewtonWorldGetPublishedFrame
+*/
+void NewtonSetPublishedStateMode (const NewtonWorld* const newtonWorld, int mode)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	world->SetPublishedStateMode (mode);
+}
+
+/*!
+  Return the published state mode.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  @return 1 if the mode is enabled, 0 otherwise.
+
+  See also: ::NewtonSetPublishedStateMode
+*/
+int NewtonGetPublishedStateMode (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetPublishedStateMode ();
+}
+
+/*!
+  Return the number of the last published step.
+
+  @param *newtonWorld Pointer to the Newton world.
+
+  @return the number of steps published since the mode was enabled, 0 if none yet.
+
+  A reader can compare this value between frames to know whether a new step is available.
+  Can be called from any thread.
+
+  See also: ::NewtonSetPublishedStateMode
+*/
+int NewtonWorldGetPublishedFrame (const NewtonWorld* const newtonWorld)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	return world->GetPublishedFrame ();
+}
+
+/*!
+  Copy the published state of many bodies to caller arrays.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *bodies array of bodies to read.
+  @param count number of entries in the bodies array.
+  @param *arrays destination arrays, see ::NewtonBodyStateArrays.
+
+  @return the number of bodies found in the published state.
+
+  All entries come from the same step. Entries of bodies created after the last published step are left untouched.
+  Can be called from any thread, including while an asynchronous update is running.
+
+  See also: ::NewtonSetPublishedStateMode, ::NewtonWorldGetBodyStates
+*/
+int NewtonWorldGetPublishedBodyStates (const NewtonWorld* const newtonWorld, const NewtonBody* const* const bodies, int count, const NewtonBodyStateArrays* const arrays)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	dgBodyStateArrays bodyArrays;
+	dgBodyStateArraysFromNewton (bodyArrays, arrays);
+	return world->GetPublishedBodyStates ((const dgBody* const*) bodies, count, bodyArrays);
+}
+
 /*!
   Set the solver precision mode.
 
@@ -665,6 +1337,49 @@ dFloat NewtonGetLastUpdateTime (const NewtonWorld* const newtonWorld)
 	return world->GetUpdateTime();
 }
 
+/*!
+  Get the timings and counters of the last world update.
+
+  @param *newtonWorld Pointer to the Newton world.
+  @param *stats pointer to the record to be filled.
+
+  @return Nothing
+
+  The phase times are in seconds and add up all sub steps of the update, the counters are taken from the last sub step.
+  The values are always collected and are only consistent when read outside of the update.
+
+  See also: ::NewtonGetLastUpdateTime
+*/
+void NewtonWorldGetStats (const NewtonWorld* const newtonWorld, NewtonWorldStats* const stats)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	Newton* const world = (Newton *)newtonWorld;
+	const dgWorldStats& worldStats = world->GetStats();
+
+	stats->m_updateTime = worldStats.m_updateTime;
+	stats->m_forceAndTorqueTime = worldStats.m_forceAndTorqueTime;
+	stats->m_broadPhaseTime = worldStats.m_broadPhaseTime;
+	stats->m_narrowPhaseTime = worldStats.m_narrowPhaseTime;
+	stats->m_islandBuildTime = worldStats.m_islandBuildTime;
+	stats->m_solverTime = worldStats.m_solverTime;
+	stats->m_integrationTime = worldStats.m_integrationTime;
+	stats->m_transformTime = worldStats.m_transformTime;
+
+	dgAssert (DG_MAX_THREADS_HIVE_COUNT <= NEWTON_MAX_THREADS_COUNT);
+	stats->m_threadsCount = worldStats.m_threadsCount;
+	for (dgInt32 i = 0; i < NEWTON_MAX_THREADS_COUNT; i ++) {
+		const bool valid = (i < worldStats.m_threadsCount);
+		stats->m_threadBusyTime[i] = valid ? worldStats.m_threadBusyTime[i] : dFloat (0.0f);
+		stats->m_threadIdleTime[i] = valid ? worldStats.m_threadIdleTime[i] : dFloat (0.0f);
+	}
+
+	stats->m_pairsCount = worldStats.m_pairsCount;
+	stats->m_contactsCount = worldStats.m_contactsCount;
+	stats->m_activeBodiesCount = worldStats.m_activeBodiesCount;
+	stats->m_islandsCount = worldStats.m_islandsCount;
+	stats->m_solverRowsCount = worldStats.m_solverRowsCount;
+}
+
 
 void NewtonSetNumberOfSubsteps (const NewtonWorld* const newtonWorld, int subSteps)
 {
@@ -2541,6 +3256,42 @@ void NewtonCompoundCollisionEndAddRemove (NewtonCollision* const compoundCollisi
 	}
 }
 
+/*!
+  Select how ::NewtonCompoundCollisionEndAddRemove updates the compound internal tree.
+
+  @param *compoundCollision is the pointer to the compound collision.
+  @param mode 0 rebuilds and optimizes the tree on every update (default), 1 only refits the boxes touched since the last update.
+
+  @return Nothing.
+
+  Refit mode is meant for compounds whose sub shapes are moved every frame by ::NewtonCompoundCollisionSetSubCollisionMatrix.
+  The tree is still rebuilt when sub shapes were added or removed, when the tree cost grows by more than half its value
+  at the last rebuild, or when refit mode is used before the first ::NewtonCompoundCollisionEndAddRemove.
+  Refit updates still recalculate the compound mass properties and flush the world contact cache.
+
+  See also: ::NewtonCompoundCollisionGetRefitMode, ::NewtonCompoundCollisionEndAddRemove
+*/
+void NewtonCompoundCollisionSetRefitMode (NewtonCollision* const compoundCollision, int mode)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgCollisionInstance* const instance = (dgCollisionInstance*) compoundCollision;
+	if (instance->IsType (dgCollision::dgCollisionCompound_RTTI)) {
+		dgCollisionCompound* const collision = (dgCollisionCompound*) instance->GetChildShape();
+		collision->SetRefitMode(mode ? true : false);
+	}
+}
+
+int NewtonCompoundCollisionGetRefitMode (const NewtonCollision* const compoundCollision)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	const dgCollisionInstance* const instance = (dgCollisionInstance*) compoundCollision;
+	if (instance->IsType (dgCollision::dgCollisionCompound_RTTI)) {
+		const dgCollisionCompound* const collision = (dgCollisionCompound*) instance->GetChildShape();
+		return collision->GetRefitMode() ? 1 : 0;
+	}
+	return 0;
+}
+
 
 void* NewtonCompoundCollisionGetFirstNode (NewtonCollision* const compoundCollision)
 {
@@ -4910,6 +5661,32 @@ void NewtonBodyGetMatrix(const NewtonBody* const bodyPtr, dFloat* const matrixPt
 	memcpy (matrixPtr, &matrix[0][0], sizeof (dgMatrix));
 }
 
+/*!
+  Get the transformation matrix of a rigid body from the last published step.
+
+  @param *bodyPtr pointer to the body.
+  @param *matrixPtr pointer to an array of 16 floats that will hold the global matrix of the rigid body.
+
+  @return 1 if the body is part of the published state, 0 otherwise.
+
+  Unlike ::NewtonBodyGetMatrix this can be called from any thread while an asynchronous update is running.
+
+  See also: ::NewtonSetPublishedStateMode, ::NewtonBodyGetMatrix
+*/
+int NewtonBodyGetPublishedMatrix(const NewtonBody* const bodyPtr, dFloat* const matrixPtr)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgBody* const body = (dgBody *)bodyPtr;
+	dgPublishedBodyState state;
+	if (!body->GetWorld()->GetPublishedBodyState (body, state)) {
+		return 0;
+	}
+	const dgQuaternion rotation (state.m_rotation[3], state.m_rotation[0], state.m_rotation[1], state.m_rotation[2]);
+	const dgMatrix matrix (rotation, dgVector (state.m_posit[0], state.m_posit[1], state.m_posit[2], dgFloat32 (1.0f)));
+	memcpy (matrixPtr, &matrix[0][0], sizeof (dgMatrix));
+	return 1;
+}
+
 void NewtonBodyGetPosition(const NewtonBody* const bodyPtr, dFloat* const posPtr)
 {
 	TRACE_FUNCTION(__FUNCTION__);
@@ -5329,6 +6106,16 @@ void NewtonInverseDynamicsUpdate (NewtonInverseDynamics* const inverseDynamics,
 	ik->Update(timestep, threadIndex);
 }
 
+// solves many inverse dynamics models that share the same topology across the world thread pool,
+// must be called from the main thread and the models must not share bodies.
+// Each model is solved whole by one thread with the same code as NewtonInverseDynamicsUpdate, 
+// models are not packed into SIMD lanes and do not share their mass matrix factorization.
+void NewtonInverseDynamicsUpdateBatch (NewtonInverseDynamics** const inverseDynamicsArray, int count, dFloat timestep)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgInverseDynamics::UpdateBatch((dgInverseDynamics**)inverseDynamicsArray, count, timestep);
+}
+
 void* NewtonInverseDynamicsGetRoot(NewtonInverseDynamics* const inverseDynamics)
 {
 	TRACE_FUNCTION(__FUNCTION__);
@@ -5686,6 +6473,10 @@ int NewtonBodyGetMaterialGroupID(const NewtonBody* const bodyPtr)
 
   for continuous collision to be active the continuous collision mode must on the material pair of the colliding bodies as well as on at least one of the two colliding bodies.
 
+  after the solver, a body that moved more than a fraction of its size is swept from its start of step pose and stopped at its earliest time of impact.
+  The other dynamic bodies are swept from their start of step position, kinematic bodies from their current pose. The sweep is linear,
+  rotations are not rewound, and bodies with bilateral joints are not clamped.
+
   Because there is penalty of about 40% to 80% depending of the shape complexity of the collision geometry, this feature is set
   off by default. It is the job of the application to determine what bodies need this feature on. Good guidelines are: very small objects,
   and bodies that move a height speed.
@@ -5895,6 +6686,56 @@ void NewtonBodySetSleepState(const NewtonBody* const bodyPtr, int state)
 	body->SetSleepState(state ? true : false);
 }
 
+/*!
+  Return the skeleton level of detail set on this body.
+
+  @param *bodyPtr is the pointer to the body.
+
+  @return skeleton lod, one of the NEWTON_SKELETON_LOD_ values.
+
+  See also: ::NewtonBodySetSkeletonLod
+*/
+int NewtonBodyGetSkeletonLod(const NewtonBody* const bodyPtr)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgBody* const body = (dgBody *)bodyPtr;
+	return body->IsRTTIType(dgBody::m_dynamicBodyRTTI) ? ((dgDynamicBody*)body)->GetSkeletonLod() : NEWTON_SKELETON_LOD_FULL;
+}
+
+/*!
+  Set the level of detail of the skeleton this body belongs to.
+
+  @param *bodyPtr is the pointer to any body of the skeleton.
+  @param lod is one of the NEWTON_SKELETON_LOD_ values.
+
+  A skeleton runs at the highest level set on any of its bodies, so the application
+  can set the level on a single bone, the root for example.
+  NEWTON_SKELETON_LOD_FULL solves the tree and the joint limits and loops exactly.
+  NEWTON_SKELETON_LOD_REDUCED solves the tree exactly and leaves limits and loops to the iterative solver.
+  NEWTON_SKELETON_LOD_ITERATIVE skips the exact solve, the joints behave like regular joints. 
+  This is the level to use for far skeletons the application drives from animation.
+  NEWTON_SKELETON_LOD_SLEEP puts all the bodies of the skeleton to sleep each step, 
+  lowering the level again wakes them up.
+
+  See also: ::NewtonBodyGetSkeletonLod
+*/
+void NewtonBodySetSkeletonLod(const NewtonBody* const bodyPtr, int lod)
+{
+	TRACE_FUNCTION(__FUNCTION__);
+	dgBody* const body = (dgBody *)bodyPtr;
+	if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
+		dgDynamicBody* const dynamicBody = (dgDynamicBody*)body;
+		const dgInt32 oldLod = dynamicBody->GetSkeletonLod();
+		lod = dgClamp(lod, NEWTON_SKELETON_LOD_FULL, NEWTON_SKELETON_LOD_SLEEP);
+		dynamicBody->SetSkeletonLod(lod);
+
+		dgSkeletonContainer* const skeleton = dynamicBody->GetSkeleton();
+		if (skeleton && (oldLod == NEWTON_SKELETON_LOD_SLEEP) && (lod != NEWTON_SKELETON_LOD_SLEEP)) {
+			skeleton->SetSleepState(false);
+		}
+	}
+}
+
 
 /*!
   Get the world axis aligned bounding box (AABB) of the body.
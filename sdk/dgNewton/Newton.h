@@ -95,10 +95,18 @@ extern "C" {
 	#define SERIALIZE_ID_SCENE								14
 	#define SERIALIZE_ID_FRACTURED_COMPOUND					15
 
+	#define NEWTON_MAX_THREADS_COUNT						16
+
+	#define NEWTON_SKELETON_LOD_FULL						0
+	#define NEWTON_SKELETON_LOD_REDUCED						1
+	#define NEWTON_SKELETON_LOD_ITERATIVE					2
+	#define NEWTON_SKELETON_LOD_SLEEP						3
+
 #ifdef __cplusplus
 	class NewtonMesh;
 	class NewtonBody;
 	class NewtonWorld;
+	class NewtonThreadPool;
 	class NewtonJoint;
 	class NewtonMaterial;
 	class NewtonCollision;
@@ -109,6 +117,7 @@ extern "C" {
 	typedef struct NewtonMesh{} NewtonMesh;
 	typedef struct NewtonBody{} NewtonBody;
 	typedef struct NewtonWorld{} NewtonWorld;
+	typedef struct NewtonThreadPool{} NewtonThreadPool;
 	typedef struct NewtonJoint{} NewtonJoint;
 	typedef struct NewtonMaterial{} NewtonMaterial;
 	typedef struct NewtonCollision{} NewtonCollision;
@@ -252,6 +261,49 @@ extern "C" {
 		char m_descriptionType[128];
 	} NewtonJointRecord;
 
+	typedef struct NewtonWorldStats
+	{
+		dFloat m_updateTime;						// time in seconds of the last update, same as NewtonGetLastUpdateTime
+		dFloat m_forceAndTorqueTime;				// force and torque callbacks and pre update listeners
+		dFloat m_broadPhaseTime;					// sleep states, broad phase tree update and pair finding
+		dFloat m_narrowPhaseTime;					// contact generation
+		dFloat m_islandBuildTime;					// skeletons and island build
+		dFloat m_solverTime;						// joint solver including the rigid body velocity integration
+		dFloat m_integrationTime;					// soft bodies and continuous collision
+		dFloat m_transformTime;						// transform callbacks and post update listeners
+		dFloat m_threadBusyTime[NEWTON_MAX_THREADS_COUNT];	// time each worker thread spent running jobs
+		dFloat m_threadIdleTime[NEWTON_MAX_THREADS_COUNT];	// time each worker thread spent waiting
+		int m_threadsCount;							// number of valid entries in the thread arrays
+		int m_pairsCount;							// broad phase pairs
+		int m_contactsCount;						// pairs with contact points
+		int m_activeBodiesCount;					// bodies in awake islands
+		int m_islandsCount;							// awake islands
+		int m_solverRowsCount;						// constraint rows sent to the solver
+	} NewtonWorldStats;
+
+	typedef struct NewtonStateDeltaParams
+	{
+		dFloat m_positionPrecision;					// quantization step of positions
+		dFloat m_velocityPrecision;					// quantization step of linear and angular velocities
+		dFloat m_positionTolerance;					// a body is sent when it moved more than this distance,
+		dFloat m_rotationTolerance;					// or turned more than this angle in radians,
+		dFloat m_velocityTolerance;					// or a velocity component changed more than this
+	} NewtonStateDeltaParams;
+
+	typedef struct NewtonBodyStateArrays
+	{
+		dFloat* m_position;							// 3 floats per body, NULL to skip
+		dFloat* m_rotation;							// 4 floats per body in the order of NewtonBodyGetRotation, NULL to skip
+		dFloat* m_veloc;							// 3 floats per body, NULL to skip
+		dFloat* m_omega;							// 3 floats per body, NULL to skip
+		int* m_sleeping;							// 1 int per body, NULL to skip
+		int m_positionStride;						// byte distance between consecutive entries, zero for tightly packed
+		int m_rotationStride;
+		int m_velocStride;
+		int m_omegaStride;
+		int m_sleepingStride;
+	} NewtonBodyStateArrays;
+
 	typedef struct NewtonUserMeshCollisionCollideDesc
 	{
 		dFloat m_boxP0[4];							// lower bounding box of intersection query in local space
@@ -478,6 +530,9 @@ extern "C" {
 	NEWTON_API dFloat NewtonGetContactMergeTolerance (const NewtonWorld* const newtonWorld);
 	NEWTON_API void NewtonSetContactMergeTolerance (const NewtonWorld* const newtonWorld, dFloat tolerance);
 
+	NEWTON_API int NewtonGetCompoundContactSplitThreshold (const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonSetCompoundContactSplitThreshold (const NewtonWorld* const newtonWorld, int threshold);
+
 	NEWTON_API void NewtonInvalidateCache (const NewtonWorld* const newtonWorld);
 
 	NEWTON_API void NewtonSetSolverIterations (const NewtonWorld* const newtonWorld, int model);
@@ -486,6 +541,14 @@ extern "C" {
 	NEWTON_API void NewtonSetParallelSolverOnLargeIsland (const NewtonWorld* const newtonWorld, int mode);
 	NEWTON_API int NewtonGetParallelSolverOnLargeIsland (const NewtonWorld* const newtonWorld);
 
+	NEWTON_API void NewtonSetDeterministicMode (const NewtonWorld* const newtonWorld, int mode);
+	NEWTON_API int NewtonGetDeterministicMode (const NewtonWorld* const newtonWorld);
+
+	NEWTON_API void NewtonSetPublishedStateMode (const NewtonWorld* const newtonWorld, int mode);
+	NEWTON_API int NewtonGetPublishedStateMode (const NewtonWorld* const newtonWorld);
+	NEWTON_API int NewtonWorldGetPublishedFrame (const NewtonWorld* const newtonWorld);
+	NEWTON_API int NewtonWorldGetPublishedBodyStates (const NewtonWorld* const newtonWorld, const NewtonBody* const* const bodies, int count, const NewtonBodyStateArrays* const arrays);
+
 	NEWTON_API int NewtonGetBroadphaseAlgorithm (const NewtonWorld* const newtonWorld);
 	NEWTON_API void NewtonSelectBroadphaseAlgorithm (const NewtonWorld* const newtonWorld, int algorithmType);
 	NEWTON_API void NewtonResetBroadphase(const NewtonWorld* const newtonWorld);
@@ -497,10 +560,23 @@ extern "C" {
 	NEWTON_API int NewtonGetNumberOfSubsteps (const NewtonWorld* const newtonWorld);
 	NEWTON_API void NewtonSetNumberOfSubsteps (const NewtonWorld* const newtonWorld, int subSteps);
 	NEWTON_API dFloat NewtonGetLastUpdateTime (const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonWorldGetStats (const NewtonWorld* const newtonWorld, NewtonWorldStats* const stats);
 
 	NEWTON_API void NewtonSerializeToFile (const NewtonWorld* const newtonWorld, const char* const filename, NewtonOnBodySerializationCallback bodyCallback, void* const bodyUserData);
 	NEWTON_API void NewtonDeserializeFromFile (const NewtonWorld* const newtonWorld, const char* const filename, NewtonOnBodyDeserializationCallback bodyCallback, void* const bodyUserData);
 
+	NEWTON_API int NewtonWorldGetSnapshotSize (const NewtonWorld* const newtonWorld);
+	NEWTON_API int NewtonWorldSaveSnapshot (const NewtonWorld* const newtonWorld, void* const buffer, int bufferSize);
+	NEWTON_API int NewtonWorldRestoreSnapshot (const NewtonWorld* const newtonWorld, const void* const buffer, int bufferSize);
+
+	NEWTON_API int NewtonWorldGetStateBaselineSize (const NewtonWorld* const newtonWorld);
+	NEWTON_API int NewtonWorldGetStateDeltaMaxSize (const NewtonWorld* const newtonWorld);
+	NEWTON_API int NewtonWorldEncodeStateDelta (const NewtonWorld* const newtonWorld, const NewtonStateDeltaParams* const params, void* const baseline, int baselineSize, void* const delta, int deltaSize);
+	NEWTON_API int NewtonWorldApplyStateDelta (const NewtonWorld* const newtonWorld, const void* const delta, int deltaSize);
+
+	NEWTON_API int NewtonWorldGetBodyStates (const NewtonWorld* const newtonWorld, const NewtonBody* const* const bodies, int count, const NewtonBodyStateArrays* const arrays);
+	NEWTON_API int NewtonWorldSetBodyStates (const NewtonWorld* const newtonWorld, const NewtonBody* const* const bodies, int count, const NewtonBodyStateArrays* const arrays);
+
 	NEWTON_API void NewtonSerializeScene(const NewtonWorld* const newtonWorld, NewtonOnBodySerializationCallback bodyCallback, void* const bodyUserData,
 									   	 NewtonSerializeCallback serializeCallback, void* const serializeHandle);
 	NEWTON_API void NewtonDeserializeScene(const NewtonWorld* const newtonWorld, NewtonOnBodyDeserializationCallback bodyCallback, void* const bodyUserData,
@@ -516,9 +592,25 @@ extern "C" {
 	NEWTON_API void NewtonSetThreadsCount (const NewtonWorld* const newtonWorld, int threads);
 	NEWTON_API int NewtonGetThreadsCount(const NewtonWorld* const newtonWorld);
 	NEWTON_API int NewtonGetMaxThreadsCount(const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonSetThreadsSpinCount (const NewtonWorld* const newtonWorld, int spinCount);
+	NEWTON_API int NewtonGetThreadsSpinCount (const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonSetThreadsName (const NewtonWorld* const newtonWorld, const char* const name);
+	NEWTON_API void NewtonSetThreadAffinity (const NewtonWorld* const newtonWorld, int threadIndex, int firstCpu, int cpuCount);
 	NEWTON_API void NewtonDispachThreadJob(const NewtonWorld* const newtonWorld, NewtonJobTask task, void* const usedData, const char* const functionName);
 	NEWTON_API void NewtonSyncThreadJobs(const NewtonWorld* const newtonWorld);
 
+	// shared thread pool interface
+	NEWTON_API NewtonThreadPool* NewtonCreateThreadPool (int threads);
+	NEWTON_API int NewtonDestroyThreadPool (const NewtonThreadPool* const threadPool);
+	NEWTON_API int NewtonThreadPoolGetThreadsCount (const NewtonThreadPool* const threadPool);
+	NEWTON_API void NewtonThreadPoolSetThreadsName (const NewtonThreadPool* const threadPool, const char* const name);
+	NEWTON_API void NewtonThreadPoolSetThreadAffinity (const NewtonThreadPool* const threadPool, int threadIndex, int firstCpu, int cpuCount);
+	NEWTON_API void NewtonThreadPoolUpdate (const NewtonThreadPool* const threadPool, const NewtonWorld** const newtonWorlds, int worldCount, dFloat timestep);
+	NEWTON_API void NewtonSetThreadPool (const NewtonWorld* const newtonWorld, const NewtonThreadPool* const threadPool);
+	NEWTON_API NewtonThreadPool* NewtonGetThreadPool (const NewtonWorld* const newtonWorld);
+	NEWTON_API void NewtonSetThreadPoolPriority (const NewtonWorld* const newtonWorld, int priority);
+	NEWTON_API int NewtonGetThreadPoolPriority (const NewtonWorld* const newtonWorld);
+
 	// atomic operations
 	NEWTON_API int NewtonAtomicAdd (int* const ptr, int value);
 	NEWTON_API int NewtonAtomicSwap (int* const ptr, int value);
@@ -681,6 +773,8 @@ extern "C" {
 	NEWTON_API void NewtonCompoundCollisionRemoveSubCollisionByIndex (NewtonCollision* const compoundCollision, int nodeIndex);	
 	NEWTON_API void NewtonCompoundCollisionSetSubCollisionMatrix (NewtonCollision* const compoundCollision, const void* const collisionNode, const dFloat* const matrix);	
 	NEWTON_API void NewtonCompoundCollisionEndAddRemove (NewtonCollision* const compoundCollision);	
+	NEWTON_API void NewtonCompoundCollisionSetRefitMode (NewtonCollision* const compoundCollision, int mode);
+	NEWTON_API int NewtonCompoundCollisionGetRefitMode (const NewtonCollision* const compoundCollision);
 
 	NEWTON_API void* NewtonCompoundCollisionGetFirstNode (NewtonCollision* const compoundCollision);
 	NEWTON_API void* NewtonCompoundCollisionGetNextNode (NewtonCollision* const compoundCollision, const void* const collisionNode);
@@ -930,6 +1024,9 @@ extern "C" {
 	NEWTON_API int  NewtonBodyGetSleepState (const NewtonBody* const body);
 	NEWTON_API void NewtonBodySetSleepState (const NewtonBody* const body, int state);
 
+	NEWTON_API int  NewtonBodyGetSkeletonLod (const NewtonBody* const body);
+	NEWTON_API void NewtonBodySetSkeletonLod (const NewtonBody* const body, int lod);
+
 	NEWTON_API int  NewtonBodyGetAutoSleep (const NewtonBody* const body);
 	NEWTON_API void NewtonBodySetAutoSleep (const NewtonBody* const body, int state);
 
@@ -964,6 +1061,7 @@ extern "C" {
 	NEWTON_API void NewtonBodyGetPosition(const NewtonBody* const body, dFloat* const pos);
 	NEWTON_API void NewtonBodyGetMatrix(const NewtonBody* const body, dFloat* const matrix);
 	NEWTON_API void NewtonBodyGetRotation(const NewtonBody* const body, dFloat* const rotation);
+	NEWTON_API int NewtonBodyGetPublishedMatrix(const NewtonBody* const body, dFloat* const matrix);
 	NEWTON_API void NewtonBodyGetMass (const NewtonBody* const body, dFloat* mass, dFloat* const Ixx, dFloat* const Iyy, dFloat* const Izz);
 	NEWTON_API void NewtonBodyGetInvMass(const NewtonBody* const body, dFloat* const invMass, dFloat* const invIxx, dFloat* const invIyy, dFloat* const invIzz);
 	NEWTON_API void NewtonBodyGetInertiaMatrix(const NewtonBody* const body, dFloat* const inertiaMatrix);
@@ -1066,6 +1164,7 @@ extern "C" {
 	NEWTON_API void NewtonInverseDynamicsEndBuild (NewtonInverseDynamics* const inverseDynamics);
 
 	NEWTON_API void NewtonInverseDynamicsUpdate (NewtonInverseDynamics* const inverseDynamics, dFloat timestep, int threadIndex);
+	NEWTON_API void NewtonInverseDynamicsUpdateBatch (NewtonInverseDynamics** const inverseDynamicsArray, int count, dFloat timestep);
 
 	// **********************************************************************************************
 	//
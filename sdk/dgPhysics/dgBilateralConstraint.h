@@ -88,6 +88,7 @@ class dgBilateralConstraint: public dgConstraint
 	dgInt8	  m_rowIsMotor;
 	dgInt8	  m_rowIsIk;
 
+	friend class dgWorld;
 	friend class dgBodyMasterList;
 	friend class dgInverseDynamics;
 	friend class dgWorldDynamicUpdate;
@@ -40,6 +40,7 @@
 #define DG_CONTACT_ANGULAR_ERROR		(dgFloat32 (0.25f * dgDegreeToRad))
 #define DG_NARROW_PHASE_DIST			dgFloat32 (0.2f)
 #define DG_CONTACT_DELAY_FRAMES			4
+#define DG_COMPOUND_TASK_MAX_CONTACTS	(DG_CONSTRAINT_MAX_ROWS / 3)
 
 //#define DG_USE_OLD_SCANNER
 
@@ -153,13 +154,25 @@ dgBroadPhase::dgBroadPhase(dgWorld* const world)
 	,m_lru(DG_CONTACT_DELAY_FRAMES)
 	,m_contactCache(world->GetAllocator())
 	,m_pendingSoftBodyCollisions(world->GetAllocator(), 64)
+	,m_pendingCompoundPairs(world->GetAllocator())
+	,m_compoundPairTasks(world->GetAllocator())
+	,m_compoundPairContacts(world->GetAllocator())
+	,m_compoundPairScratchContacts(world->GetAllocator())
+	,m_pendingWakeContacts(world->GetAllocator())
 	,m_pendingSoftBodyPairsCount(0)
+	,m_pendingCompoundPairsCount(0)
+	,m_pendingWakeContactsCount(0)
+	,m_compoundPairTasksCount(0)
+	,m_compoundPairScratchCount(0)
 	,m_criticalSectionLock(0)
 {
 }
 
 dgBroadPhase::~dgBroadPhase()
 {
+	for (dgInt32 i = 0; i < m_compoundPairScratchCount; i++) {
+		delete m_compoundPairScratchContacts[i];
+	}
 }
 
 
@@ -736,33 +749,53 @@ void dgBroadPhase::UpdateBody(dgBody* const body, dgInt32 threadIndex)
 		if (!dgBoxInclusionTest(body1->m_minAABB, body1->m_maxAABB, node->m_minBox, node->m_maxBox)) {
 			dgAssert(!node->IsAggregate());
 			node->SetAABB(body1->m_minAABB, body1->m_maxAABB);
+			UpdateParentBoxes(node);
+		}
+	}
+}
 
-			if (!m_rootNode->IsLeafNode()) {
-				const dgBroadPhaseNode* const root = (m_rootNode->GetLeft() && m_rootNode->GetRight()) ? NULL : m_rootNode;
-				for (dgBroadPhaseNode* parent = node->m_parent; parent != root; parent = parent->m_parent) {
-					dgScopeSpinPause lock(&parent->m_criticalSectionLock);
-					if (!parent->IsAggregate()) {
-						dgVector minBox;
-						dgVector maxBox;
-						dgFloat32 area = CalculateSurfaceArea(parent->GetLeft(), parent->GetRight(), minBox, maxBox);
-						if (dgBoxInclusionTest(minBox, maxBox, parent->m_minBox, parent->m_maxBox)) {
-							break;
-						}
-						parent->m_minBox = minBox;
-						parent->m_maxBox = maxBox;
-						parent->m_surfaceArea = area;
-					} else {
-						dgBroadPhaseAggregate* const aggregate = (dgBroadPhaseAggregate*)parent;
-						aggregate->m_minBox = aggregate->m_root->m_minBox;
-						aggregate->m_maxBox = aggregate->m_root->m_maxBox;
-						aggregate->m_surfaceArea = aggregate->m_root->m_surfaceArea;
-					}
+void dgBroadPhase::UpdateParentBoxes(dgBroadPhaseNode* const node)
+{
+	if (!m_rootNode->IsLeafNode()) {
+		const dgBroadPhaseNode* const root = (m_rootNode->GetLeft() && m_rootNode->GetRight()) ? NULL : m_rootNode;
+		for (dgBroadPhaseNode* parent = node->m_parent; parent != root; parent = parent->m_parent) {
+			dgScopeSpinPause lock(&parent->m_criticalSectionLock);
+			if (!parent->IsAggregate()) {
+				dgVector minBox;
+				dgVector maxBox;
+				dgFloat32 area = CalculateSurfaceArea(parent->GetLeft(), parent->GetRight(), minBox, maxBox);
+				if (dgBoxInclusionTest(minBox, maxBox, parent->m_minBox, parent->m_maxBox)) {
+					break;
 				}
+				parent->m_minBox = minBox;
+				parent->m_maxBox = maxBox;
+				parent->m_surfaceArea = area;
+			} else {
+				dgBroadPhaseAggregate* const aggregate = (dgBroadPhaseAggregate*)parent;
+				aggregate->m_minBox = aggregate->m_root->m_minBox;
+				aggregate->m_maxBox = aggregate->m_root->m_maxBox;
+				aggregate->m_surfaceArea = aggregate->m_root->m_surfaceArea;
 			}
 		}
 	}
 }
 
+void dgBroadPhase::RestoreBodyBox(dgBody* const body, const dgVector& minBox, const dgVector& maxBox)
+{
+	// the leaf box is restored verbatim, so pair generation sees the same boxes it saw when the snapshot was taken
+	if (m_rootNode && body->m_masterNode) {
+		dgBroadPhaseBodyNode* const node = body->GetBroadPhase();
+		if (node) {
+			dgAssert(!node->IsAggregate());
+			node->m_minBox = minBox;
+			node->m_maxBox = maxBox;
+			dgVector side0(maxBox - minBox);
+			node->m_surfaceArea = side0.DotProduct(side0.ShiftTripleRight()).m_x;
+			UpdateParentBoxes(node);
+		}
+	}
+}
+
 
 dgBroadPhaseNode* dgBroadPhase::BuildTopDown(dgBroadPhaseNode** const leafArray, dgInt32 firstBox, dgInt32 lastBox, dgFitnessList::dgListNode** const nextNode)
 {
@@ -833,6 +866,25 @@ dgBroadPhaseNode* dgBroadPhase::BuildTopDownBig(dgBroadPhaseNode** const leafArr
 }
 
 
+dgInt32 dgBroadPhase::CompareContactsByBodyID(dgContact* const* const contactA, dgContact* const* const contactB, void* const)
+{
+	const dgInt32 idA0 = dgMin ((*contactA)->GetBody0()->GetUniqueID(), (*contactA)->GetBody1()->GetUniqueID());
+	const dgInt32 idB0 = dgMin ((*contactB)->GetBody0()->GetUniqueID(), (*contactB)->GetBody1()->GetUniqueID());
+	if (idA0 < idB0) {
+		return -1;
+	} else if (idA0 > idB0) {
+		return 1;
+	}
+	const dgInt32 idA1 = dgMax ((*contactA)->GetBody0()->GetUniqueID(), (*contactA)->GetBody1()->GetUniqueID());
+	const dgInt32 idB1 = dgMax ((*contactB)->GetBody0()->GetUniqueID(), (*contactB)->GetBody1()->GetUniqueID());
+	if (idA1 < idB1) {
+		return -1;
+	} else if (idA1 > idB1) {
+		return 1;
+	}
+	return 0;
+}
+
 dgInt32 dgBroadPhase::CompareNodes(const dgBroadPhaseNode* const nodeA, const dgBroadPhaseNode* const nodeB, void* const)
 {
 	dgFloat32 areaA = nodeA->m_surfaceArea;
@@ -860,13 +912,19 @@ void dgBroadPhase::ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy,
 				m_world->m_solverJacobiansMemory.ResizeIfNecessary ((fitness.GetCount() * 2 + 16) * sizeof (dgBroadPhaseNode*));
 				dgBroadPhaseNode** const leafArray = (dgBroadPhaseNode**)&m_world->m_solverJacobiansMemory[0];
 
+				// in deterministic mode leaf boxes are only changed by UpdateBody, so they do not depend on when the tree was rebuilt.
+				// The tree entropy is not part of a world snapshot, so a rebuild can happen at a different step after a restore.
+				// This is intended, the cost is that a leaf box is not shrunk back to its body until the body leaves it
+				const bool resetLeafBoxes = !m_world->m_deterministicMode;
 				dgInt32 leafNodesCount = 0;
 				for (dgFitnessList::dgListNode* nodePtr = fitness.GetFirst(); nodePtr; nodePtr = nodePtr->GetNext()) {
 					dgBroadPhaseNode* const node = nodePtr->GetInfo();
 					dgBroadPhaseNode* const leftNode = node->GetLeft();
 					dgBody* const leftBody = leftNode->GetBody();
 					if (leftBody) {
-						node->SetAABB(leftBody->m_minAABB, leftBody->m_maxAABB);
+						if (resetLeafBoxes) {
+							node->SetAABB(leftBody->m_minAABB, leftBody->m_maxAABB);
+						}
 						leafArray[leafNodesCount] = leftNode;
 						leafNodesCount++;
 					} else if (leftNode->IsAggregate()) {
@@ -876,7 +934,9 @@ void dgBroadPhase::ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy,
 					dgBroadPhaseNode* const rightNode = node->GetRight();
 					dgBody* const rightBody = rightNode->GetBody();
 					if (rightBody) {
-						rightNode->SetAABB(rightBody->m_minAABB, rightBody->m_maxAABB);
+						if (resetLeafBoxes) {
+							rightNode->SetAABB(rightBody->m_minAABB, rightBody->m_maxAABB);
+						}
 						leafArray[leafNodesCount] = rightNode;
 						leafNodesCount++;
 					} else if (rightNode->IsAggregate()) {
@@ -1095,7 +1155,42 @@ void dgBroadPhase::CalculatePairContacts (dgPair* const pair, dgInt32 threadID)
 	}
 }
 
-void dgBroadPhase::AddPair (dgContact* const contact, dgFloat32 timestep, dgInt32 threadIndex)
+bool dgBroadPhase::IsLargeCompoundPair (const dgContact* const contact) const
+{
+	// the decision does not depend on the thread count, so split pairs produce the same contacts with any number of threads.
+	// the compound collision callback receives the contact joint for each child pair, those pairs stay on a single thread
+	const dgInt32 threshold = m_world->m_compoundContactSplitThreshold;
+	if (!threshold || contact->m_material->m_compoundAABBOverlap) {
+		return false;
+	}
+
+	const dgCollisionInstance* instance0 = contact->GetBody0()->GetCollision();
+	const dgCollisionInstance* instance1 = contact->GetBody1()->GetCollision();
+	if (!instance0->IsType(dgCollision::dgCollisionCompound_RTTI)) {
+		dgSwap (instance0, instance1);
+	}
+	if (!instance0->IsType(dgCollision::dgCollisionCompound_RTTI) || instance0->IsType(dgCollision::dgCollisionScene_RTTI) || instance1->IsType(dgCollision::dgCollisionScene_RTTI)) {
+		return false;
+	}
+
+	const dgCollisionCompound* const compound0 = (dgCollisionCompound*)instance0->GetChildShape();
+	if (!compound0->m_root) {
+		return false;
+	}
+
+	dgInt32 cost = 0;
+	const dgInt32 leafCount0 = compound0->m_array.GetCount();
+	if (instance1->IsType(dgCollision::dgCollisionCompound_RTTI)) {
+		const dgCollisionCompound* const compound1 = (dgCollisionCompound*)instance1->GetChildShape();
+		cost = compound1->m_root ? leafCount0 * compound1->m_array.GetCount() : 0;
+	} else if (instance1->IsType(dgCollision::dgCollisionBVH_RTTI)) {
+		// a collision tree has no leaf count, charge each child shape for a small patch of faces
+		cost = leafCount0 * 16;
+	}
+	return cost > threshold;
+}
+
+bool dgBroadPhase::AddPair (dgContact* const contact, dgFloat32 timestep, dgInt32 threadIndex)
 {
 	//DG_TRACKTIME();
 	dgWorld* const world = (dgWorld*) m_world;
@@ -1111,7 +1206,7 @@ void dgBroadPhase::AddPair (dgContact* const contact, dgFloat32 timestep, dgInt3
 	dgAssert (body1->GetWorld() == world);
 	if (!(body0->m_collideWithLinkedBodies & body1->m_collideWithLinkedBodies)) {
 		if (world->AreBodyConnectedByJoints (body0, body1)) {
-			return;
+			return false;
 		}
 	}
 
@@ -1120,8 +1215,20 @@ void dgBroadPhase::AddPair (dgContact* const contact, dgFloat32 timestep, dgInt3
 		dgInt32 processContacts = 1;
 		if (material->m_aabbOverlap) {
 			processContacts = material->m_aabbOverlap(*contact, timestep, threadIndex);
+			// remember the answer so that later passes of this step do not call the user again
+			contact->m_aabbOverlapLru = m_lru;
+			contact->m_aabbOverlapAccepted = processContacts ? 1 : 0;
 		}
 		if (processContacts) {
+			if (IsLargeCompoundPair (contact)) {
+				// defer the pair so that its tree traversal can be split across all threads
+				const dgInt32 index = dgAtomicExchangeAndAdd(&m_pendingCompoundPairsCount, 1);
+				dgPendingCompoundPair& pendingPair = m_pendingCompoundPairs[index];
+				pendingPair.m_contact = contact;
+				pendingPair.m_timestep = timestep;
+				return true;
+			}
+
             dgPair pair;
 			dgAssert (!body0->m_collision->IsType (dgCollision::dgCollisionNull_RTTI));
 			dgAssert (!body1->m_collision->IsType (dgCollision::dgCollisionNull_RTTI));
@@ -1131,6 +1238,7 @@ void dgBroadPhase::AddPair (dgContact* const contact, dgFloat32 timestep, dgInt3
             CalculatePairContacts (&pair, threadIndex);
 		}
 	}
+	return false;
 }
 
 bool dgBroadPhase::TestOverlaping(const dgBody* const body0, const dgBody* const body1, dgFloat32 timestep) const
@@ -1196,10 +1304,14 @@ bool dgBroadPhase::TestOverlaping(const dgBody* const body0, const dgBody* const
 	return ret;
 }
 
-void dgBroadPhase::AddPair (dgBody* const body0, dgBody* const body1, const dgFloat32 timestep, dgInt32 threadID)
+void dgBroadPhase::AddPair (dgBody* body0, dgBody* body1, const dgFloat32 timestep, dgInt32 threadID)
 {
 	dgAssert(body0);
 	dgAssert(body1);
+	if (m_world->m_deterministicMode && (body0->GetUniqueID() > body1->GetUniqueID())) {
+		// the order a pair is found in depends on how the tree is split between threads
+		dgSwap (body0, body1);
+	}
 	const bool test = TestOverlaping (body0, body1, timestep);
 	if (test) {
 		dgContact* contact = m_contactCache.FindContactJoint(body0, body1);
@@ -1496,6 +1608,208 @@ void dgBroadPhase::UpdateRigidBodyContactKernel(void* const context, void* const
 	broadPhase->UpdateRigidBodyContacts(descriptor, descriptor->m_timestep, threadID);
 }
 
+void dgBroadPhase::UpdateCompoundPairContactKernel(void* const context, void* const , dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
+	dgWorld* const world = descriptor->m_world;
+	dgBroadPhase* const broadPhase = world->GetBroadPhase();
+	broadPhase->UpdateCompoundPairContacts(descriptor, threadID);
+}
+
+void dgBroadPhase::MergeCompoundPairContactKernel(void* const context, void* const , dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgBroadphaseSyncDescriptor* const descriptor = (dgBroadphaseSyncDescriptor*)context;
+	dgWorld* const world = descriptor->m_world;
+	dgBroadPhase* const broadPhase = world->GetBroadPhase();
+	broadPhase->MergeCompoundPairContacts(descriptor, threadID);
+}
+
+void dgBroadPhase::BuildCompoundPairTasks()
+{
+	DG_TRACKTIME();
+	dgInt32 taskCount = 0;
+	const dgInt32 pairsCount = m_pendingCompoundPairsCount;
+	for (dgInt32 i = 0; i < pairsCount; i++) {
+		dgPendingCompoundPair& pendingPair = m_pendingCompoundPairs[i];
+		dgContact* const contact = pendingPair.m_contact;
+
+		// same body order as dgWorld::CalculateContacts, the compound is always body0
+		if (!contact->GetBody0()->GetCollision()->IsType(dgCollision::dgCollisionCompound_RTTI)) {
+			contact->SwapBodies();
+		}
+
+		pendingPair.m_isActive = contact->m_isActive;
+		contact->m_isActive = 0;
+
+		dgPair pair;
+		pair.m_contact = contact;
+		pair.m_timestep = pendingPair.m_timestep;
+
+		m_compoundPairTasks.ResizeIfNecessary(taskCount + DG_COMPOUND_MAX_CONTACT_TASKS);
+		const dgCollisionCompound* const compound = (dgCollisionCompound*)contact->GetBody0()->GetCollision()->GetChildShape();
+		dgCompoundPairTask* const tasks = &m_compoundPairTasks[taskCount];
+		const dgInt32 count = compound->BuildContactTasks(&pair, tasks, DG_COMPOUND_MAX_CONTACT_TASKS);
+		for (dgInt32 j = 0; j < count; j++) {
+			tasks[j].m_pairIndex = i;
+			tasks[j].m_contactCount = 0;
+			tasks[j].m_closestDistance = dgFloat32(1.0e10f);
+		}
+		pendingPair.m_taskStart = taskCount;
+		pendingPair.m_taskCount = count;
+		taskCount += count;
+	}
+	m_compoundPairTasksCount = taskCount;
+	m_compoundPairContacts.ResizeIfNecessary(taskCount * DG_COMPOUND_TASK_MAX_CONTACTS);
+
+	// each task collides against its own copy of the joint narrow phase state
+	m_compoundPairScratchContacts.ResizeIfNecessary(taskCount);
+	for (dgInt32 i = m_compoundPairScratchCount; i < taskCount; i++) {
+		m_compoundPairScratchContacts[i] = new (m_world->GetAllocator()) dgContact(m_world->GetAllocator());
+	}
+	m_compoundPairScratchCount = dgMax(m_compoundPairScratchCount, taskCount);
+	for (dgInt32 i = 0; i < taskCount; i++) {
+		const dgCompoundPairTask& task = m_compoundPairTasks[i];
+		m_compoundPairScratchContacts[i]->CopyCollisionState(m_pendingCompoundPairs[task.m_pairIndex].m_contact);
+	}
+}
+
+void dgBroadPhase::UpdateCompoundPairContacts(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 threadID)
+{
+	DG_TRACKTIME();
+	// tasks of the same pair run concurrently, each one writes only its own scratch joint and output slot,
+	// the merge pass combines them in task order so the result does not depend on which thread ran them.
+	dgContactPoint contacts[DG_MAX_CONTATCS];
+	const dgInt32 taskCount = m_compoundPairTasksCount;
+	dgCompoundPairTask* const tasks = &m_compoundPairTasks[0];
+	const dgPendingCompoundPair* const pendingPairs = &m_pendingCompoundPairs[0];
+	dgContact** const scratchContacts = &m_compoundPairScratchContacts[0];
+	dgContactPoint* const contactBuffer = &m_compoundPairContacts[0];
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1); i < taskCount; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1)) {
+		dgCompoundPairTask& task = tasks[i];
+		const dgPendingCompoundPair& pendingPair = pendingPairs[task.m_pairIndex];
+		dgContact* const contact = scratchContacts[i];
+
+		dgPair pair;
+		pair.m_contact = contact;
+		pair.m_contactBuffer = contacts;
+		pair.m_timestep = pendingPair.m_timestep;
+		pair.m_cacheIsValid = false;
+		pair.m_flipContacts = false;
+
+		dgCollisionParamProxy proxy(contact, contacts, threadID, false, false);
+		proxy.m_timestep = pendingPair.m_timestep;
+		proxy.m_maxContacts = DG_MAX_CONTATCS;
+		proxy.m_skinThickness = contact->m_material->m_skinThickness;
+
+		const dgCollisionCompound* const compound = (dgCollisionCompound*)contact->GetBody0()->GetCollision()->GetChildShape();
+		dgInt32 count = compound->CalculateContactsTask(&pair, proxy, task, task.m_closestDistance);
+		if (count > DG_COMPOUND_TASK_MAX_CONTACTS) {
+			count = m_world->PruneContacts(count, contacts, contact->GetPruningTolerance(), DG_COMPOUND_TASK_MAX_CONTACTS);
+		}
+		dgAssert(count <= DG_COMPOUND_TASK_MAX_CONTACTS);
+		memcpy(&contactBuffer[i * DG_COMPOUND_TASK_MAX_CONTACTS], contacts, count * sizeof (dgContactPoint));
+		task.m_contactCount = count;
+	}
+}
+
+void dgBroadPhase::MergeCompoundPairContacts(dgBroadphaseSyncDescriptor* const descriptor, dgInt32 threadID)
+{
+	DG_TRACKTIME();
+	dgContactPoint contacts[DG_MAX_CONTATCS];
+
+	const dgInt32 threadCount = m_world->GetThreadCount();
+	const dgInt32 pairsCount = m_pendingCompoundPairsCount;
+	const dgCompoundPairTask* const tasks = &m_compoundPairTasks[0];
+	dgContact** const scratchContacts = &m_compoundPairScratchContacts[0];
+	dgContactPoint* const contactBuffer = &m_compoundPairContacts[0];
+	for (dgInt32 i = threadID; i < pairsCount; i += threadCount) {
+		const dgPendingCompoundPair& pendingPair = m_pendingCompoundPairs[i];
+		dgContact* const contact = pendingPair.m_contact;
+		const dgFloat32 pruningTolerance = contact->GetPruningTolerance();
+
+		dgInt32 count = 0;
+		dgInt32 isActive = 0;
+		dgInt32 isNewContact = contact->m_isNewContact;
+		dgVector separatingVector(contact->m_separtingVector);
+		dgFloat32 closestDistance = dgFloat32(1.0e10f);
+		for (dgInt32 j = 0; j < pendingPair.m_taskCount; j++) {
+			const dgInt32 taskIndex = pendingPair.m_taskStart + j;
+			const dgCompoundPairTask& task = tasks[taskIndex];
+			const dgContact* const scratch = scratchContacts[taskIndex];
+			dgContactPoint* const taskContacts = &contactBuffer[taskIndex * DG_COMPOUND_TASK_MAX_CONTACTS];
+
+			isActive |= scratch->m_isActive;
+			isNewContact &= scratch->m_isNewContact;
+			if (task.m_closestDistance < closestDistance) {
+				closestDistance = task.m_closestDistance;
+				separatingVector = scratch->m_separtingVector;
+			}
+
+			dgInt32 taskContactCount = task.m_contactCount;
+			if (taskContactCount > (DG_MAX_CONTATCS - count)) {
+				count = m_world->PruneContacts(count, contacts, pruningTolerance, 16);
+			}
+			if (taskContactCount > (DG_MAX_CONTATCS - count)) {
+				taskContactCount = m_world->PruneContacts(taskContactCount, taskContacts, pruningTolerance, 16);
+			}
+			memcpy(&contacts[count], taskContacts, taskContactCount * sizeof (dgContactPoint));
+			count += taskContactCount;
+		}
+
+		contact->m_isActive = isActive;
+		contact->m_isNewContact = isNewContact;
+		contact->m_separtingVector = separatingVector;
+		contact->m_closestDistance = closestDistance;
+		contact->m_separationDistance = dgFloat32(0.0f);
+		if (count > 1) {
+			count = m_world->PruneContacts(count, contacts, pruningTolerance, 16);
+		}
+
+		dgPair pair;
+		pair.m_contact = contact;
+		pair.m_contactBuffer = contacts;
+		pair.m_timestep = pendingPair.m_timestep;
+		pair.m_contactCount = count;
+		pair.m_cacheIsValid = false;
+		pair.m_flipContacts = false;
+		if (count) {
+			dgAssert(count <= (DG_CONSTRAINT_MAX_ROWS / 3));
+			m_world->ProcessContacts(&pair, threadID);
+			KinematicBodyActivation(contact);
+		} else {
+			contact->m_maxDOF = 0;
+		}
+
+		if (contact->m_maxDOF) {
+			contact->m_timeOfImpact = dgFloat32(1.0e10f);
+		}
+
+		if (pendingPair.m_isActive ^ contact->m_isActive) {
+			// pairs that share a body are merged by different threads, the bodies are woken up after the merge
+			const dgInt32 index = dgAtomicExchangeAndAdd(&m_pendingWakeContactsCount, 1);
+			m_pendingWakeContacts[index] = contact;
+		}
+	}
+}
+
+void dgBroadPhase::WakePendingContacts()
+{
+	for (dgInt32 i = 0; i < m_pendingWakeContactsCount; i++) {
+		dgContact* const contact = m_pendingWakeContacts[i];
+		dgBody* const body0 = contact->GetBody0();
+		dgBody* const body1 = contact->GetBody1();
+		if (body0->GetInvMass().m_w) {
+			body0->m_equilibrium = false;
+		}
+		if (body1->GetInvMass().m_w) {
+			body1->m_equilibrium = false;
+		}
+	}
+	m_pendingWakeContactsCount = 0;
+}
+
 void dgBroadPhase::UpdateSoftBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgFloat32 timeStep, dgInt32 threadID)
 {
 	dgAssert(0);
@@ -1566,8 +1880,10 @@ void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const des
 					contact->m_separationDistance = distance;
 				}
 				if (distance < DG_NARROW_PHASE_DIST) {
-					AddPair(contact, timestep, threadID);
-					if (contact->m_maxDOF) {
+					if (AddPair(contact, timestep, threadID)) {
+						// deferred pairs update their active state once the compound pass is done
+						contact->m_isActive = isActive;
+					} else if (contact->m_maxDOF) {
 						contact->m_timeOfImpact = dgFloat32(1.0e10f);
 					}
 					contact->m_broadphaseLru = m_lru;
@@ -1584,11 +1900,18 @@ void dgBroadPhase::UpdateRigidBodyContacts(dgBroadphaseSyncDescriptor* const des
 			}
 
 			if (isActive ^ contact->m_isActive) {
-				if (body0->GetInvMass().m_w) {
-					body0->m_equilibrium = false;
-				}
-				if (body1->GetInvMass().m_w) {
-					body1->m_equilibrium = false;
+				if (m_world->m_deterministicMode) {
+					// other contacts of these bodies read the equilibrium flag in this same loop, 
+					// so the wake up is deferred until all contacts are updated
+					const dgInt32 index = dgAtomicExchangeAndAdd(&m_pendingWakeContactsCount, 1);
+					m_pendingWakeContacts[index] = contact;
+				} else {
+					if (body0->GetInvMass().m_w) {
+						body0->m_equilibrium = false;
+					}
+					if (body1->GetInvMass().m_w) {
+						body1->m_equilibrium = false;
+					}
 				}
 			}
 
@@ -1696,6 +2019,7 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 	D_TRACKTIME();
     m_lru = m_lru + 1;
 	m_pendingSoftBodyPairsCount = 0;
+	dgUnsigned64 timeAcc = dgGetTimeInMicrosenconds();
 
 	const dgInt32 threadsCount = m_world->GetThreadCount();
 
@@ -1720,6 +2044,9 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 			}
 		}
 	}
+	dgUnsigned64 phaseTime = dgGetTimeInMicrosenconds();
+	m_world->m_stats.m_forceAndTorqueTime += (phaseTime - timeAcc) * dgFloat32 (1.0e-6f);
+	timeAcc = phaseTime;
 
 	// check for sleeping bodies states
 	node = masterList->GetFirst()->GetNext();
@@ -1750,12 +2077,43 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 		broadPhaseNode = broadPhaseNode ? broadPhaseNode->GetNext() : NULL;
 	}
 	m_world->SynchronizationBarrier();
-
+	phaseTime = dgGetTimeInMicrosenconds();
+	m_world->m_stats.m_broadPhaseTime += (phaseTime - timeAcc) * dgFloat32 (1.0e-6f);
+	timeAcc = phaseTime;
+
+	if (m_world->m_deterministicMode && (contactList.m_contactCount > syncPoints.m_contactStart)) {
+		// new contacts are pushed in the order the threads find them, 
+		// sort them so that the contact list and therefore the islands do not depend on the thread count
+		dgSort(&contactList[syncPoints.m_contactStart], contactList.m_contactCount - syncPoints.m_contactStart, CompareContactsByBodyID);
+	}
 	AttachNewContact(syncPoints.m_contactStart);
+	m_pendingCompoundPairsCount = 0;
+	m_pendingCompoundPairs.ResizeIfNecessary(contactList.m_contactCount);
+	m_pendingWakeContactsCount = 0;
+	if (m_world->m_deterministicMode) {
+		m_pendingWakeContacts.ResizeIfNecessary(contactList.m_contactCount);
+	}
 	for (dgInt32 i = 0; i < threadsCount; i++) {
 		m_world->QueueJob(UpdateRigidBodyContactKernel, &syncPoints, NULL, "dgBroadPhase::UpdateRigidBodyContact");
 	}
 	m_world->SynchronizationBarrier();
+	WakePendingContacts();
+
+	if (m_pendingCompoundPairsCount) {
+		BuildCompoundPairTasks();
+		m_pendingWakeContacts.ResizeIfNecessary(m_pendingCompoundPairsCount);
+		syncPoints.m_atomicIndex = 0;
+		for (dgInt32 i = 0; i < threadsCount; i++) {
+			m_world->QueueJob(UpdateCompoundPairContactKernel, &syncPoints, NULL, "dgBroadPhase::UpdateCompoundPairContact");
+		}
+		m_world->SynchronizationBarrier();
+
+		for (dgInt32 i = 0; i < threadsCount; i++) {
+			m_world->QueueJob(MergeCompoundPairContactKernel, &syncPoints, NULL, "dgBroadPhase::MergeCompoundPairContact");
+		}
+		m_world->SynchronizationBarrier();
+		WakePendingContacts();
+	}
 
 	if (m_pendingSoftBodyPairsCount) {
 		dgAssert (0);
@@ -1783,4 +2141,8 @@ void dgBroadPhase::UpdateContacts(dgFloat32 timestep)
 	}
 
 	DeleteDeadContact();
+
+	m_world->m_stats.m_narrowPhaseTime += (dgGetTimeInMicrosenconds() - timeAcc) * dgFloat32 (1.0e-6f);
+	m_world->m_stats.m_pairsCount = contactList.m_contactCount;
+	m_world->m_stats.m_contactsCount = contactList.m_activeContactCount;
 }
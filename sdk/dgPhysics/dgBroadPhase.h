@@ -464,6 +464,16 @@ class dgBroadPhase
 		dgInt32 m_flipContacts : 1;
 	};
 
+	class dgCompoundPairTask
+	{
+		public:
+		const void* m_myNode;
+		const void* m_otherNode;
+		dgFloat32 m_closestDistance;
+		dgInt32 m_contactCount;
+		dgInt32 m_pairIndex;
+	};
+
 	dgBroadPhase(dgWorld* const world);
 	virtual ~dgBroadPhase();
 
@@ -501,6 +511,8 @@ class dgBroadPhase
 	virtual void FindCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgList<dgBroadPhaseNode*>::dgListNode* const node, dgInt32 threadID) = 0;
 
 	void UpdateBody(dgBody* const body, dgInt32 threadIndex);
+	void UpdateParentBoxes(dgBroadPhaseNode* const node);
+	void RestoreBodyBox(dgBody* const body, const dgVector& minBox, const dgVector& maxBox);
 	void AddInternallyGeneratedBody(dgBody* const body)
 	{
 		m_generatedBodies.Append(body);
@@ -525,8 +537,8 @@ class dgBroadPhase
 	void ImproveFitness(dgFitnessList& fitness, dgFloat64& oldEntropy, dgBroadPhaseNode** const root);
 
 	void CalculatePairContacts (dgPair* const pair, dgInt32 threadID);
-	void AddPair (dgContact* const contact, dgFloat32 timestep, dgInt32 threadIndex);
-	void AddPair (dgBody* const body0, dgBody* const body1, dgFloat32 timestep, dgInt32 threadID);	
+	bool AddPair (dgContact* const contact, dgFloat32 timestep, dgInt32 threadIndex);
+	void AddPair (dgBody* body0, dgBody* body1, dgFloat32 timestep, dgInt32 threadID);	
 
 	bool TestOverlaping(const dgBody* const body0, const dgBody* const body1, dgFloat32 timestep) const;
 
@@ -552,6 +564,11 @@ class dgBroadPhase
 	void FindGeneratedBodiesCollidingPairs (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 threadID);
 	void UpdateSoftBodyContacts(dgBroadphaseSyncDescriptor* const descriptor, dgFloat32 timeStep, dgInt32 threadID);
 	void UpdateRigidBodyContacts (dgBroadphaseSyncDescriptor* const descriptor, dgFloat32 timeStep, dgInt32 threadID);
+	void UpdateCompoundPairContacts (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 threadID);
+	void MergeCompoundPairContacts (dgBroadphaseSyncDescriptor* const descriptor, dgInt32 threadID);
+	bool IsLargeCompoundPair (const dgContact* const contact) const;
+	void BuildCompoundPairTasks ();
+	void WakePendingContacts ();
 	void SubmitPairs (dgBroadPhaseNode* const body, dgBroadPhaseNode* const node, dgFloat32 timestep, dgInt32 threaCount, dgInt32 threadID);
 
 	bool SanityCheck() const;
@@ -567,7 +584,10 @@ class dgBroadPhase
 	static void AddGeneratedBodiesContactsKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static void UpdateRigidBodyContactKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static void UpdateSoftBodyContactKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
+	static void UpdateCompoundPairContactKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
+	static void MergeCompoundPairContactKernel(void* const descriptor, void* const worldContext, dgInt32 threadID);
 	static dgInt32 CompareNodes(const dgBroadPhaseNode* const nodeA, const dgBroadPhaseNode* const nodeB, void* const notUsed);
+	static dgInt32 CompareContactsByBodyID(dgContact* const* const contactA, dgContact* const* const contactB, void* const notUsed);
 
 	class dgPendingCollisionSoftBodies
 	{
@@ -576,6 +596,16 @@ class dgBroadPhase
 		dgBody* m_body1;
 	};
 
+	class dgPendingCompoundPair
+	{
+		public:
+		dgContact* m_contact;
+		dgFloat32 m_timestep;
+		dgInt32 m_taskStart;
+		dgInt32 m_taskCount;
+		dgInt32 m_isActive;
+	};
+
 	dgWorld* m_world;
 	dgBroadPhaseNode* m_rootNode;
 	dgList<dgBody*> m_generatedBodies;
@@ -584,7 +614,16 @@ class dgBroadPhase
 	dgUnsigned32 m_lru;
 	dgContactCache m_contactCache;
 	dgArray<dgPendingCollisionSoftBodies> m_pendingSoftBodyCollisions;
+	dgArray<dgPendingCompoundPair> m_pendingCompoundPairs;
+	dgArray<dgCompoundPairTask> m_compoundPairTasks;
+	dgArray<dgContactPoint> m_compoundPairContacts;
+	dgArray<dgContact*> m_compoundPairScratchContacts;
+	dgArray<dgContact*> m_pendingWakeContacts;
 	dgInt32 m_pendingSoftBodyPairsCount;
+	dgInt32 m_pendingCompoundPairsCount;
+	dgInt32 m_pendingWakeContactsCount;
+	dgInt32 m_compoundPairTasksCount;
+	dgInt32 m_compoundPairScratchCount;
 	dgInt32 m_criticalSectionLock;
 
 	static dgVector m_velocTol;
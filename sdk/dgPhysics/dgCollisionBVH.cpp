@@ -290,13 +290,14 @@ dgFloat32 dgCollisionBVH::RayCast (const dgVector& localP0, const dgVector& loca
 dgIntersectStatus dgCollisionBVH::GetPolygon (void* const context, const dgFloat32* const polygon, dgInt32 strideInBytes, const dgInt32* const indexArray, dgInt32 indexCount, dgFloat32 hitDistance)
 {
 	dgPolygonMeshDesc& data = (*(dgPolygonMeshDesc*) context);
-	if (data.m_faceCount >= DG_MAX_COLLIDING_FACES) {
-		dgTrace (("buffer Over float, try using a lower resolution mesh for collision\n"));
-		return t_StopSearh;
-	}
-	if ((data.m_globalIndexCount + indexCount * 2 + 3) >= DG_MAX_COLLIDING_INDICES) {
-		dgTrace (("buffer Over float, try using a lower resolution mesh for collision\n"));
-		return t_StopSearh;
+	if (!data.HasRoomForFace(indexCount)) {
+		if (!data.CanStreamFaces()) {
+			dgTrace (("buffer Over float, try using a lower resolution mesh for collision\n"));
+			return t_StopSearh;
+		}
+		if (!data.FlushFaceBatch()) {
+			return t_StopSearh;
+		}
 	}
 
 	if (data.m_me->GetDebugCollisionCallback()) { 
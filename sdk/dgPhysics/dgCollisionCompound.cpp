@@ -464,11 +464,17 @@ dgCollisionCompound::dgCollisionCompound(dgWorld* const world)
 	,m_root(NULL)
 	,m_myInstance(NULL)
 	,m_array (world->GetAllocator())
+	,m_refitNodes (world->GetAllocator())
 	,m_treeEntropy (dgFloat32 (0.0f))
+	,m_treeCost (dgFloat32 (0.0f))
+	,m_refitBaseCost (dgFloat32 (0.0f))
 	,m_boxMinRadius(dgFloat32(0.0f))
 	,m_boxMaxRadius(dgFloat32(0.0f))
 	,m_idIndex(0)
 	,m_criticalSectionLock(0)
+	,m_refitNodesCount(0)
+	,m_refitMode(false)
+	,m_refitTreeChanged(false)
 {
 	m_rtti |= dgCollisionCompound_RTTI;
 }
@@ -479,11 +485,17 @@ dgCollisionCompound::dgCollisionCompound (const dgCollisionCompound& source, con
 	,m_root(NULL)
 	,m_myInstance(myInstance)
 	,m_array (source.GetAllocator())
+	,m_refitNodes (source.GetAllocator())
 	,m_treeEntropy(source.m_treeEntropy)
+	,m_treeCost(source.m_treeCost)
+	,m_refitBaseCost(source.m_refitBaseCost)
 	,m_boxMinRadius(source.m_boxMinRadius)
 	,m_boxMaxRadius(source.m_boxMaxRadius)
 	,m_idIndex(source.m_idIndex)
 	,m_criticalSectionLock(0)
+	,m_refitNodesCount(0)
+	,m_refitMode(source.m_refitMode)
+	,m_refitTreeChanged(false)
 {
 	m_rtti |= dgCollisionCompound_RTTI;
 
@@ -560,11 +572,17 @@ dgCollisionCompound::dgCollisionCompound (dgWorld* const world, dgDeserialize de
 	,m_root(NULL)
 	,m_myInstance(myInstance)
 	,m_array (world->GetAllocator())
+	,m_refitNodes (world->GetAllocator())
 	,m_treeEntropy(dgFloat32(0.0f))
+	,m_treeCost(dgFloat32(0.0f))
+	,m_refitBaseCost(dgFloat32(0.0f))
 	,m_boxMinRadius(dgFloat32(0.0f))
 	,m_boxMaxRadius(dgFloat32(0.0f))
 	,m_idIndex(0)
 	,m_criticalSectionLock(0)
+	,m_refitNodesCount(0)
+	,m_refitMode(false)
+	,m_refitTreeChanged(false)
 {
 	dgAssert (m_rtti | dgCollisionCompound_RTTI);
 
@@ -874,6 +892,7 @@ void dgCollisionCompound::ApplyScale (const dgVector& scale)
 		collision->SetGlobalScale (scale);
 	}
 	m_treeEntropy = dgFloat32 (0.0f);
+	m_refitTreeChanged = true;
 	EndAddRemove ();
 }
 
@@ -987,6 +1006,39 @@ dgFloat64 dgCollisionCompound::CalculateEntropy (dgList<dgNodeBase*>& list)
 	return cost0;
 }
 
+void dgCollisionCompound::SetRefitMode (bool mode)
+{
+	m_refitMode = mode;
+	m_refitNodesCount = 0;
+	m_refitTreeChanged = false;
+}
+
+bool dgCollisionCompound::GetRefitMode () const
+{
+	return m_refitMode;
+}
+
+bool dgCollisionCompound::RefitTree ()
+{
+	// walk up from each moved leaf and stop as soon as an ancestor box does not change
+	dgAssert (!m_refitTreeChanged);
+	for (dgInt32 i = 0; i < m_refitNodesCount; i ++) {
+		for (dgNodeBase* parent = m_refitNodes[i]->m_parent; parent; parent = parent->m_parent) {
+			dgVector minBox;
+			dgVector maxBox;
+			CalculateSurfaceArea (parent->m_left, parent->m_right, minBox, maxBox);
+			const dgVector test ((minBox == parent->m_p0) & (maxBox == parent->m_p1));
+			if ((test.GetSignMask() & 0x07) == 0x07) {
+				break;
+			}
+			const dgFloat32 area = parent->m_area;
+			parent->SetBox (minBox, maxBox);
+			m_treeCost += parent->m_area - area;
+		}
+	}
+	return m_treeCost < (m_refitBaseCost * DG_COMPOUND_REFIT_COST_RATIO);
+}
+
 void dgCollisionCompound::EndAddRemove (bool flushCache)
 {
 	if (m_root) {
@@ -994,61 +1046,73 @@ void dgCollisionCompound::EndAddRemove (bool flushCache)
 		//dgThreadHiveScopeLock lock (world, &m_criticalSectionLock);
 		dgScopeSpinLock lock(&m_criticalSectionLock);
 
-		dgTreeArray::Iterator iter (m_array);
-		for (iter.Begin(); iter; iter ++) {
-			dgNodeBase* const node = iter.GetNode()->GetInfo();
-			node->CalculateAABB();
-		}
-
-		dgList<dgNodeBase*> list (GetAllocator());
-		dgList<dgNodeBase*> stack (GetAllocator());
-		stack.Append(m_root);
-		while (stack.GetCount()) {
-			dgList<dgNodeBase*>::dgListNode* const stackNode = stack.GetLast();
-			dgNodeBase* const node = stackNode->GetInfo();
-			stack.Remove(stackNode);
+		// only moved sub shapes can be refit, added or removed ones always rebuild the tree
+		const bool refit = m_refitMode && !m_refitTreeChanged && (m_refitBaseCost > dgFloat32 (0.0f)) && RefitTree ();
+		m_refitNodesCount = 0;
+		m_refitTreeChanged = false;
 
-			//if (node->m_type == m_node) {
-			//	list.Append(node);
-			//}
+		if (!refit) {
+			dgTreeArray::Iterator iter (m_array);
+			for (iter.Begin(); iter; iter ++) {
+				dgNodeBase* const node = iter.GetNode()->GetInfo();
+				node->CalculateAABB();
+			}
 
-			if (node->m_type == m_node) {
-				list.Append(node);
-				stack.Append(node->m_right);
-				stack.Append(node->m_left);
-			} 
-		}
+			dgList<dgNodeBase*> list (GetAllocator());
+			dgList<dgNodeBase*> stack (GetAllocator());
+			stack.Append(m_root);
+			while (stack.GetCount()) {
+				dgList<dgNodeBase*>::dgListNode* const stackNode = stack.GetLast();
+				dgNodeBase* const node = stackNode->GetInfo();
+				stack.Remove(stackNode);
+
+				//if (node->m_type == m_node) {
+				//	list.Append(node);
+				//}
+
+				if (node->m_type == m_node) {
+					list.Append(node);
+					stack.Append(node->m_right);
+					stack.Append(node->m_left);
+				} 
+			}
 
-		if (list.GetCount()) {
-			dgFloat64 cost = CalculateEntropy (list);
-			if ((cost > m_treeEntropy * dgFloat32 (2.0f)) || (cost < m_treeEntropy * dgFloat32 (0.5f))) {
-				dgInt32 count = list.GetCount() * 2 + 12;
-				dgInt32 leafNodesCount = 0;
-				dgStack<dgNodeBase*> leafArray(count);
-				for (dgList<dgNodeBase*>::dgListNode* listNode = list.GetFirst(); listNode; listNode = listNode->GetNext()) {
-					dgNodeBase* const node = listNode->GetInfo();
-					if (node->m_left->m_type == m_leaf) {
-						leafArray[leafNodesCount] = node->m_left;
-						leafNodesCount ++;
-					}
-					if (node->m_right->m_type == m_leaf) {
-						leafArray[leafNodesCount] = node->m_right;
-						leafNodesCount ++;
+			if (list.GetCount()) {
+				dgFloat64 cost = CalculateEntropy (list);
+				if ((cost > m_treeEntropy * dgFloat32 (2.0f)) || (cost < m_treeEntropy * dgFloat32 (0.5f))) {
+					dgInt32 count = list.GetCount() * 2 + 12;
+					dgInt32 leafNodesCount = 0;
+					dgStack<dgNodeBase*> leafArray(count);
+					for (dgList<dgNodeBase*>::dgListNode* listNode = list.GetFirst(); listNode; listNode = listNode->GetNext()) {
+						dgNodeBase* const node = listNode->GetInfo();
+						if (node->m_left->m_type == m_leaf) {
+							leafArray[leafNodesCount] = node->m_left;
+							leafNodesCount ++;
+						}
+						if (node->m_right->m_type == m_leaf) {
+							leafArray[leafNodesCount] = node->m_right;
+							leafNodesCount ++;
+						}
 					}
-				}
 
-				dgList<dgNodeBase*>::dgListNode* nodePtr = list.GetFirst();
-				
-				dgSortIndirect (&leafArray[0], leafNodesCount, CompareNodes); 
-				
-				m_root = BuildTopDownBig (&leafArray[0], 0, leafNodesCount - 1, &nodePtr);
-				m_treeEntropy = CalculateEntropy (list);
-			}
-			while (m_root->m_parent) {
-				m_root = m_root->m_parent;
+					dgList<dgNodeBase*>::dgListNode* nodePtr = list.GetFirst();
+					
+					dgSortIndirect (&leafArray[0], leafNodesCount, CompareNodes); 
+					
+					m_root = BuildTopDownBig (&leafArray[0], 0, leafNodesCount - 1, &nodePtr);
+					m_treeEntropy = CalculateEntropy (list);
+					cost = m_treeEntropy;
+				}
+				while (m_root->m_parent) {
+					m_root = m_root->m_parent;
+				}
+				m_treeCost = cost;
+			} else {
+				m_treeEntropy = dgFloat32 (2.0f);
+				m_treeCost = dgFloat32 (0.0f);
 			}
-		} else {
-			m_treeEntropy = dgFloat32 (2.0f);
+			// later refits are measured against the cost of the tree as it is now, not the last full optimization
+			m_refitBaseCost = m_treeCost;
 		}
 
 		dgAssert (m_root->m_size.m_w == dgFloat32 (0.0f));
@@ -1062,6 +1126,9 @@ void dgCollisionCompound::EndAddRemove (bool flushCache)
 		if (flushCache) {
 			m_world->FlushCache ();
 		}
+	} else {
+		m_refitNodesCount = 0;
+		m_refitTreeChanged = false;
 	}
 }
 
@@ -1071,6 +1138,7 @@ dgTree<dgCollisionCompound::dgNodeBase*, dgInt32>::dgTreeNode* dgCollisionCompou
 	m_array.AddNode(newNode, m_idIndex, m_myInstance);
 
 	m_idIndex ++;
+	m_refitTreeChanged = true;
 
 	if (!m_root) {
 		m_root = newNode;
@@ -1134,6 +1202,7 @@ void dgCollisionCompound::RemoveCollision (dgTreeArray::dgTreeNode* const node)
 	if (node) {
 		dgCollisionInstance* const instance = node->GetInfo()->GetShape();
 		instance->AddRef();
+		m_refitTreeChanged = true;
 		RemoveCollision (node->GetInfo());
 		instance->Release();
 		m_array.Remove(node);
@@ -1171,7 +1240,15 @@ void dgCollisionCompound::SetCollisionMatrix (dgTreeArray::dgTreeNode* const nod
 			if (dgBoxInclusionTest (minBox, maxBox, parent->m_p0, parent->m_p1)) {
 				break;
 			}
+			const dgFloat32 area = parent->m_area;
 			parent->SetBox (minBox, maxBox);
+			m_treeCost += parent->m_area - area;
+		}
+
+		if (m_refitMode) {
+			// the ancestors were only grown, record the leaf so that EndAddRemove can also shrink them 
+			m_refitNodes[m_refitNodesCount] = baseNode;
+			m_refitNodesCount ++;
 		}
 	}
 }
@@ -1568,6 +1645,85 @@ dgInt32 dgCollisionCompound::CalculateContacts (dgBroadPhase::dgPair* const pair
 	return contactCount;
 }
 
+dgInt32 dgCollisionCompound::GetSubTrees (const dgNodeBase** const nodes, dgInt32 maxCount) const
+{
+	dgInt32 count = 1;
+	nodes[0] = m_root;
+
+	// open the tree breadth first until the frontier reaches the requested size or all nodes are leaves
+	bool split = true;
+	while (split) {
+		split = false;
+		const dgInt32 frontCount = count;
+		for (dgInt32 i = 0; (i < frontCount) && (count < maxCount); i ++) {
+			const dgNodeBase* const node = nodes[i];
+			if (node->m_type == m_node) {
+				nodes[i] = node->m_left;
+				nodes[count] = node->m_right;
+				count ++;
+				split = true;
+			}
+		}
+	}
+	return count;
+}
+
+dgInt32 dgCollisionCompound::BuildContactTasks (dgBroadPhase::dgPair* const pair, dgBroadPhase::dgCompoundPairTask* const tasks, dgInt32 maxTasks) const
+{
+	const dgNodeBase* myNodes[DG_COMPOUND_MAX_CONTACT_TASKS];
+
+	dgContact* const contactJoint = pair->m_contact;
+	const dgCollisionInstance* const myInstance = contactJoint->GetBody0()->m_collision;
+	const dgCollisionInstance* const otherInstance = contactJoint->GetBody1()->m_collision;
+	dgAssert (m_root);
+	dgAssert (myInstance->GetChildShape() == this);
+
+	dgInt32 taskCount = 0;
+	maxTasks = dgMin (maxTasks, DG_COMPOUND_MAX_CONTACT_TASKS);
+	if (otherInstance->IsType (dgCollision::dgCollisionCompound_RTTI)) {
+		const dgNodeBase* otherNodes[DG_COMPOUND_MAX_CONTACT_TASKS];
+		const dgCollisionCompound* const otherCompound = (dgCollisionCompound*)otherInstance->GetChildShape();
+
+		// split both trees so that all combinations of subtrees fit in the task budget
+		dgInt32 side = 1;
+		while ((side * side * 4) <= maxTasks) {
+			side *= 2;
+		}
+		const dgInt32 myCount = GetSubTrees (myNodes, side);
+		const dgInt32 otherCount = otherCompound->GetSubTrees (otherNodes, maxTasks / myCount);
+
+		dgOOBBTestData data (otherInstance->GetGlobalMatrix() * myInstance->GetGlobalMatrix().Inverse());
+		for (dgInt32 i = 0; i < myCount; i ++) {
+			for (dgInt32 j = 0; j < otherCount; j ++) {
+				if (myNodes[i]->BoxTest (data, otherNodes[j])) {
+					tasks[taskCount].m_myNode = myNodes[i];
+					tasks[taskCount].m_otherNode = otherNodes[j];
+					taskCount ++;
+				}
+			}
+		}
+	} else {
+		dgAssert (otherInstance->IsType (dgCollision::dgCollisionBVH_RTTI));
+		const dgInt32 myCount = GetSubTrees (myNodes, maxTasks);
+		for (dgInt32 i = 0; i < myCount; i ++) {
+			tasks[taskCount].m_myNode = myNodes[i];
+			tasks[taskCount].m_otherNode = NULL;
+			taskCount ++;
+		}
+	}
+	return taskCount;
+}
+
+dgInt32 dgCollisionCompound::CalculateContactsTask (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy, const dgBroadPhase::dgCompoundPairTask& task, dgFloat32& closestDist) const
+{
+	dgAssert (!proxy.m_continueCollision);
+	dgNodeBase* const myNode = (dgNodeBase*) task.m_myNode;
+	if (task.m_otherNode) {
+		return CalculateContactsToCompound (pair, proxy, myNode, (const dgNodeBase*) task.m_otherNode, closestDist);
+	}
+	return CalculateContactsToCollisionTree (pair, proxy, myNode, closestDist);
+}
+
 
 dgInt32 dgCollisionCompound::ClosestDistance (dgCollisionParamProxy& proxy) const
 {
@@ -1753,6 +1909,19 @@ dgInt32 dgCollisionCompound::ClosestDistanceToCompound (dgCollisionParamProxy& p
 
 
 dgInt32 dgCollisionCompound::CalculateContactsToCompound (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy) const
+{
+	dgContact* const contactJoint = pair->m_contact;
+	const dgCollisionInstance* const otherCompoundInstance = contactJoint->GetBody1()->m_collision;
+	dgAssert (otherCompoundInstance->IsType (dgCollision::dgCollisionCompound_RTTI));
+	const dgCollisionCompound* const otherCompound = (dgCollisionCompound*)otherCompoundInstance->GetChildShape();
+
+	dgFloat32 closestDist = dgFloat32 (1.0e10f);
+	dgInt32 contactCount = CalculateContactsToCompound (pair, proxy, m_root, otherCompound->m_root, closestDist);
+	contactJoint->m_closestDistance = closestDist;
+	return contactCount;
+}
+
+dgInt32 dgCollisionCompound::CalculateContactsToCompound (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy, const dgNodeBase* const myRoot, const dgNodeBase* const otherRoot, dgFloat32& closestDist) const
 {
 	dgContactPoint* const contacts = proxy.m_contacts;
 	const dgNodeBase* stackPool[4 * DG_COMPOUND_STACK_DEPTH][2];
@@ -1767,7 +1936,6 @@ dgInt32 dgCollisionCompound::CalculateContactsToCompound (dgBroadPhase::dgPair*
 
 	dgAssert (myCompoundInstance->GetChildShape() == this);
 	dgAssert (otherCompoundInstance->IsType (dgCollision::dgCollisionCompound_RTTI));
-	dgCollisionCompound* const otherCompound = (dgCollisionCompound*)otherCompoundInstance->GetChildShape();
 
 	proxy.m_body0 = myBody;
 	proxy.m_body1 = otherBody;
@@ -1777,14 +1945,13 @@ dgInt32 dgCollisionCompound::CalculateContactsToCompound (dgBroadPhase::dgPair*
 	dgOOBBTestData data (otherMatrix * myMatrix.Inverse());
 
 	dgInt32 stack = 1;
-	stackPool[0][0] = m_root;
-	stackPool[0][1] = otherCompound->m_root;
+	stackPool[0][0] = myRoot;
+	stackPool[0][1] = otherRoot;
 	const dgContactMaterial* const material = contactJoint->GetMaterial();
 
 	dgAssert ((contacts != NULL) ^ proxy.m_intersectionTestOnly);
 
 	dgFloat32 timestep = pair->m_timestep;
-	dgFloat32 closestDist = dgFloat32 (1.0e10f);
 	while (stack) {
 		stack --;
 		const dgNodeBase* const me = stackPool[stack][0];
@@ -1895,7 +2062,6 @@ dgInt32 dgCollisionCompound::CalculateContactsToCompound (dgBroadPhase::dgPair*
 		}
 	}
 
-	contactJoint->m_closestDistance = closestDist;
 	proxy.m_contacts = contacts;
 	return contactCount;
 }
@@ -2211,6 +2377,14 @@ dgInt32 dgCollisionCompound::CalculateContactsToSingle (dgBroadPhase::dgPair* co
 
 
 dgInt32 dgCollisionCompound::CalculateContactsToCollisionTree (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy) const
+{
+	dgFloat32 closestDist = dgFloat32 (1.0e10f);
+	dgInt32 contactCount = CalculateContactsToCollisionTree (pair, proxy, m_root, closestDist);
+	pair->m_contact->m_closestDistance = closestDist;
+	return contactCount;
+}
+
+dgInt32 dgCollisionCompound::CalculateContactsToCollisionTree (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy, dgNodeBase* const myRoot, dgFloat32& closestDist) const
 {
 	dgContactPoint* const contacts = proxy.m_contacts;
 
@@ -2237,7 +2411,7 @@ dgInt32 dgCollisionCompound::CalculateContactsToCollisionTree (dgBroadPhase::dgP
 	dgOOBBTestData data (treeCollisionInstance->GetGlobalMatrix() * myMatrix.Inverse());
 
 	dgInt32 stack = 1;
-	stackPool[0].m_myNode = m_root;
+	stackPool[0].m_myNode = myRoot;
 	stackPool[0].m_treeNode = treeCollision->GetRootNode();
 	stackPool[0].m_treeNodeIsLeaf = 0;
 
@@ -2251,7 +2425,6 @@ dgInt32 dgCollisionCompound::CalculateContactsToCollisionTree (dgBroadPhase::dgP
 	dgAssert ((contacts != NULL) ^ proxy.m_intersectionTestOnly);
 
 	dgFloat32 timestep = pair->m_timestep;
-	dgFloat32 closestDist = dgFloat32 (1.0e10f);
 	while (stack) {
 
 		stack --;
@@ -2439,7 +2612,6 @@ dgInt32 dgCollisionCompound::CalculateContactsToCollisionTree (dgBroadPhase::dgP
 		}
 	}
 
-	contactJoint->m_closestDistance = closestDist;
 	proxy.m_contacts = contacts;	
 	return contactCount;
 }
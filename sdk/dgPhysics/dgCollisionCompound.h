@@ -30,7 +30,9 @@ class dgCollisionBVH;
 class dgCollisionInstance;
 
 
-#define DG_COMPOUND_STACK_DEPTH	256
+#define DG_COMPOUND_STACK_DEPTH			256
+#define DG_COMPOUND_MAX_CONTACT_TASKS	16
+#define DG_COMPOUND_REFIT_COST_RATIO	dgFloat32 (1.5f)
 
 class dgCollisionCompound: public dgCollision
 {
@@ -147,6 +149,11 @@ class dgCollisionCompound: public dgCollision
 	virtual void SetCollisionMatrix (dgTreeArray::dgTreeNode* const node, const dgMatrix& matrix);
 	virtual void EndAddRemove (bool flushCache = true);
 
+	// in refit mode EndAddRemove only recomputes the boxes of the nodes moved since the last update and defers the 
+	// tree optimization until the tree cost grows past DG_COMPOUND_REFIT_COST_RATIO, adds and removes always rebuild
+	void SetRefitMode (bool mode);
+	bool GetRefitMode () const;
+
 	void ApplyScale (const dgVector& scale);
 	void GetAABB (dgVector& p0, dgVector& p1) const;
 
@@ -188,8 +195,10 @@ class dgCollisionCompound: public dgCollision
 	dgInt32 CalculateContactsToSingle (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy) const;
 	dgInt32 CalculateContactsToSingleContinue (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy) const;
 	dgInt32 CalculateContactsToCompound (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy) const;
+	dgInt32 CalculateContactsToCompound (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy, const dgNodeBase* const myRoot, const dgNodeBase* const otherRoot, dgFloat32& closestDist) const;
 	dgInt32 CalculateContactsToCompoundContinue (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy) const;
 	dgInt32 CalculateContactsToCollisionTree (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy) const;
+	dgInt32 CalculateContactsToCollisionTree (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy, dgNodeBase* const myRoot, dgFloat32& closestDist) const;
 	dgInt32 CalculateContactsToCollisionTreeContinue (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy) const;
 	dgInt32 CalculateContactsToHeightField (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy) const;
 	dgInt32 CalculateContactsUserDefinedCollision (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy) const;
@@ -197,6 +206,10 @@ class dgCollisionCompound: public dgCollision
 	dgInt32 ClosestDistanceToConvex (dgCollisionParamProxy& proxy) const;
 	dgInt32 ClosestDistanceToCompound (dgCollisionParamProxy& proxy) const;
 
+	dgInt32 GetSubTrees (const dgNodeBase** const nodes, dgInt32 maxCount) const;
+	dgInt32 BuildContactTasks (dgBroadPhase::dgPair* const pair, dgBroadPhase::dgCompoundPairTask* const tasks, dgInt32 maxTasks) const;
+	dgInt32 CalculateContactsTask (dgBroadPhase::dgPair* const pair, dgCollisionParamProxy& proxy, const dgBroadPhase::dgCompoundPairTask& task, dgFloat32& closestDist) const;
+
 #ifdef _DEBUG
 	dgVector InternalSupportVertex (const dgVector& dir) const;
 #endif
@@ -207,6 +220,7 @@ class dgCollisionCompound: public dgCollision
 	dgFloat64 CalculateEntropy (dgList<dgNodeBase*>& list);
 
 	void ImproveNodeFitness (dgNodeBase* const node) const;
+	bool RefitTree ();
 	DG_INLINE dgFloat32 CalculateSurfaceArea (dgNodeBase* const node0, dgNodeBase* const node1, dgVector& minBox, dgVector& maxBox) const;
 
 	dgInt32 CalculatePlaneIntersection (const dgVector& normal, const dgVector& point, dgVector* const contactsOut) const;
@@ -220,15 +234,22 @@ class dgCollisionCompound: public dgCollision
 	dgNodeBase* m_root;
 	const dgCollisionInstance* m_myInstance;
 	dgTreeArray m_array;
+	dgArray<dgNodeBase*> m_refitNodes;
 	dgFloat64 m_treeEntropy;
+	dgFloat64 m_treeCost;
+	dgFloat64 m_refitBaseCost;
 	dgFloat32 m_boxMinRadius;
 	dgFloat32 m_boxMaxRadius;
 	dgInt32 m_idIndex;
 	dgInt32 m_criticalSectionLock;
+	dgInt32 m_refitNodesCount;
+	bool m_refitMode;
+	bool m_refitTreeChanged;
 
 	static dgVector m_padding;
 	friend class dgBody;
 	friend class dgWorld;
+	friend class dgBroadPhase;
 	friend class dgCollisionScene;
 };
 
@@ -24,6 +24,7 @@
 #include "dgWorld.h"
 #include "dgContact.h"
 #include "dgContactSolver.h"
+#include "dgCollisionMesh.h"
 #include "dgCollisionInstance.h"
 #include "dgCollisionConvexPolygon.h"
 
@@ -500,6 +501,89 @@ dgVector dgCollisionConvexPolygon::CalculateGlobalNormal (const dgCollisionInsta
 	return globalMatrix.RotateVector(normal);
 }
 
+dgInt32 dgCollisionConvexPolygon::CullFacesToConvexHull (dgPolygonMeshDesc& data, const dgCollisionInstance* const parentMesh, const dgMatrix& polySoupScaledMatrix, const dgCollisionInstance* const hull, dgFloat32 skinThickness) const
+{
+	// separating axis test of four faces at a time against the hull obb, using each face normal as the axis.
+	// faces that the hull can not be touching are removed from the batch, so that only the remainder 
+	// pays for setting up the polygon and the full contact calculation.
+	// the test is conservative, it only rejects faces CalculateContactToConvexHullDescrete would also reject.
+	dgVector obbSize;
+	dgVector obbOrigin;
+	hull->CalcObb(obbOrigin, obbSize);
+	const dgMatrix& hullMatrix = hull->m_globalMatrix;
+	const dgVector hullOrigin (hullMatrix.m_posit);
+	const dgVector obbCenter (hullMatrix.TransformVector(obbOrigin & dgVector::m_triplexMask));
+	const dgVector axis0 (hullMatrix[0].Scale(obbSize.m_x));
+	const dgVector axis1 (hullMatrix[1].Scale(obbSize.m_y));
+	const dgVector axis2 (hullMatrix[2].Scale(obbSize.m_z));
+
+	const dgVector& invScale = parentMesh->GetInvScale();
+	const dgMatrix& globalMatrix = parentMesh->m_globalMatrix;
+	const dgMatrix& aligmentMatrix = parentMesh->m_aligmentMatrix;
+	const dgVector skin (skinThickness + dgFloat32 (1.0e-5f));
+
+	const dgInt32 faceCount = data.m_faceCount;
+	const dgInt32* const indexArray = data.m_faceVertexIndex;
+
+	dgInt32 count = 0;
+	for (dgInt32 i = 0; i < faceCount; i += 4) {
+		dgVector normal[4];
+		dgVector origin[4];
+		for (dgInt32 j = 0; j < 4; j ++) {
+			// the last group is padded with copies of the last face
+			const dgInt32 face = dgMin (i + j, faceCount - 1);
+			const dgInt32 indexCount = data.m_faceIndexCount[face];
+			const dgInt32* const localIndexArray = &indexArray[data.m_faceIndexStart[face]];
+			const dgInt32 normalIndex = data.GetNormalIndex(localIndexArray, indexCount);
+			normal[j] = aligmentMatrix.RotateVector(dgVector(&m_vertex[normalIndex * m_stride]) & dgVector::m_triplexMask) * invScale;
+			origin[j] = polySoupScaledMatrix.TransformVector(dgVector(&m_vertex[localIndexArray[0] * m_stride]) & dgVector::m_triplexMask);
+		}
+
+		dgVector nx;
+		dgVector ny;
+		dgVector nz;
+		dgVector nw;
+		dgVector px;
+		dgVector py;
+		dgVector pz;
+		dgVector pw;
+		dgVector::Transpose4x4(nx, ny, nz, nw, normal[0], normal[1], normal[2], normal[3]);
+		dgVector::Transpose4x4(px, py, pz, pw, origin[0], origin[1], origin[2], origin[3]);
+
+		const dgVector invMag ((nx * nx + ny * ny + nz * nz).InvSqrt());
+		nx = nx * invMag;
+		ny = ny * invMag;
+		nz = nz * invMag;
+
+		const dgVector gx (dgVector (globalMatrix[0][0]) * nx + dgVector (globalMatrix[1][0]) * ny + dgVector (globalMatrix[2][0]) * nz);
+		const dgVector gy (dgVector (globalMatrix[0][1]) * nx + dgVector (globalMatrix[1][1]) * ny + dgVector (globalMatrix[2][1]) * nz);
+		const dgVector gz (dgVector (globalMatrix[0][2]) * nx + dgVector (globalMatrix[1][2]) * ny + dgVector (globalMatrix[2][2]) * nz);
+
+		const dgVector shapeSide (gx * (dgVector (hullOrigin.m_x) - px) + gy * (dgVector (hullOrigin.m_y) - py) + gz * (dgVector (hullOrigin.m_z) - pz));
+		const dgVector centerDist (gx * (dgVector (obbCenter.m_x) - px) + gy * (dgVector (obbCenter.m_y) - py) + gz * (dgVector (obbCenter.m_z) - pz));
+		const dgVector radius ((gx * dgVector (axis0.m_x) + gy * dgVector (axis0.m_y) + gz * dgVector (axis0.m_z)).Abs() + 
+							   (gx * dgVector (axis1.m_x) + gy * dgVector (axis1.m_y) + gz * dgVector (axis1.m_z)).Abs() + 
+							   (gx * dgVector (axis2.m_x) + gy * dgVector (axis2.m_y) + gz * dgVector (axis2.m_z)).Abs());
+
+		const dgVector separated ((shapeSide < dgVector::m_zero) | ((centerDist - radius) > skin));
+		const dgInt32 mask = separated.GetSignMask();
+		const dgInt32 groupCount = dgMin (faceCount - i, 4);
+		for (dgInt32 j = 0; j < groupCount; j ++) {
+			if (!(mask & (1 << j))) {
+				const dgInt32 face = i + j;
+				dgAssert (count <= face);
+				data.m_faceIndexStart[count] = data.m_faceIndexStart[face];
+				data.m_faceIndexCount[count] = data.m_faceIndexCount[face];
+				data.m_hitDistance[count] = data.m_hitDistance[face];
+				count ++;
+			}
+		}
+	}
+
+	data.m_faceCount = count;
+	return count;
+}
+
 dgInt32 dgCollisionConvexPolygon::CalculateContactToConvexHullContinue(const dgWorld* const world, const dgCollisionInstance* const parentMesh, dgCollisionParamProxy& proxy)
 {
 	dgAssert(proxy.m_instance0->IsType(dgCollision::dgCollisionConvexShape_RTTI));
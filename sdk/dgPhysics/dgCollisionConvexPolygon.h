@@ -27,6 +27,8 @@
 
 #define DG_CONVEX_POLYGON_MAX_VERTEX_COUNT	64
 
+class dgPolygonMeshDesc;
+
 DG_MSC_VECTOR_ALIGMENT 
 class dgCollisionConvexPolygon: public dgCollisionConvex	
 {
@@ -59,6 +61,7 @@ class dgCollisionConvexPolygon: public dgCollisionConvex
 	
 	bool BeamClipping (const dgVector& origin, dgFloat32 size, const dgCollisionInstance* const parentMesh);
 	dgVector CalculateGlobalNormal (const dgCollisionInstance* const parentMesh, const dgVector& localNormal) const;
+	dgInt32 CullFacesToConvexHull (dgPolygonMeshDesc& data, const dgCollisionInstance* const parentMesh, const dgMatrix& polySoupScaledMatrix, const dgCollisionInstance* const hull, dgFloat32 skinThickness) const;
 	dgInt32 CalculateContactToConvexHullDescrete(const dgWorld* const world, const dgCollisionInstance* const parentMesh, dgCollisionParamProxy& proxy);
 	dgInt32 CalculateContactToConvexHullContinue (const dgWorld* const world, const dgCollisionInstance* const parentMesh, dgCollisionParamProxy& proxy);
 
@@ -27,6 +27,11 @@
 
 #define DG_HIGHTFIELD_DATA_ID 0x45AF5E07
 
+// cells per side of the tiles used when streaming faces to the contact solver, 
+// tiles are read with a one cell margin so that edge normals match across tile seams, 
+// each cell emits two faces so a tile plus its margin must fit in one face batch 
+#define DG_HIGHTFIELD_STREAM_TILE_SIZE	13
+
 dgVector dgCollisionHeightField::m_yMask (0xffffffff, 0, 0xffffffff, 0);
 dgVector dgCollisionHeightField::m_padding (dgFloat32 (0.25f), dgFloat32 (0.25f), dgFloat32 (0.25f), dgFloat32 (0.0f));
 dgVector dgCollisionHeightField::m_elevationPadding (dgFloat32 (0.0f), dgFloat32 (1.0e10f), dgFloat32 (0.0f), dgFloat32 (0.0f));
@@ -884,8 +889,6 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 	dgVector boxP0;
 	dgVector boxP1;
 
-	dgWorld* const world = data->m_objBody->GetWorld();
-
 	// the user data is the pointer to the collision geometry
 	CalculateMinExtend3d (data->m_p0, data->m_p1, boxP0, boxP1);
 	boxP0 += data->m_boxDistanceTravelInMeshSpace & (data->m_boxDistanceTravelInMeshSpace < dgVector::m_zero);  
@@ -910,6 +913,31 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 	dgInt32 z1 = dgInt32 (p1.m_iz);
 
 	data->m_separationDistance = dgFloat32 (0.0f);
+	dgInt32 cellCount = (x1 - x0) * (z1 - z0);
+	if (!data->CanStreamFaces() || ((cellCount * 2) < DG_MAX_COLLIDING_FACES)) {
+		GetCollidingFaces (data, boxP0, boxP1, x0, x1, z0, z1, x0, x1, z0, z1);
+	} else {
+		// the box overlaps more cells than one batch can hold, visit the grid in tiles and 
+		// hand each tile to the contact solver before collecting the next one.
+		// the last tile is left in the descriptor for the caller.
+		for (dgInt32 z = z0; z < z1; z += DG_HIGHTFIELD_STREAM_TILE_SIZE) {
+			const dgInt32 zMax = dgMin (z + DG_HIGHTFIELD_STREAM_TILE_SIZE, z1);
+			for (dgInt32 x = x0; x < x1; x += DG_HIGHTFIELD_STREAM_TILE_SIZE) {
+				if (!data->FlushFaceBatch()) {
+					return;
+				}
+				// the margin cells are only used for the edge normals, their faces are not emitted
+				const dgInt32 xMax = dgMin (x + DG_HIGHTFIELD_STREAM_TILE_SIZE, x1);
+				GetCollidingFaces (data, boxP0, boxP1, dgMax (x - 1, x0), dgMin (xMax + 1, x1), dgMax (z - 1, z0), dgMin (zMax + 1, z1), x, xMax, z, zMax);
+			}
+		}
+	}
+}
+
+void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data, const dgVector& boxP0, const dgVector& boxP1, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, dgInt32 emitX0, dgInt32 emitX1, dgInt32 emitZ0, dgInt32 emitZ1) const
+{
+	dgWorld* const world = data->m_objBody->GetWorld();
+
 	dgFloat32 minHeight = dgFloat32 (1.0e10f);
 	dgFloat32 maxHeight = dgFloat32 (-1.0e10f);
 //	dgInt32 base = z0 * m_width;
@@ -1139,6 +1167,13 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 		if (data->m_doContinuesCollisionTest) {
 			dgFastRayTest ray (dgVector (dgFloat32 (0.0f)), data->m_boxDistanceTravelInMeshSpace);
 			for (dgInt32 i = 0; i < faceCount; i ++) {
+				const dgInt32 cell = i >> 1;
+				const dgInt32 cellX = x0 + cell % (x1 - x0);
+				const dgInt32 cellZ = z0 + cell / (x1 - x0);
+				if ((cellX < emitX0) || (cellX >= emitX1) || (cellZ < emitZ0) || (cellZ >= emitZ1)) {
+					faceIndexCount1 += 9;
+					continue;
+				}
 				const dgInt32* const indexArray = &indices[faceIndexCount1]; 
 				const dgVector& faceNormal = vertex[indexArray[4]];
 				dgFloat32 dist = data->PolygonBoxRayDistance (faceNormal, 3, indexArray, stride, &vertex[0].m_x, ray);
@@ -1153,6 +1188,13 @@ void dgCollisionHeightField::GetCollidingFaces (dgPolygonMeshDesc* const data) c
 			}
 		} else {
 			for (dgInt32 i = 0; i < faceCount; i ++) {
+				const dgInt32 cell = i >> 1;
+				const dgInt32 cellX = x0 + cell % (x1 - x0);
+				const dgInt32 cellZ = z0 + cell / (x1 - x0);
+				if ((cellX < emitX0) || (cellX >= emitX1) || (cellZ < emitZ0) || (cellZ >= emitZ1)) {
+					faceIndexCount1 += 9;
+					continue;
+				}
 				const dgInt32* const indexArray = &indices[faceIndexCount1]; 
 				const dgVector& faceNormal = vertex[indexArray[4]];
 				dgFloat32 dist = data->PolygonBoxDistance (faceNormal, 3, indexArray, stride, &vertex[0].m_x);
@@ -82,6 +82,7 @@ class dgCollisionHeightField: public dgCollisionMesh
 	virtual void Serialize(dgSerialize callback, void* const userData) const;
 	virtual dgFloat32 RayCast (const dgVector& localP0, const dgVector& localP1, dgFloat32 maxT, dgContactPoint& contactOut, const dgBody* const body, void* const userData, OnRayPrecastAction preFilter) const;
 	virtual void GetCollidingFaces (dgPolygonMeshDesc* const data) const;
+	void GetCollidingFaces (dgPolygonMeshDesc* const data, const dgVector& boxP0, const dgVector& boxP1, dgInt32 x0, dgInt32 x1, dgInt32 z0, dgInt32 z1, dgInt32 emitX0, dgInt32 emitX1, dgInt32 emitZ0, dgInt32 emitZ1) const;
 
 	virtual void GetCollisionInfo(dgCollisionInfo* const info) const;
 	virtual dgVector SupportVertex (const dgVector& dir, dgInt32* const vertexIndex) const;
@@ -48,6 +48,13 @@ dgPolygonMeshDesc::dgPolygonMeshDesc(dgCollisionParamProxy& proxy, void* const u
 	,m_faceVertexIndex(NULL)
 	,m_faceIndexStart(NULL)
 	,m_hitDistance(NULL)
+	,m_me(NULL)
+	,m_batchCallback(NULL)
+	,m_batchContext(NULL)
+	,m_batchCount(0)
+	,m_batchContactCount(0)
+	,m_globalIndexCount(0)
+	,m_batchTimestep(proxy.m_timestep)
 	,m_maxT(dgFloat32 (1.0f))
 	,m_doContinuesCollisionTest(proxy.m_continueCollision)
 {
@@ -188,6 +195,21 @@ void dgPolygonMeshDesc::SortFaceArray ()
 }
 
 
+bool dgPolygonMeshDesc::FlushFaceBatch ()
+{
+	// hand the faces collected so far to the consumer and recycle the buffers, 
+	// this keeps the memory bounded no matter how many faces the shape overlaps.
+	bool continueSearch = true;
+	if (m_faceCount) {
+		dgAssert (m_batchCallback);
+		continueSearch = m_batchCallback (this);
+		m_batchCount ++;
+	}
+	m_faceCount = 0;
+	m_globalIndexCount = 0;
+	return continueSearch;
+}
+
 dgCollisionMesh::dgCollisionMesh(dgWorld* const world, dgCollisionID type)
 	:dgCollision(world->GetAllocator(), 0, type)
 {
@@ -33,6 +33,12 @@
 
 
 class dgCollisionMesh;
+class dgPolygonMeshDesc;
+
+// called by the mesh when the face buffer is full, the faces are consumed and the buffer is reset. 
+// returning false stops the face search.
+typedef bool (*dgPolygonMeshFaceBatchCallback) (dgPolygonMeshDesc* const data);
+
 typedef void (*dgCollisionMeshCollisionCallback) (const dgBody* const bodyWithTreeCollision, const dgBody* const body, dgInt32 faceID, 
 												  dgInt32 vertexCount, const dgFloat32* const vertex, dgInt32 vertexStrideInBytes); 
 
@@ -53,6 +59,11 @@ class dgPolygonMeshDesc: public dgFastAABBInfo
 	DG_INLINE dgPolygonMeshDesc()
 		:dgFastAABBInfo()
 		,m_boxDistanceTravelInMeshSpace(dgFloat32 (0.0f))
+		,m_batchCallback(NULL)
+		,m_batchContext(NULL)
+		,m_batchCount(0)
+		,m_batchContactCount(0)
+		,m_batchTimestep(dgFloat32 (0.0f))
 		,m_maxT(dgFloat32 (1.0f))
 		,m_doContinuesCollisionTest(false)
 	{
@@ -100,7 +111,18 @@ class dgPolygonMeshDesc: public dgFastAABBInfo
 	}
 
 
+	DG_INLINE bool CanStreamFaces () const
+	{
+		return m_batchCallback ? true : false;
+	}
+
+	DG_INLINE bool HasRoomForFace (dgInt32 indexCount) const
+	{
+		return (m_faceCount < DG_MAX_COLLIDING_FACES) && ((m_globalIndexCount + GetFaceIndexCount(indexCount)) < DG_MAX_COLLIDING_INDICES);
+	}
+
 	void SortFaceArray ();
+	bool FlushFaceBatch ();
 
 	dgVector m_boxDistanceTravelInMeshSpace;
 	dgInt32 m_threadNumber;
@@ -120,7 +142,13 @@ class dgPolygonMeshDesc: public dgFastAABBInfo
 	dgInt32* m_faceIndexStart;
 	dgFloat32* m_hitDistance;
 	const dgCollisionMesh* m_me;
+	dgPolygonMeshFaceBatchCallback m_batchCallback;
+	void* m_batchContext;
+	dgInt32 m_batchCount;
+	dgInt32 m_batchContactCount;
 	dgInt32 m_globalIndexCount;
+	// the full time step of the sweep, face hit distances stay relative to it while batches shorten the proxy step
+	dgFloat32 m_batchTimestep;
 	dgFloat32 m_maxT;
 	bool m_doContinuesCollisionTest;
 	dgInt32 m_globalFaceVertexIndex[DG_MAX_COLLIDING_INDICES];
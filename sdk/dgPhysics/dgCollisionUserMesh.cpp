@@ -137,6 +137,35 @@ dgVector dgCollisionUserMesh::SupportVertexSpecial (const dgVector& dir, dgFloat
 	return dgVector::m_zero;
 }
 
+void dgCollisionUserMesh::ReportDebugFaces(const dgPolygonMeshDesc* const data) const
+{
+	// called for every batch handed to the contact solver, not only for the last one
+	if (GetDebugCollisionCallback()) {
+		dgTriplex triplex[32];
+		const dgInt32 stride = data->m_vertexStrideInBytes / sizeof(dgFloat32);
+		const dgFloat32* const vertex = data->m_vertex;
+		const dgVector scale = data->m_polySoupInstance->GetScale();
+		dgMatrix matrix(data->m_polySoupInstance->GetLocalMatrix() * data->m_polySoupBody->GetMatrix());
+
+		for (dgInt32 i = 0; i < data->m_faceCount; i++) {
+			dgInt32 base = data->m_faceIndexStart[i];
+			dgInt32 indexCount = data->m_faceIndexCount[i];
+			const dgInt32* const vertexFaceIndex = &data->m_faceVertexIndex[base];
+			for (dgInt32 j = 0; j < indexCount; j++) {
+				dgInt32 index = vertexFaceIndex[j];
+				dgVector q(&vertex[index * stride]);
+				q = q & dgVector::m_triplexMask;
+				dgVector p(matrix.TransformVector(scale * q));
+				triplex[j].m_x = p.m_x;
+				triplex[j].m_y = p.m_y;
+				triplex[j].m_z = p.m_z;
+			}
+			dgInt32 faceId = data->GetFaceId(vertexFaceIndex, indexCount);
+			GetDebugCollisionCallback() (data->m_polySoupBody, data->m_objBody, faceId, indexCount, &triplex[0].m_x, sizeof(dgTriplex));
+		}
+	}
+}
+
 void dgCollisionUserMesh::GetCollidingFacesContinue(dgPolygonMeshDesc* const data) const
 {
 	data->m_me = this;
@@ -158,9 +187,27 @@ void dgCollisionUserMesh::GetCollidingFacesContinue(dgPolygonMeshDesc* const dat
 	dgInt32* const dstIndices = data->m_globalFaceVertexIndex;
 	dgInt32* const faceIndexCountArray = data->m_faceIndexCount;
 
-	for (dgInt32 i = 0; (i < data->m_faceCount) && (faceIndexCount0 < (DG_MAX_COLLIDING_INDICES - 32)); i++) {
+	const dgInt32 userFaceCount = data->m_faceCount;
+	for (dgInt32 i = 0; i < userFaceCount; i++) {
 		dgInt32 indexCount = faceIndexCountArray[i];
 		const dgInt32* const indexArray = &srcIndices[faceIndexCount1];
+		if (faceIndexCount0 >= (DG_MAX_COLLIDING_INDICES - 32)) {
+			if (!data->CanStreamFaces()) {
+				break;
+			}
+			data->m_faceCount = faceCount0;
+			data->m_faceIndexStart = address;
+			data->m_hitDistance = hitDistance;
+			data->m_faceVertexIndex = dstIndices;
+			ReportDebugFaces(data);
+			bool continueSearch = data->FlushFaceBatch();
+			data->m_faceVertexIndex = (dgInt32*)srcIndices;
+			faceCount0 = 0;
+			faceIndexCount0 = 0;
+			if (!continueSearch) {
+				break;
+			}
+		}
 
 		dgInt32 normalIndex = data->GetNormalIndex(indexArray, indexCount);
 		dgVector faceNormal(&vertex[normalIndex * stride]);
@@ -186,30 +233,7 @@ void dgCollisionUserMesh::GetCollidingFacesContinue(dgPolygonMeshDesc* const dat
 		data->m_hitDistance = hitDistance;
 		data->m_faceVertexIndex = dstIndices;
 
-		if (GetDebugCollisionCallback()) {
-			dgTriplex triplex[32];
-			//const dgMatrix& matrix = data->m_polySoupInstance->GetGlobalMatrix();
-			const dgVector scale = data->m_polySoupInstance->GetScale();
-			dgMatrix matrix(data->m_polySoupInstance->GetLocalMatrix() * data->m_polySoupBody->GetMatrix());
-
-			for (dgInt32 i = 0; i < data->m_faceCount; i++) {
-				dgInt32 base = address[i];
-				dgInt32 indexCount = faceIndexCountArray[i];
-				const dgInt32* const vertexFaceIndex = &data->m_faceVertexIndex[base];
-				for (dgInt32 j = 0; j < indexCount; j++) {
-					dgInt32 index = vertexFaceIndex[j];
-					dgVector q(&vertex[index * stride]);
-					q = q & dgVector::m_triplexMask;
-					//dgVector p(matrix.TransformVector(scale * dgVector(&vertex[index * stride])));
-					dgVector p(matrix.TransformVector(scale * q));
-					triplex[j].m_x = p.m_x;
-					triplex[j].m_y = p.m_y;
-					triplex[j].m_z = p.m_z;
-				}
-				dgInt32 faceId = data->GetFaceId(vertexFaceIndex, indexCount);
-				GetDebugCollisionCallback() (data->m_polySoupBody, data->m_objBody, faceId, indexCount, &triplex[0].m_x, sizeof(dgTriplex));
-			}
-		}
+		ReportDebugFaces(data);
 	}
 }
 
@@ -233,9 +257,27 @@ void dgCollisionUserMesh::GetCollidingFacesDescrete(dgPolygonMeshDesc* const dat
 	dgInt32* const dstIndices = data->m_globalFaceVertexIndex;
 	dgInt32* const faceIndexCountArray = data->m_faceIndexCount;
 
-	for (dgInt32 i = 0; (i < data->m_faceCount) && (faceIndexCount0 < (DG_MAX_COLLIDING_INDICES - 32)); i++) {
+	const dgInt32 userFaceCount = data->m_faceCount;
+	for (dgInt32 i = 0; i < userFaceCount; i++) {
 		dgInt32 indexCount = faceIndexCountArray[i];
 		const dgInt32* const indexArray = &srcIndices[faceIndexCount1];
+		if (faceIndexCount0 >= (DG_MAX_COLLIDING_INDICES - 32)) {
+			if (!data->CanStreamFaces()) {
+				break;
+			}
+			data->m_faceCount = faceCount0;
+			data->m_faceIndexStart = address;
+			data->m_hitDistance = hitDistance;
+			data->m_faceVertexIndex = dstIndices;
+			ReportDebugFaces(data);
+			bool continueSearch = data->FlushFaceBatch();
+			data->m_faceVertexIndex = (dgInt32*)srcIndices;
+			faceCount0 = 0;
+			faceIndexCount0 = 0;
+			if (!continueSearch) {
+				break;
+			}
+		}
 
 		dgInt32 normalIndex = data->GetNormalIndex(indexArray, indexCount);
 		dgVector faceNormal(&vertex[normalIndex * stride]);
@@ -261,30 +303,7 @@ void dgCollisionUserMesh::GetCollidingFacesDescrete(dgPolygonMeshDesc* const dat
 		data->m_hitDistance = hitDistance;
 		data->m_faceVertexIndex = dstIndices;
 
-		if (GetDebugCollisionCallback()) {
-			dgTriplex triplex[32];
-			//const dgMatrix& matrix = data->m_polySoupInstance->GetGlobalMatrix();
-			const dgVector scale = data->m_polySoupInstance->GetScale();
-			dgMatrix matrix(data->m_polySoupInstance->GetLocalMatrix() * data->m_polySoupBody->GetMatrix());
-
-			for (dgInt32 i = 0; i < data->m_faceCount; i++) {
-				dgInt32 base = address[i];
-				dgInt32 indexCount = faceIndexCountArray[i];
-				const dgInt32* const vertexFaceIndex = &data->m_faceVertexIndex[base];
-				for (dgInt32 j = 0; j < indexCount; j++) {
-					dgInt32 index = vertexFaceIndex[j];
-					dgVector q(&vertex[index * stride]);
-					q = q & dgVector::m_triplexMask; 
-					//dgVector p(matrix.TransformVector(scale * dgVector(&vertex[index * stride])));
-					dgVector p(matrix.TransformVector(scale * q));
-					triplex[j].m_x = p.m_x;
-					triplex[j].m_y = p.m_y;
-					triplex[j].m_z = p.m_z;
-				}
-				dgInt32 faceId = data->GetFaceId(vertexFaceIndex, indexCount);
-				GetDebugCollisionCallback() (data->m_polySoupBody, data->m_objBody, faceId, indexCount, &triplex[0].m_x, sizeof(dgTriplex));
-			}
-		}
+		ReportDebugFaces(data);
 	}
 }
 
@@ -60,6 +60,7 @@ class dgCollisionUserMesh: public dgCollisionMesh
 
 	void GetCollidingFacesContinue(dgPolygonMeshDesc* const data) const;
 	void GetCollidingFacesDescrete(dgPolygonMeshDesc* const data) const;
+	void ReportDebugFaces(const dgPolygonMeshDesc* const data) const;
 
 	void* m_userData;
 	OnUserMeshSerialize m_serializeCallback;
@@ -76,10 +76,13 @@ dgContact::dgContact(dgWorld* const world, const dgContactMaterial* const materi
 	,m_impulseSpeed (dgFloat32 (0.0f))
 	,m_contactPruningTolereance(world->GetContactMergeTolerance())
 	,m_broadphaseLru(0)
+	,m_aabbOverlapLru(0)
 	,m_killContact(0)
 	,m_isNewContact(1)
 	,m_skeletonIntraCollision(1)
 	,m_skeletonSelftCollision(1)
+	,m_isScratch(0)
+	,m_aabbOverlapAccepted(0)
 {
 	dgAssert ((((dgUnsigned64) this) & 15) == 0);
 	m_maxDOF = 0;
@@ -113,10 +116,13 @@ dgContact::dgContact(dgContact* const clone)
 	,m_impulseSpeed (clone->m_impulseSpeed)
 	,m_contactPruningTolereance(clone->m_contactPruningTolereance)
 	,m_broadphaseLru(clone->m_broadphaseLru)
+	,m_aabbOverlapLru(clone->m_aabbOverlapLru)
 	,m_killContact(clone->m_killContact)
 	,m_isNewContact(clone->m_isNewContact)
 	,m_skeletonIntraCollision(clone->m_skeletonIntraCollision)
 	,m_skeletonSelftCollision(clone->m_skeletonSelftCollision)
+	,m_isScratch(0)
+	,m_aabbOverlapAccepted(clone->m_aabbOverlapAccepted)
 {
 	dgAssert((((dgUnsigned64) this) & 15) == 0);
 	m_body0 = clone->m_body0;
@@ -133,10 +139,41 @@ dgContact::dgContact(dgContact* const clone)
 	}
 }
 
+// narrow phase scratch joint, it is never attached to the bodies and the user callbacks never see it
+dgContact::dgContact(dgMemoryAllocator* const allocator)
+	:dgConstraint()
+	,dgList<dgContactMaterial>(allocator)
+	,m_positAcc(dgFloat32 (10.0f))
+	,m_rotationAcc ()
+	,m_separtingVector (dgVector::m_zero)
+	,m_material(NULL)
+	,m_closestDistance (dgFloat32 (0.0f))
+	,m_separationDistance(dgFloat32 (0.0f))
+	,m_timeOfImpact(dgFloat32 (1.0e10f))
+	,m_impulseSpeed (dgFloat32 (0.0f))
+	,m_contactPruningTolereance(dgFloat32 (0.0f))
+	,m_broadphaseLru(0)
+	,m_aabbOverlapLru(0)
+	,m_killContact(0)
+	,m_isNewContact(1)
+	,m_skeletonIntraCollision(1)
+	,m_skeletonSelftCollision(1)
+	,m_isScratch(1)
+	,m_aabbOverlapAccepted(0)
+{
+	dgAssert ((((dgUnsigned64) this) & 15) == 0);
+	m_maxDOF = 0;
+	m_isActive = 0;
+	m_enableCollision = true;
+	m_constId = m_contactConstraint;
+	m_body0 = NULL;
+	m_body1 = NULL;
+}
+
 dgContact::~dgContact()
 {
-	dgAssert(m_body0);
-	if (m_body0->m_world && m_body0->m_world->m_onDestroyContact) {
+	dgAssert(m_body0 || m_isScratch);
+	if (!m_isScratch && m_body0->m_world && m_body0->m_world->m_onDestroyContact) {
 		m_body0->m_world->m_onDestroyContact(m_body0->m_world, this);
 	}
 
@@ -150,6 +187,20 @@ void dgContact::SwapBodies()
 	dgSwap (m_link0, m_link1);
 }
 
+void dgContact::CopyCollisionState(const dgContact* const source)
+{
+	dgAssert (m_isScratch);
+	m_body0 = source->m_body0;
+	m_body1 = source->m_body1;
+	m_material = source->m_material;
+	m_separtingVector = source->m_separtingVector;
+	m_closestDistance = source->m_closestDistance;
+	m_separationDistance = source->m_separationDistance;
+	m_contactPruningTolereance = source->m_contactPruningTolereance;
+	m_isNewContact = source->m_isNewContact;
+	m_isActive = source->m_isActive;
+}
+
 void dgContact::GetInfo (dgConstraintInfo* const info) const
 {
 	memset (info, 0, sizeof (dgConstraintInfo));
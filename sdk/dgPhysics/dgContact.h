@@ -212,6 +212,7 @@ class dgContact: public dgConstraint, public dgList<dgContactMaterial>
 	protected:
 	dgContact(dgContact* const clone);
 	dgContact(dgWorld* const world, const dgContactMaterial* const material, dgBody* const body0, dgBody* const body1);
+	dgContact(dgMemoryAllocator* const allocator);
 	virtual ~dgContact();
 
 	DG_CLASS_ALLOCATOR(allocator)
@@ -233,6 +234,7 @@ class dgContact: public dgConstraint, public dgList<dgContactMaterial>
 	void CalculatePointDerivative (dgInt32 index, dgContraintDescritor& desc, const dgVector& dir, const dgPointParam& param) const;
 
 	void SwapBodies();
+	void CopyCollisionState(const dgContact* const source);
 
 	dgVector m_positAcc;
 	dgQuaternion m_rotationAcc;
@@ -244,10 +246,13 @@ class dgContact: public dgConstraint, public dgList<dgContactMaterial>
 	dgFloat32 m_impulseSpeed;
 	dgFloat32 m_contactPruningTolereance;
 	dgUnsigned32 m_broadphaseLru;
+	dgUnsigned32 m_aabbOverlapLru;
 	dgUnsigned32 m_killContact				: 1;
 	dgUnsigned32 m_isNewContact				: 1;
 	dgUnsigned32 m_skeletonIntraCollision	: 1;
 	dgUnsigned32 m_skeletonSelftCollision	: 1;
+	dgUnsigned32 m_isScratch				: 1;
+	dgUnsigned32 m_aabbOverlapAccepted		: 1;
 
     friend class dgBody;
 	friend class dgWorld;
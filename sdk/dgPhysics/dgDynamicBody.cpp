@@ -120,6 +120,7 @@ dgDynamicBody::dgDynamicBody()
 	,m_cachedTimeStep(dgFloat32(0.0f))
 	,m_sleepingCounter(0)
 	,m_isInDestructionArrayLRU(0)
+	,m_skeletonLod(0)
 	,m_skeleton(NULL)
 	,m_applyExtForces(NULL)
 {
@@ -139,6 +140,7 @@ dgDynamicBody::dgDynamicBody (dgWorld* const world, const dgTree<const dgCollisi
 	,m_cachedTimeStep(dgFloat32(0.0f))
 	,m_sleepingCounter(0)
 	,m_isInDestructionArrayLRU(0)
+	,m_skeletonLod(0)
 	,m_skeleton(NULL)
 	,m_applyExtForces(NULL)
 {
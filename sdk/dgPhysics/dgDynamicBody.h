@@ -80,6 +80,8 @@ class dgDynamicBody : public dgBody
 
 	virtual dgSkeletonContainer* GetSkeleton() const;
 	void SetSkeleton(dgSkeletonContainer* const skeleton);
+	dgInt32 GetSkeletonLod() const;
+	void SetSkeletonLod(dgInt32 lod);
 
 	void IntegrateImplicit(dgFloat32 timeStep);
 	virtual void IntegrateOpenLoopExternalForce(dgFloat32 timeStep);
@@ -104,6 +106,7 @@ class dgDynamicBody : public dgBody
 	dgFloat32 m_cachedTimeStep;
 	dgInt32 m_sleepingCounter;
 	dgUnsigned32 m_isInDestructionArrayLRU;
+	dgInt32 m_skeletonLod;
 	dgSkeletonContainer* m_skeleton;
 	OnApplyExtForceAndTorque m_applyExtForces;
 	static dgVector m_equilibriumError2;
@@ -234,6 +237,16 @@ DG_INLINE dgSkeletonContainer* dgDynamicBody::GetSkeleton() const
 	return m_skeleton;
 }
 
+DG_INLINE dgInt32 dgDynamicBody::GetSkeletonLod() const
+{
+	return m_skeletonLod;
+}
+
+DG_INLINE void dgDynamicBody::SetSkeletonLod(dgInt32 lod)
+{
+	m_skeletonLod = lod;
+}
+
 DG_INLINE void dgDynamicBody::SetSkeleton(dgSkeletonContainer* const skeleton)
 {
 	dgAssert (!(m_skeleton && skeleton));
@@ -408,6 +408,15 @@ class dgInverseDynamics::dgNode
 
 dgInt64 dgInverseDynamics::dgNode::m_ordinalInit = 0x050403020100ll;
 
+class dgInverseDynamics::dgBatchDescriptor
+{
+	public:
+	dgInverseDynamics** m_array;
+	dgFloat32 m_timestep;
+	dgInt32 m_count;
+	dgInt32 m_atomicIndex;
+};
+
 
 dgInverseDynamics::dgInverseDynamics(dgWorld* const world)
 	:m_world(world)
@@ -1364,4 +1373,68 @@ dgTrace(("\n"));
 
 		CalculateMotorsAccelerations (internalForce, jointInfoArray, matrixRow, timestep);
 	}
-}
\ No newline at end of file
+}
+
+bool dgInverseDynamics::HasSameTopology(const dgInverseDynamics* const other) const
+{
+	if (!m_nodesOrder || !other->m_nodesOrder) {
+		return m_nodesOrder == other->m_nodesOrder;
+	}
+	if ((m_nodeCount != other->m_nodeCount) || (m_loopingJoints.GetCount() != other->m_loopingJoints.GetCount())) {
+		return false;
+	}
+	for (dgInt32 i = 0; i < m_nodeCount - 1; i++) {
+		if (m_nodesOrder[i]->m_parent->m_index != other->m_nodesOrder[i]->m_parent->m_index) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void dgInverseDynamics::UpdateBatchKernel(void* const context, void* const, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgBatchDescriptor* const descriptor = (dgBatchDescriptor*)context;
+	const dgInt32 count = descriptor->m_count;
+	const dgFloat32 timestep = descriptor->m_timestep;
+	dgInverseDynamics** const array = descriptor->m_array;
+
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, 1)) {
+		array[i]->Update(timestep, threadID);
+	}
+}
+
+// the batch is only parallel across models, each model keeps its own solve
+void dgInverseDynamics::UpdateBatch(dgInverseDynamics** const array, dgInt32 count, dgFloat32 timestep)
+{
+	if (!count) {
+		return;
+	}
+
+	dgWorld* const world = array[0]->m_world;
+	dgAssert(!world->IsWorkerThread());
+	const dgInt32 threadCount = world->GetThreadCount();
+	if ((threadCount <= 1) || (count <= 1)) {
+		for (dgInt32 i = 0; i < count; i++) {
+			array[i]->Update(timestep, 0);
+		}
+		return;
+	}
+
+#ifdef _DEBUG
+	for (dgInt32 i = 1; i < count; i++) {
+		dgAssert(array[i]->m_world == world);
+		dgAssert(array[i]->HasSameTopology(array[0]));
+	}
+#endif
+
+	dgBatchDescriptor descriptor;
+	descriptor.m_array = array;
+	descriptor.m_timestep = timestep;
+	descriptor.m_count = count;
+	descriptor.m_atomicIndex = 0;
+	for (dgInt32 i = 0; i < threadCount; i++) {
+		world->QueueJob(UpdateBatchKernel, &descriptor, NULL, "dgInverseDynamics::UpdateBatch");
+	}
+	world->SynchronizationBarrier();
+}
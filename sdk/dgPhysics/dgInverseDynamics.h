@@ -78,8 +78,13 @@ class dgInverseDynamics
 	dgNode* GetNextSiblingChild (dgNode* const sibling) const;
 
 	void Update (dgFloat32 timestep, dgInt32 threadIndex);
+	bool HasSameTopology (const dgInverseDynamics* const other) const;
+	static void UpdateBatch (dgInverseDynamics** const array, dgInt32 count, dgFloat32 timestep);
 	
 	private:
+	class dgBatchDescriptor;
+	static void UpdateBatchKernel (void* const context, void* const, dgInt32 threadID);
+
 	bool SanityCheck(const dgForcePair* const force, const dgForcePair* const accel) const;
 	
 	DG_INLINE void CalculateOpenLoopForce (dgForcePair* const force, const dgForcePair* const accel) const;
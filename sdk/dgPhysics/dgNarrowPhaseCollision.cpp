@@ -2141,22 +2141,27 @@ dgInt32 dgWorld::CalculateConvexToNonConvexContacts(dgCollisionParamProxy& proxy
 			}
 		}
 
+		// faces are consumed in batches as the mesh finds them, so that large shapes or long 
+		// sweeps over dense meshes do not overflow the face buffers
+		proxy.m_polyMeshData = &data;
+		data.m_batchCallback = OnPolySoupFaceBatch;
+		data.m_batchContext = &proxy;
+
 		dgCollisionMesh* const polysoup = (dgCollisionMesh *)data.m_polySoupInstance->GetChildShape();
 		polysoup->GetCollidingFaces(&data);
+		data.FlushFaceBatch();
 
-		if (data.m_faceCount) {
-			proxy.m_polyMeshData = &data;
-
-			if (proxy.m_continueCollision) {
-				count = CalculateConvexToNonConvexContactsContinue(proxy);
-			} else {
-				count = CalculatePolySoupToHullContactsDescrete(proxy);
+		if (data.m_batchCount) {
+			count = data.m_batchContactCount;
+			if (!proxy.m_continueCollision && (count > 0)) {
+				ValidatePolySoupContactNormals(proxy, count);
 			}
 
 			if (count > 0) {
 				proxy.m_contactJoint->m_isActive = 1;
 			}
 		}
+		proxy.m_polyMeshData = NULL;
 
 		proxy.m_closestPointBody0 += origin;
 		proxy.m_closestPointBody1 += origin;
@@ -2194,6 +2199,26 @@ dgInt32 dgWorld::CalculateConvexToNonConvexContacts(dgCollisionParamProxy& proxy
 	return count;
 }
 
+bool dgWorld::OnPolySoupFaceBatch (dgPolygonMeshDesc* const data)
+{
+	dgCollisionParamProxy& proxy = *((dgCollisionParamProxy*)data->m_batchContext);
+	if (data->m_batchContactCount < 0) {
+		return false;
+	}
+
+	const dgWorld* const world = data->m_objBody->GetWorld();
+	dgContactPoint* const contactOut = proxy.m_contacts;
+	const dgInt32 maxContacts = proxy.m_maxContacts;
+	if (proxy.m_continueCollision) {
+		data->m_batchContactCount = world->CalculateConvexToNonConvexContactsContinue(proxy);
+	} else {
+		data->m_batchContactCount = world->CalculatePolySoupToHullContactsDescrete(proxy);
+	}
+	proxy.m_contacts = contactOut;
+	proxy.m_maxContacts = maxContacts;
+	return data->m_batchContactCount >= 0;
+}
+
 dgInt32 dgWorld::CalculatePolySoupToHullContactsDescrete (dgCollisionParamProxy& proxy) const
 {
 	dgAssert (proxy.m_instance1->IsType (dgCollision::dgCollisionMesh_RTTI));
@@ -2214,10 +2239,14 @@ dgInt32 dgWorld::CalculatePolySoupToHullContactsDescrete (dgCollisionParamProxy&
 	polygon.m_vertex = data.m_vertex;
 	polygon.m_stride = dgInt32 (data.m_vertexStrideInBytes / sizeof (dgFloat32));
 
-	dgInt32 count = 0;
+	// contacts from previous face batches are reduced before adding the new ones
+	dgInt32 count = data.m_batchContactCount;
 	dgInt32 maxContacts = proxy.m_maxContacts;
 	dgInt32 maxReduceLimit = maxContacts - 16;
-	dgInt32 countleft = maxContacts;
+	if (count >= 32) {
+		count = PruneContacts(count, proxy.m_contacts, dgFloat32 (1.0e-2f), 16);
+	}
+	dgInt32 countleft = maxContacts - count;
 
 	const dgVector& polygonInstanceScale = polySoupInstance->GetScale();
 	const dgMatrix polySoupGlobalMatrix = polySoupInstance->m_globalMatrix;
@@ -2235,11 +2264,12 @@ dgInt32 dgWorld::CalculatePolySoupToHullContactsDescrete (dgCollisionParamProxy&
 	const dgInt32 stride = polygon.m_stride;
 	const dgFloat32* const vertex = polygon.m_vertex;
 	dgAssert (polyInstance.m_scaleType == dgCollisionInstance::m_unit);
-	dgFloat32 closestDist = dgFloat32 (1.0e10f);
 	dgContactPoint* const contactOut = proxy.m_contacts;
 	dgContact* const contactJoint = proxy.m_contactJoint;
+	dgFloat32 closestDist = contactJoint->m_closestDistance;
 	dgInt32* const indexArray = (dgInt32*)data.m_faceVertexIndex;
 	data.SortFaceArray();
+	polygon.CullFacesToConvexHull (data, polySoupInstance, polySoupScaledMatrix, proxy.m_instance0, proxy.m_skinThickness);
 
 	for (dgInt32 i = data.m_faceCount - 1; (i >= 0) && (count < 32); i --) {
 		dgInt32 address = data.m_faceIndexStart[i];
@@ -2280,6 +2310,19 @@ dgInt32 dgWorld::CalculatePolySoupToHullContactsDescrete (dgCollisionParamProxy&
 
 	contactJoint->m_closestDistance = closestDist;
 
+ 	proxy.m_contacts = contactOut;
+
+	// restore the pointer
+	polyInstance.m_material.m_userData = NULL;
+	proxy.m_instance1 = polySoupInstance;
+	return count;
+}
+
+void dgWorld::ValidatePolySoupContactNormals (dgCollisionParamProxy& proxy, dgInt32 count) const
+{
+	dgCollisionInstance* const polySoupInstance = proxy.m_instance1;
+	dgContactPoint* const contactOut = proxy.m_contacts;
+
 	bool contactsValid = true;
 
 	for (dgInt32 i = 0; (i < count) && contactsValid; i++) {
@@ -2307,14 +2350,8 @@ dgInt32 dgWorld::CalculatePolySoupToHullContactsDescrete (dgCollisionParamProxy&
 
 		proxy.m_intersectionTestOnly = saveintersectionTestOnly;
 		cloudInstance.m_material.m_userData = NULL;
+		proxy.m_instance1 = polySoupInstance;
 	}
-
- 	proxy.m_contacts = contactOut;
-
-	// restore the pointer
-	polyInstance.m_material.m_userData = NULL;
-	proxy.m_instance1 = polySoupInstance;
-	return count;
 }
 
 dgInt32 dgWorld::CalculateConvexToNonConvexContactsContinue(dgCollisionParamProxy& proxy) const
@@ -2337,10 +2374,10 @@ dgInt32 dgWorld::CalculateConvexToNonConvexContactsContinue(dgCollisionParamProx
 	polygon.m_vertex = data.m_vertex;
 	polygon.m_stride = dgInt32(data.m_vertexStrideInBytes / sizeof (dgFloat32));
 
-	dgInt32 count = 0;
+	dgInt32 count = data.m_batchContactCount;
 	dgInt32 maxContacts = proxy.m_maxContacts;
 	dgInt32 maxReduceLimit = maxContacts >> 2;
-	dgInt32 countleft = maxContacts;
+	dgInt32 countleft = maxContacts - count;
 
 	const dgVector& polygonInstanceScale = polySoupInstance->GetScale();
 	const dgMatrix polySoupGlobalMatrix = polySoupInstance->m_globalMatrix;
@@ -2367,11 +2404,17 @@ dgInt32 dgWorld::CalculateConvexToNonConvexContactsContinue(dgCollisionParamProx
 	dgVector n(dgFloat32(0.0f), dgFloat32(1.0f), dgFloat32(0.0f), dgFloat32(0.0f));
 	dgVector p(dgFloat32(0.0f));
 	dgVector q(dgFloat32(0.0f));
-	dgFloat32 closestDist = dgFloat32(1.0e10f);
+	if (data.m_batchCount) {
+		// carry the earliest impact found by the previous face batches
+		n = proxy.m_normal;
+		p = proxy.m_closestPointBody0;
+		q = proxy.m_closestPointBody1;
+	}
+	dgFloat32 closestDist = contactJoint->m_closestDistance;
 	dgFloat32 minTimeStep = proxy.m_timestep;
 
-	dgFloat32 timeNormalizer = proxy.m_timestep;
-	dgFloat32 epsilon = dgFloat32(-1.0e-3f) * proxy.m_timestep;
+	dgFloat32 timeNormalizer = data.m_batchTimestep;
+	dgFloat32 epsilon = dgFloat32(-1.0e-3f) * data.m_batchTimestep;
 
 	for (dgInt32 i = 0; (i < data.m_faceCount) && (proxy.m_timestep >= (data.m_hitDistance[i] * timeNormalizer)); i++) {
 		dgInt32 address = data.m_faceIndexStart[i];
@@ -28,6 +28,14 @@
 #include "dgWorldDynamicUpdate.h"
 #include "dgBilateralConstraint.h"
 
+#define DG_SKELETON_DIRECT_SOLVER_MIN_ROWS	32
+#define DG_SKELETON_DIRECT_SOLVER_MAX_ROWS	128
+#define DG_SKELETON_FACTOR_STRIDE(x)		(((x) + 3) & -4)
+
+#define DG_SKELETON_PARALLEL_MIN_NODES		64
+#define DG_SKELETON_MIN_SUBTREE_NODES		8
+#define DG_SKELETON_PARALLEL_SYNC_COST		16
+
 class dgSkeletonContainer::dgNodePair
 {
 	public:
@@ -59,6 +67,19 @@ class dgSkeletonContainer::dgBodyJointMatrixDataPair
 	dgMatriData m_joint;
 } DG_GCC_VECTOR_ALIGMENT;
 
+class dgSkeletonContainer::dgSubtreeJobData
+{
+	public:
+	const dgSkeletonContainer* m_skeleton;
+	const dgJointInfo* m_jointInfoArray;
+	dgSpatialMatrix* m_bodyMassArray;
+	dgSpatialMatrix* m_jointMassArray;
+	dgForcePair* m_force;
+	const dgForcePair* m_accel;
+	dgInt32 m_atomicIndex;
+	dgInt32 m_auxiliaryCount;
+};
+
 //dgInt32 dgSkeletonContainer::m_lruMarker = 1;
 
 class dgSkeletonContainer::dgNode
@@ -379,12 +400,16 @@ dgSkeletonContainer::dgSkeletonContainer(dgWorld* const world, dgDynamicBody* co
 	,m_deltaForce(NULL)
 	,m_massMatrix11(NULL)
 	,m_massMatrix10(NULL)
+	,m_factorMatrix11(NULL)
+	,m_schurMatrix11(NULL)
+	,m_auxiliaryPermute(NULL)
 	,m_rightHandSide(NULL)
 	,m_leftHandSide(NULL)
 	,m_matrixRowsIndex(NULL)
 	,m_listNode(NULL)
 	,m_loopingJoints(world->GetAllocator())
 	,m_auxiliaryMemoryBuffer(world->GetAllocator())
+	,m_trunkNodes(world->GetAllocator())
 	,m_lru(0)
 	,m_nodeCount(1)
 	,m_loopCount(0)
@@ -392,6 +417,11 @@ dgSkeletonContainer::dgSkeletonContainer(dgWorld* const world, dgDynamicBody* co
 	,m_rowCount(0)
 	,m_loopRowCount(0)
 	,m_auxiliaryRowCount(0)
+	,m_unboundedRowCount(0)
+	,m_lod(m_fullLod)
+	,m_trunkCount(0)
+	,m_subtreeCount(0)
+	,m_subtreeThreadCount(0)
 {
 	if (rootBody->GetInvMass().m_w != dgFloat32 (0.0f)) {
 		rootBody->SetSkeleton(this);
@@ -452,6 +482,32 @@ dgWorld* dgSkeletonContainer::GetWorld() const
 	return m_world;
 }
 
+void dgSkeletonContainer::UpdateLod()
+{
+	dgInt32 lod = m_fullLod;
+	for (dgInt32 i = 0; i < m_nodeCount; i++) {
+		const dgDynamicBody* const body = m_nodesOrder[i]->m_body;
+		if (body->GetInvMass().m_w != dgFloat32(0.0f)) {
+			lod = dgMax(lod, body->GetSkeletonLod());
+		}
+	}
+	m_lod = dgInt16(lod);
+
+	if (m_lod == m_sleepLod) {
+		SetSleepState(true);
+	}
+}
+
+void dgSkeletonContainer::SetSleepState(bool state)
+{
+	for (dgInt32 i = 0; i < m_nodeCount; i++) {
+		dgDynamicBody* const body = m_nodesOrder[i]->m_body;
+		if ((body->GetInvMass().m_w != dgFloat32(0.0f)) && (body->GetSleepState() != state)) {
+			body->SetSleepState(state);
+		}
+	}
+}
+
 void dgSkeletonContainer::ClearSelfCollision()
 {
 	m_dynamicsLoopCount = 0;
@@ -653,6 +709,9 @@ void dgSkeletonContainer::InitLoopMassMatrix(const dgJointInfo* const jointInfoA
 	m_massMatrix11 = (dgFloat32*)&m_pairs[m_rowCount];
 	m_massMatrix10 = (dgFloat32*)&m_massMatrix11[m_auxiliaryRowCount * m_auxiliaryRowCount];
 	m_deltaForce = &m_massMatrix10[m_auxiliaryRowCount * primaryCount];
+	m_factorMatrix11 = (dgFloat32*)((dgUnsigned64(&m_deltaForce[m_auxiliaryRowCount * primaryCount]) + 15) & -0x10);
+	m_schurMatrix11 = &m_factorMatrix11[m_auxiliaryRowCount * DG_SKELETON_FACTOR_STRIDE(m_auxiliaryRowCount)];
+	m_auxiliaryPermute = (dgInt16*)&m_schurMatrix11[m_auxiliaryRowCount * m_auxiliaryRowCount];
 
 	dgForcePair* const forcePair = dgAlloca(dgForcePair, m_nodeCount);
 	dgForcePair* const accelPair = dgAlloca(dgForcePair, m_nodeCount);
@@ -796,6 +855,95 @@ void dgSkeletonContainer::InitLoopMassMatrix(const dgJointInfo* const jointInfoA
 		// the matrix is too big for factorization take you, do no both doing it
 		dgCholeskyApplyRegularizer(m_auxiliaryRowCount, m_massMatrix11, diagDamp);
 	}
+
+	InitAuxiliaryFactorization();
+}
+
+void dgSkeletonContainer::InitAuxiliaryFactorization()
+{
+	// loops made of bilateral joints produce rows with no bounds, these rows do not need an lcp solver.
+	// the auxiliary system is partitioned into the unbounded block, factorized here once per step, 
+	// and the schur complement of the bounded rows, which is all that is left for the lcp solver.
+	m_unboundedRowCount = 0;
+	const dgInt32 size = m_auxiliaryRowCount;
+	if (size > DG_SKELETON_DIRECT_SOLVER_MAX_ROWS) {
+		return;
+	}
+
+	dgInt32 fill = 0;
+	dgInt32 unboundedCount = 0;
+	const dgInt32 primaryCount = m_rowCount - m_auxiliaryRowCount;
+	for (dgInt32 i = 0; i < size; i++) {
+		const dgRightHandSide* const rhs = &m_rightHandSide[m_matrixRowsIndex[primaryCount + i]];
+		if ((rhs->m_lowerBoundFrictionCoefficent <= dgFloat32(-DG_LCP_MAX_VALUE)) && (rhs->m_upperBoundFrictionCoefficent >= dgFloat32(DG_LCP_MAX_VALUE))) {
+			unboundedCount++;
+		}
+		const dgFloat32* const row = &m_massMatrix11[i * size];
+		for (dgInt32 j = 0; j < size; j++) {
+			fill += (row[j] != dgFloat32(0.0f)) ? 1 : 0;
+		}
+	}
+
+	// the factorization only pays off when the rows are coupled, sparse systems converge quickly with gauss seidel
+	if (!unboundedCount || ((size > DG_SKELETON_DIRECT_SOLVER_MIN_ROWS) && (fill * 4 < size * size))) {
+		return;
+	}
+
+	dgInt32 unboundedIndex = 0;
+	dgInt32 boundedIndex = unboundedCount;
+	for (dgInt32 i = 0; i < size; i++) {
+		const dgRightHandSide* const rhs = &m_rightHandSide[m_matrixRowsIndex[primaryCount + i]];
+		if ((rhs->m_lowerBoundFrictionCoefficent <= dgFloat32(-DG_LCP_MAX_VALUE)) && (rhs->m_upperBoundFrictionCoefficent >= dgFloat32(DG_LCP_MAX_VALUE))) {
+			m_auxiliaryPermute[unboundedIndex] = dgInt16(i);
+			unboundedIndex++;
+		} else {
+			m_auxiliaryPermute[boundedIndex] = dgInt16(i);
+			boundedIndex++;
+		}
+	}
+
+	const dgInt32 stride = DG_SKELETON_FACTOR_STRIDE(size);
+	for (dgInt32 i = 0; i < size; i++) {
+		const dgFloat32* const src = &m_massMatrix11[m_auxiliaryPermute[i] * size];
+		dgFloat32* const dst = &m_factorMatrix11[i * stride];
+		for (dgInt32 j = 0; j < size; j++) {
+			dst[j] = src[m_auxiliaryPermute[j]];
+		}
+	}
+
+	for (dgInt32 i = 0; i < unboundedCount; i++) {
+		if (!dgCholeskyFactorizationAddRow(stride, i, m_factorMatrix11)) {
+			return;
+		}
+	}
+
+	// each bounded row keeps -inv(A00) * A01 in place of its coupling to the unbounded rows
+	const dgInt32 boundedCount = size - unboundedCount;
+	dgFloat32* const matrix10 = dgAlloca(dgFloat32, boundedCount * unboundedCount + 4);
+	for (dgInt32 i = 0; i < boundedCount; i++) {
+		dgFloat32* const row = &m_factorMatrix11[(unboundedCount + i) * stride];
+		dgFloat32* const a10 = &matrix10[i * unboundedCount];
+		for (dgInt32 j = 0; j < unboundedCount; j++) {
+			a10[j] = row[j];
+			row[j] = -row[j];
+		}
+		dgSolveCholesky(stride, unboundedCount, m_factorMatrix11, row, row);
+	}
+
+	for (dgInt32 i = 0; i < boundedCount; i++) {
+		const dgFloat32* const g = &m_factorMatrix11[(unboundedCount + i) * stride];
+		dgFloat32* const schurRow = &m_schurMatrix11[i * boundedCount];
+		for (dgInt32 j = i; j < boundedCount; j++) {
+			const dgFloat32* const a10 = &matrix10[j * unboundedCount];
+			dgFloat32 elem = g[unboundedCount + j];
+			for (dgInt32 k = 0; k < unboundedCount; k++) {
+				elem += g[k] * a10[k];
+			}
+			schurRow[j] = elem;
+			m_schurMatrix11[j * boundedCount + i] = elem;
+		}
+	}
+	m_unboundedRowCount = dgInt16(unboundedCount);
 }
 
 bool dgSkeletonContainer::SanityCheck(const dgForcePair* const force, const dgForcePair* const accel) const
@@ -1227,6 +1375,83 @@ void dgSkeletonContainer::SolveLcp_new(dgInt32 size, const dgFloat32* const matr
 //dgTrace(("%d %f\n", iterCount, dgSqrt(tolerance)));
 }
 
+void dgSkeletonContainer::SolveBlockLcp(const dgFloat32* const x0, dgFloat32* const x, const dgFloat32* const b, const dgFloat32* const low, const dgFloat32* const high, const dgInt32* const normalIndex) const
+{
+	D_TRACKTIME();
+	const dgInt32 size = m_auxiliaryRowCount;
+	const dgInt32 stride = DG_SKELETON_FACTOR_STRIDE(size);
+	const dgInt32 unboundedCount = m_unboundedRowCount;
+	const dgInt32 boundedCount = size - unboundedCount;
+
+	dgFloat32* const b0 = dgAlloca(dgFloat32, unboundedCount);
+	dgFloat32* const x1 = dgAlloca(dgFloat32, unboundedCount);
+	for (dgInt32 i = 0; i < unboundedCount; i++) {
+		b0[i] = b[m_auxiliaryPermute[i]];
+	}
+	dgSolveCholesky(stride, unboundedCount, m_factorMatrix11, x1, b0);
+
+	if (boundedCount) {
+		dgInt32* const position = dgAlloca(dgInt32, size);
+		dgFloat32* const u = dgAlloca(dgFloat32, boundedCount);
+		dgFloat32* const c = dgAlloca(dgFloat32, boundedCount);
+		dgFloat32* const u0 = dgAlloca(dgFloat32, boundedCount);
+		dgFloat32* const l = dgAlloca(dgFloat32, boundedCount);
+		dgFloat32* const h = dgAlloca(dgFloat32, boundedCount);
+		dgInt32* const normal = dgAlloca(dgInt32, boundedCount);
+
+		for (dgInt32 i = 0; i < size; i++) {
+			position[m_auxiliaryPermute[i]] = i;
+		}
+
+		bool fixBounds = true;
+		for (dgInt32 i = 0; i < boundedCount; i++) {
+			const dgInt32 index = m_auxiliaryPermute[unboundedCount + i];
+			const dgFloat32* const g = &m_factorMatrix11[(unboundedCount + i) * stride];
+			dgFloat32 acc = b[index];
+			for (dgInt32 j = 0; j < unboundedCount; j++) {
+				acc += g[j] * b0[j];
+			}
+			c[i] = acc;
+			u0[i] = x0[index];
+			l[i] = low[index];
+			h[i] = high[index];
+			normal[i] = 0;
+			if (normalIndex[index]) {
+				dgAssert(position[index + normalIndex[index]] >= unboundedCount);
+				normal[i] = position[index + normalIndex[index]] - (unboundedCount + i);
+				fixBounds = false;
+			}
+		}
+
+		if (fixBounds) {
+			// with no friction rows the bounds are constant, which is what the dantzig solver needs
+			dgFloat32* const schurMatrix = dgAlloca(dgFloat32, boundedCount * boundedCount);
+			memcpy(schurMatrix, m_schurMatrix11, boundedCount * boundedCount * sizeof(dgFloat32));
+			for (dgInt32 i = 0; i < boundedCount; i++) {
+				l[i] -= u0[i];
+				h[i] -= u0[i];
+				u[i] = dgFloat32(0.0f);
+			}
+			dgSolveDantzigLCP(boundedCount, schurMatrix, u, c, l, h);
+		} else {
+			SolveLcp(boundedCount, m_schurMatrix11, u0, u, c, l, h, normal);
+		}
+
+		for (dgInt32 i = 0; i < boundedCount; i++) {
+			const dgFloat32 s = u[i];
+			const dgFloat32* const g = &m_factorMatrix11[(unboundedCount + i) * stride];
+			x[m_auxiliaryPermute[unboundedCount + i]] = s;
+			for (dgInt32 j = 0; j < unboundedCount; j++) {
+				x1[j] += g[j] * s;
+			}
+		}
+	}
+
+	for (dgInt32 i = 0; i < unboundedCount; i++) {
+		x[m_auxiliaryPermute[i]] = x1[i];
+	}
+}
+
 #if 0
 void dgSkeletonContainer::SolveAuxiliary(const dgJointInfo* const jointInfoArray, dgJacobian* const internalForces, const dgForcePair* const accel, dgForcePair* const force) const
 {
@@ -1486,8 +1711,12 @@ void dgSkeletonContainer::SolveAuxiliary(const dgJointInfo* const jointInfoArray
 		}
 		b[i] -= r;
 	}
-	SolveLcp(m_auxiliaryRowCount, m_massMatrix11, u0, u, b, low, high, normalIndex);
-	//	SolveLcp_new(m_auxiliaryRowCount, m_massMatrix11, u0, u, b, low, high, normalIndex);
+	if (m_unboundedRowCount) {
+		SolveBlockLcp(u0, u, b, low, high, normalIndex);
+	} else {
+		SolveLcp(m_auxiliaryRowCount, m_massMatrix11, u0, u, b, low, high, normalIndex);
+		//	SolveLcp_new(m_auxiliaryRowCount, m_massMatrix11, u0, u, b, low, high, normalIndex);
+	}
 
 	for (dgInt32 i = 0; i < m_auxiliaryRowCount; i++) {
 		const dgFloat32 s = u[i];
@@ -1545,6 +1774,9 @@ dgInt8* dgSkeletonContainer::CalculateBufferSizeInBytes (const dgJointInfo* cons
 //	size += sizeof (dgFloat32) * auxiliaryRowCount * auxiliaryRowCount;		// matrixLowerTraingular [auxiliaryRowCount * auxiliaryRowCount]
 	size += sizeof (dgFloat32) * auxiliaryRowCount * (rowCount - auxiliaryRowCount);
 	size += sizeof (dgFloat32) * auxiliaryRowCount * (rowCount - auxiliaryRowCount);
+	size += sizeof (dgFloat32) * (auxiliaryRowCount * DG_SKELETON_FACTOR_STRIDE(auxiliaryRowCount) + 4);	// factorMatrix11[auxiliaryRowCount * stride]
+	size += sizeof (dgFloat32) * auxiliaryRowCount * auxiliaryRowCount;		// schurMatrix11[boundedRowCount * boundedRowCount]
+	size += sizeof (dgInt16) * auxiliaryRowCount;
 	size = (size + 1024) & -0x10;
 	m_auxiliaryMemoryBuffer.ResizeIfNecessary((size + 1024) & -0x10);
 	return &m_auxiliaryMemoryBuffer[0];
@@ -1558,6 +1790,9 @@ void dgSkeletonContainer::InitMassMatrix(const dgJointInfo* const jointInfoArray
 	dgInt32 auxiliaryCount = 0;
 	m_leftHandSide = leftHandSide;
 	m_rightHandSide = rightHandSide;
+	if (m_lod >= m_iterativeLod) {
+		return;
+	}
 
 	dgSpatialMatrix* const bodyMassArray = dgAlloca (dgSpatialMatrix, m_nodeCount);
 	dgSpatialMatrix* const jointMassArray = dgAlloca (dgSpatialMatrix, m_nodeCount);
@@ -1571,9 +1806,20 @@ void dgSkeletonContainer::InitMassMatrix(const dgJointInfo* const jointInfoArray
 		}
 		m_nodesOrder[m_nodeCount - 1]->Factorize(jointInfoArray, leftHandSide, rightHandSide, bodyMassArray, jointMassArray);
 	}
+	InitAuxiliaryMassMatrix(jointInfoArray, rowCount, auxiliaryCount);
+}
+
+void dgSkeletonContainer::InitAuxiliaryMassMatrix(const dgJointInfo* const jointInfoArray, dgInt32 rowCount, dgInt32 auxiliaryCount)
+{
 	m_rowCount = dgInt16 (rowCount);
 	m_auxiliaryRowCount = dgInt16 (auxiliaryCount);
 
+	if (m_lod != m_fullLod) {
+		// below full detail the auxiliary rows and loops only get the iterative solver forces
+		m_auxiliaryRowCount = 0;
+		return;
+	}
+
 	dgInt32 loopRowCount = 0;
 	const dgInt32 loopCount = m_loopCount + m_dynamicsLoopCount;
 	for (dgInt32 j = 0; j < loopCount; j++) {
@@ -1592,6 +1838,10 @@ void dgSkeletonContainer::InitMassMatrix(const dgJointInfo* const jointInfoArray
 void dgSkeletonContainer::CalculateJointForce(dgJointInfo* const jointInfoArray, const dgBodyInfo* const bodyArray, dgJacobian* const internalForces)
 {
 	D_TRACKTIME();
+	if (m_lod >= m_iterativeLod) {
+		return;
+	}
+
 	dgForcePair* const force = dgAlloca(dgForcePair, m_nodeCount);
 	dgForcePair* const accel = dgAlloca(dgForcePair, m_nodeCount);
 
@@ -1604,3 +1854,243 @@ void dgSkeletonContainer::CalculateJointForce(dgJointInfo* const jointInfoArray,
 	}
 }
 
+
+void dgSkeletonContainer::PartitionSubtrees(dgInt32 threadCount)
+{
+	if (m_subtreeThreadCount == threadCount) {
+		return;
+	}
+	m_trunkCount = 0;
+	m_subtreeCount = 0;
+	m_subtreeThreadCount = dgInt16(threadCount);
+	if ((threadCount < 2) || !m_nodesOrder || (m_nodeCount < DG_SKELETON_PARALLEL_MIN_NODES)) {
+		return;
+	}
+
+	// nodes are in post order, so each subtree is the range of nodes that ends at its root
+	dgInt32* const subtreeSize = dgAlloca(dgInt32, m_nodeCount);
+	for (dgInt32 i = 0; i < m_nodeCount; i++) {
+		const dgNode* const node = m_nodesOrder[i];
+		subtreeSize[i] = 1;
+		for (dgNode* child = node->m_child; child; child = child->m_sibling) {
+			subtreeSize[i] += subtreeSize[child->m_index];
+		}
+	}
+
+	// pick the largest subtrees that fit in one thread share, the nodes above them are the trunk
+	const dgInt32 target = dgMax((m_nodeCount + threadCount - 1) / threadCount, DG_SKELETON_MIN_SUBTREE_NODES);
+	dgInt32 count = 0;
+	dgInt32 covered = 0;
+	for (dgInt32 i = 0; i < m_nodeCount - 1; i++) {
+		const dgNode* const node = m_nodesOrder[i];
+		if ((subtreeSize[i] <= target) && (subtreeSize[node->m_parent->m_index] > target)) {
+			const dgInt32 start = i - subtreeSize[i] + 1;
+			covered += subtreeSize[i];
+			if (count && (m_subtreeEnd[count - 1] == (start - 1)) && ((i - m_subtreeStart[count - 1] + 1) <= target)) {
+				// adjacent sibling subtrees are merged into one work item
+				m_subtreeEnd[count - 1] = dgInt16(i);
+			} else {
+				if (count == DG_SKELETON_MAX_SUBTREES) {
+					return;
+				}
+				m_subtreeStart[count] = dgInt16(start);
+				m_subtreeEnd[count] = dgInt16(i);
+				count++;
+			}
+		}
+	}
+
+	// the trunk is solved serially between the two parallel passes, 
+	// only split when the critical path is clearly shorter than the serial solve
+	dgInt32 largest = 0;
+	for (dgInt32 i = 0; i < count; i++) {
+		largest = dgMax(largest, m_subtreeEnd[i] - m_subtreeStart[i] + 1);
+	}
+	const dgInt32 criticalPath = (m_nodeCount - covered) + dgMax(largest, covered / threadCount) + DG_SKELETON_PARALLEL_SYNC_COST;
+	if ((count < 2) || ((criticalPath * 4) > (m_nodeCount * 3))) {
+		return;
+	}
+
+	dgInt32 trunkCount = 0;
+	for (dgInt32 i = 0; i < m_nodeCount; i++) {
+		if (subtreeSize[i] > target) {
+			m_trunkNodes[trunkCount] = dgInt16(i);
+			trunkCount++;
+		}
+	}
+	dgAssert(m_trunkNodes[trunkCount - 1] == (m_nodeCount - 1));
+	m_trunkCount = dgInt16(trunkCount);
+	m_subtreeCount = dgInt16(count);
+}
+
+void dgSkeletonContainer::DispatchSubtrees(dgWorkerThreadTaskCallback kernel, dgSubtreeJobData* const data, const char* const functionName) const
+{
+	data->m_atomicIndex = 0;
+	const dgInt32 threadCount = m_world->GetThreadCount();
+	for (dgInt32 i = 0; i < threadCount; i++) {
+		m_world->QueueJob(kernel, data, NULL, functionName);
+	}
+	m_world->SynchronizationBarrier();
+}
+
+DG_INLINE void dgSkeletonContainer::SolveForwardNode(dgForcePair* const force, const dgForcePair* const accel, dgInt32 index) const
+{
+	dgNode* const node = m_nodesOrder[index];
+	dgAssert(node->m_joint);
+	dgAssert(node->m_index == index);
+	dgForcePair& f = force[index];
+	const dgForcePair& a = accel[index];
+	f.m_body = a.m_body;
+	f.m_joint = a.m_joint;
+	for (dgNode* child = node->m_child; child; child = child->m_sibling) {
+		dgAssert(child->m_joint);
+		dgAssert(child->m_parent->m_index == index);
+		child->BodyJacobianTimeMassForward(force[child->m_index], f);
+	}
+	node->JointJacobianTimeMassForward(f);
+}
+
+DG_INLINE void dgSkeletonContainer::SolveBackwardNode(dgForcePair* const force, dgInt32 index) const
+{
+	dgNode* const node = m_nodesOrder[index];
+	dgAssert(node->m_index == index);
+	dgForcePair& f = force[index];
+	node->JointJacobianTimeSolutionBackward(f, force[node->m_parent->m_index]);
+	node->BodyJacobianTimeSolutionBackward(f);
+}
+
+void dgSkeletonContainer::FactorizeSubtreesKernel(void* const context, void* const, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgSubtreeJobData* const data = (dgSubtreeJobData*)context;
+	const dgSkeletonContainer* const me = data->m_skeleton;
+	dgInt32 auxiliaryCount = 0;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&data->m_atomicIndex, 1); i < me->m_subtreeCount; i = dgAtomicExchangeAndAdd(&data->m_atomicIndex, 1)) {
+		for (dgInt32 j = me->m_subtreeStart[i]; j <= me->m_subtreeEnd[i]; j++) {
+			dgNode* const node = me->m_nodesOrder[j];
+			auxiliaryCount += node->Factorize(data->m_jointInfoArray, me->m_leftHandSide, me->m_rightHandSide, data->m_bodyMassArray, data->m_jointMassArray);
+		}
+	}
+	dgAtomicExchangeAndAdd(&data->m_auxiliaryCount, auxiliaryCount);
+}
+
+void dgSkeletonContainer::SolveForwardSubtreesKernel(void* const context, void* const, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgSubtreeJobData* const data = (dgSubtreeJobData*)context;
+	const dgSkeletonContainer* const me = data->m_skeleton;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&data->m_atomicIndex, 1); i < me->m_subtreeCount; i = dgAtomicExchangeAndAdd(&data->m_atomicIndex, 1)) {
+		for (dgInt32 j = me->m_subtreeStart[i]; j <= me->m_subtreeEnd[i]; j++) {
+			me->SolveForwardNode(data->m_force, data->m_accel, j);
+		}
+	}
+}
+
+void dgSkeletonContainer::SolveBackwardSubtreesKernel(void* const context, void* const, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgSubtreeJobData* const data = (dgSubtreeJobData*)context;
+	const dgSkeletonContainer* const me = data->m_skeleton;
+	dgForcePair* const force = data->m_force;
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&data->m_atomicIndex, 1); i < me->m_subtreeCount; i = dgAtomicExchangeAndAdd(&data->m_atomicIndex, 1)) {
+		const dgInt32 start = me->m_subtreeStart[i];
+		const dgInt32 end = me->m_subtreeEnd[i];
+		for (dgInt32 j = start; j <= end; j++) {
+			dgNode* const node = me->m_nodesOrder[j];
+			node->BodyDiagInvTimeSolution(force[j]);
+			node->JointDiagInvTimeSolution(force[j]);
+		}
+		for (dgInt32 j = end; j >= start; j--) {
+			me->SolveBackwardNode(force, j);
+		}
+	}
+}
+
+void dgSkeletonContainer::InitMassMatrixParallel(const dgJointInfo* const jointInfoArray, const dgLeftHandSide* const leftHandSide, dgRightHandSide* const rightHandSide)
+{
+	D_TRACKTIME();
+	m_leftHandSide = leftHandSide;
+	m_rightHandSide = rightHandSide;
+	if (m_lod >= m_iterativeLod) {
+		return;
+	}
+
+	dgAssert(m_subtreeCount);
+	dgSpatialMatrix* const bodyMassArray = dgAlloca (dgSpatialMatrix, m_nodeCount);
+	dgSpatialMatrix* const jointMassArray = dgAlloca (dgSpatialMatrix, m_nodeCount);
+
+	dgSubtreeJobData data;
+	data.m_skeleton = this;
+	data.m_jointInfoArray = jointInfoArray;
+	data.m_bodyMassArray = bodyMassArray;
+	data.m_jointMassArray = jointMassArray;
+	data.m_force = NULL;
+	data.m_accel = NULL;
+	data.m_auxiliaryCount = 0;
+	DispatchSubtrees(FactorizeSubtreesKernel, &data, "dgSkeletonContainer::FactorizeSubtrees");
+
+	dgInt32 auxiliaryCount = data.m_auxiliaryCount;
+	for (dgInt32 i = 0; i < m_trunkCount; i++) {
+		dgNode* const node = m_nodesOrder[m_trunkNodes[i]];
+		auxiliaryCount += node->Factorize(jointInfoArray, leftHandSide, rightHandSide, bodyMassArray, jointMassArray);
+	}
+
+	dgInt32 rowCount = 0;
+	for (dgInt32 i = 0; i < m_nodeCount - 1; i++) {
+		const dgNode* const node = m_nodesOrder[i];
+		rowCount += jointInfoArray[node->m_joint->m_index].m_pairCount;
+	}
+	InitAuxiliaryMassMatrix(jointInfoArray, rowCount, auxiliaryCount);
+}
+
+void dgSkeletonContainer::CalculateJointForceParallel(dgJointInfo* const jointInfoArray, const dgBodyInfo* const bodyArray, dgJacobian* const internalForces)
+{
+	D_TRACKTIME();
+	if (m_lod >= m_iterativeLod) {
+		return;
+	}
+
+	dgAssert(m_subtreeCount);
+	dgForcePair* const force = dgAlloca(dgForcePair, m_nodeCount);
+	dgForcePair* const accel = dgAlloca(dgForcePair, m_nodeCount);
+	CalculateJointAccel(jointInfoArray, internalForces, accel);
+
+	dgSubtreeJobData data;
+	data.m_skeleton = this;
+	data.m_jointInfoArray = jointInfoArray;
+	data.m_bodyMassArray = NULL;
+	data.m_jointMassArray = NULL;
+	data.m_force = force;
+	data.m_accel = accel;
+	data.m_auxiliaryCount = 0;
+	DispatchSubtrees(SolveForwardSubtreesKernel, &data, "dgSkeletonContainer::SolveForwardSubtrees");
+
+	// the trunk ends with the root node, which has no joint
+	const dgInt32 rootIndex = m_nodeCount - 1;
+	for (dgInt32 i = 0; i < m_trunkCount - 1; i++) {
+		SolveForwardNode(force, accel, m_trunkNodes[i]);
+	}
+	force[rootIndex] = accel[rootIndex];
+	for (dgNode* child = m_nodesOrder[rootIndex]->m_child; child; child = child->m_sibling) {
+		child->BodyJacobianTimeMassForward(force[child->m_index], force[rootIndex]);
+	}
+
+	for (dgInt32 i = 0; i < m_trunkCount - 1; i++) {
+		const dgInt32 index = m_trunkNodes[i];
+		dgNode* const node = m_nodesOrder[index];
+		node->BodyDiagInvTimeSolution(force[index]);
+		node->JointDiagInvTimeSolution(force[index]);
+	}
+	m_nodesOrder[rootIndex]->BodyDiagInvTimeSolution(force[rootIndex]);
+
+	for (dgInt32 i = m_trunkCount - 2; i >= 0; i--) {
+		SolveBackwardNode(force, m_trunkNodes[i]);
+	}
+	DispatchSubtrees(SolveBackwardSubtreesKernel, &data, "dgSkeletonContainer::SolveBackwardSubtrees");
+
+	if (m_auxiliaryRowCount) {
+		SolveAuxiliary (jointInfoArray, internalForces, accel, force);
+	} else {
+		UpdateForces(jointInfoArray, internalForces, force);
+	}
+}
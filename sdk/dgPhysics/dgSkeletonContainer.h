@@ -26,6 +26,8 @@
 #include "dgContact.h"
 #include "dgBilateralConstraint.h"
 
+#define DG_SKELETON_MAX_SUBTREES	32
+
 class dgDynamicBody;
 
 class dgSkeletonContainer
@@ -36,6 +38,16 @@ class dgSkeletonContainer
 	class dgForcePair;
 	class dgMatriData;
 	class dgBodyJointMatrixDataPair;
+	class dgSubtreeJobData;
+
+	// level of detail of the skeleton, it is the highest level set on any of its bodies
+	enum dgSkeletonLod
+	{
+		m_fullLod,			// exact tree solve plus the auxiliary rows lcp
+		m_reducedLod,		// exact tree solve, limits and loops are left to the iterative solver
+		m_iterativeLod,		// no exact solve, all joints are solved by the iterative solver
+		m_sleepLod,			// the bodies of the skeleton are put to sleep as a unit
+	};
 
 	DG_CLASS_ALLOCATOR(allocator)
 	dgSkeletonContainer(dgWorld* const world, dgDynamicBody* const rootBody);
@@ -60,8 +72,18 @@ class dgSkeletonContainer
 	dgInt32 GetLru() const { return m_lru; }
 	void SetLru(dgInt32 lru) { m_lru = lru; }
 
+	dgInt32 GetLod() const { return m_lod; }
+	void UpdateLod();
+	void SetSleepState(bool state);
+
 	virtual void CalculateJointForce (dgJointInfo* const jointInfoArray, const dgBodyInfo* const bodyArray, dgJacobian* const internalForces);
 	virtual void InitMassMatrix (const dgJointInfo* const jointInfoArray, const dgLeftHandSide* const matrixRow, dgRightHandSide* const rightHandSide);
+
+	// large skeletons are split into independent subtrees that all threads solve together
+	dgInt32 GetSubtreeCount() const { return m_subtreeCount; }
+	void PartitionSubtrees(dgInt32 threadCount);
+	void CalculateJointForceParallel (dgJointInfo* const jointInfoArray, const dgBodyInfo* const bodyArray, dgJacobian* const internalForces);
+	void InitMassMatrixParallel (const dgJointInfo* const jointInfoArray, const dgLeftHandSide* const matrixRow, dgRightHandSide* const rightHandSide);
 	
 	private:
 	bool SanityCheck(const dgForcePair* const force, const dgForcePair* const accel) const;
@@ -72,14 +94,24 @@ class dgSkeletonContainer
 	DG_INLINE void CalculateJointAccel (dgJointInfo* const jointInfoArray, const dgJacobian* const internalForces, dgForcePair* const accel) const;
 
 	DG_INLINE void CalculateLoopMassMatrixCoefficients(dgFloat32* const diagDamp);
+	DG_INLINE void SolveForwardNode(dgForcePair* const force, const dgForcePair* const accel, dgInt32 index) const;
+	DG_INLINE void SolveBackwardNode(dgForcePair* const force, dgInt32 index) const;
+	void DispatchSubtrees(dgWorkerThreadTaskCallback kernel, dgSubtreeJobData* const data, const char* const functionName) const;
+
+	static void FactorizeSubtreesKernel(void* const context, void* const, dgInt32 threadID);
+	static void SolveForwardSubtreesKernel(void* const context, void* const, dgInt32 threadID);
+	static void SolveBackwardSubtreesKernel(void* const context, void* const, dgInt32 threadID);
 
 	dgNode* FindNode(dgDynamicBody* const node) const;
 	void SortGraph(dgNode* const root, dgInt32& index);
 		
 	void InitLoopMassMatrix (const dgJointInfo* const jointInfoArray);
+	void InitAuxiliaryMassMatrix (const dgJointInfo* const jointInfoArray, dgInt32 rowCount, dgInt32 auxiliaryCount);
+	void InitAuxiliaryFactorization ();
 	dgInt8* CalculateBufferSizeInBytes (const dgJointInfo* const jointInfoArray);
 	void SolveAuxiliary (const dgJointInfo* const jointInfoArray, dgJacobian* const internalForces, const dgForcePair* const accel, dgForcePair* const force) const;
 	void SolveLcp(dgInt32 size, const dgFloat32* const matrix, const dgFloat32* const x0, dgFloat32* const x, const dgFloat32* const b, const dgFloat32* const low, const dgFloat32* const high, const dgInt32* const normalIndex) const;
+	void SolveBlockLcp(const dgFloat32* const x0, dgFloat32* const x, const dgFloat32* const b, const dgFloat32* const low, const dgFloat32* const high, const dgInt32* const normalIndex) const;
 	void SolveLcp_new(dgInt32 size, const dgFloat32* const matrix, const dgFloat32* const x0, dgFloat32* const x, const dgFloat32* const b, const dgFloat32* const low, const dgFloat32* const high, const dgInt32* const normalIndex) const;
 
 	dgWorld* m_world;
@@ -89,12 +121,16 @@ class dgSkeletonContainer
 	dgFloat32* m_deltaForce;
 	dgFloat32* m_massMatrix11;
 	dgFloat32* m_massMatrix10;
+	dgFloat32* m_factorMatrix11;
+	dgFloat32* m_schurMatrix11;
+	dgInt16* m_auxiliaryPermute;
 	dgRightHandSide* m_rightHandSide;
 	const dgLeftHandSide* m_leftHandSide;
 	dgInt32* m_matrixRowsIndex;
 	dgSkeletonList::dgListNode* m_listNode;
 	dgArray<dgConstraint*> m_loopingJoints;
 	dgArray<dgInt8> m_auxiliaryMemoryBuffer;
+	dgArray<dgInt16> m_trunkNodes;
 	dgInt32 m_lru;
 	dgInt16 m_nodeCount;
 	dgInt16 m_loopCount;
@@ -102,6 +138,13 @@ class dgSkeletonContainer
 	dgInt16 m_rowCount;
 	dgInt16 m_loopRowCount;
 	dgInt16 m_auxiliaryRowCount;
+	dgInt16 m_unboundedRowCount;
+	dgInt16 m_lod;
+	dgInt16 m_trunkCount;
+	dgInt16 m_subtreeCount;
+	dgInt16 m_subtreeThreadCount;
+	dgInt16 m_subtreeStart[DG_SKELETON_MAX_SUBTREES];
+	dgInt16 m_subtreeEnd[DG_SKELETON_MAX_SUBTREES];
 
 	friend class dgWorld;
 	friend class dgParallelBodySolver;
@@ -228,6 +228,7 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 //	,m_mainThreadMutex()
 	,m_onPostUpdateCallback(NULL)
 	,m_listeners(allocator)
+	,m_retiredPublishedStates(allocator)
 	,m_perInstanceData(allocator)
 	,m_bodiesMemory (allocator, 64)
 	,m_jointsMemory (allocator, 64)
@@ -263,12 +264,20 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	m_inUpdate = 0;
 	m_bodyGroupID = 0;
 	m_lastExecutionTime = 0;
+	memset (&m_stats, 0, sizeof (m_stats));
 	
 	m_defualtBodyGroupID = CreateBodyGroupID();
 	m_genericLRUMark = 0;
 	m_clusterLRU = 0;
 
 	m_useParallelSolver = 1;
+	m_deterministicMode = 0;
+
+	m_publishedStateMode = 0;
+	m_publishedFront = -1;
+	m_publishedBack = 0;
+	m_publishedFrame = 0;
+	memset (m_publishedBuffers, 0, sizeof (m_publishedBuffers));
 
 	m_solverIterations = DG_DEFAULT_SOLVER_ITERATION_COUNT;
 	m_dynamicsLru = 0;
@@ -289,6 +298,8 @@ dgWorld::dgWorld(dgMemoryAllocator* const allocator)
 	m_freezeOmega2 = DG_FREEZE_SPEED2;
 
 	m_contactTolerance = DG_PRUNE_CONTACT_TOLERANCE;
+	m_compoundContactSplitThreshold = DG_COMPOUND_CONTACT_SPLIT_THRESHOLD;
+	m_threadPoolPriority = 0;
 
 	dgInt32 steps = 1;
 	dgFloat32 freezeAccel2 = m_freezeAccel2;
@@ -339,6 +350,7 @@ dgWorld::~dgWorld()
 
 	UnloadPlugins();
 	m_listeners.RemoveAll();
+	ReleasePublishedState();
 
 	DestroyAllBodies();
 	RemoveAllGroupID();
@@ -398,9 +410,30 @@ void dgWorld::DestroyAllBodies()
 
 void dgWorld::SetThreadsCount (dgInt32 count)
 {
+	SetSharedThreadHive(NULL);
 	dgThreadHive::SetThreadsCount(count);
 }
 
+void dgWorld::SetSharedThreadPool (dgWorldSharedThreadPool* const threadPool)
+{
+	SetSharedThreadHive(threadPool);
+}
+
+dgWorldSharedThreadPool* dgWorld::GetSharedThreadPool () const
+{
+	return (dgWorldSharedThreadPool*) GetSharedThreadHive();
+}
+
+dgInt32 dgWorld::GetThreadPoolPriority () const
+{
+	return m_threadPoolPriority;
+}
+
+void dgWorld::SetThreadPoolPriority (dgInt32 priority)
+{
+	m_threadPoolPriority = priority;
+}
+
 dgUnsigned32 dgWorld::GetPerformanceCount ()
 {
 	return 0;
@@ -431,6 +464,17 @@ void dgWorld::SetContactMergeTolerance(dgFloat32 tolerenace)
 	m_contactTolerance = dgMax (tolerenace, dgFloat32 (1.e-3f));
 }
 
+dgInt32 dgWorld::GetCompoundContactSplitThreshold() const
+{
+	return m_compoundContactSplitThreshold;
+}
+
+void dgWorld::SetCompoundContactSplitThreshold(dgInt32 threshold)
+{
+	// a threshold of zero disables splitting large compound pairs across threads
+	m_compoundContactSplitThreshold = dgMax (threshold, 0);
+}
+
 void dgWorld::EnableParallelSolverOnLargeIsland(dgInt32 mode)
 {
 	m_useParallelSolver = mode ? 1 : 0;
@@ -441,6 +485,162 @@ dgInt32 dgWorld::GetParallelSolverOnLargeIsland() const
 	return m_useParallelSolver ? 1 : 0;
 }
 
+void dgWorld::SetDeterministicMode(dgInt32 mode)
+{
+	m_deterministicMode = mode ? 1 : 0;
+}
+
+dgInt32 dgWorld::GetDeterministicMode() const
+{
+	return m_deterministicMode ? 1 : 0;
+}
+
+void dgWorld::SetPublishedStateMode(dgInt32 mode)
+{
+	Sync();
+	m_publishedStateMode = mode ? 1 : 0;
+	if (!m_publishedStateMode) {
+		ReleasePublishedState();
+	}
+}
+
+dgInt32 dgWorld::GetPublishedStateMode() const
+{
+	return m_publishedStateMode ? 1 : 0;
+}
+
+void dgWorld::ReleasePublishedState()
+{
+	for (dgInt32 i = 0; i < 2; i ++) {
+		if (m_publishedBuffers[i].m_states) {
+			m_allocator->Free (m_publishedBuffers[i].m_states);
+		}
+	}
+	for (dgList<dgPublishedBodyState*>::dgListNode* node = m_retiredPublishedStates.GetFirst(); node; node = node->GetNext()) {
+		m_allocator->Free (node->GetInfo());
+	}
+	m_retiredPublishedStates.RemoveAll();
+	memset (m_publishedBuffers, 0, sizeof (m_publishedBuffers));
+	m_publishedFront = -1;
+	m_publishedBack = 0;
+}
+
+void dgWorld::BeginPublishState()
+{
+	// readers only look at the front buffer, but one that sampled it just before the last flip
+	// may still be copying from this one, an odd sequence tells it to retry
+	m_publishedBack = (m_publishedFront >= 0) ? m_publishedFront ^ 1 : 0;
+	dgPublishedStateBuffer& buffer = m_publishedBuffers[m_publishedBack];
+	dgAtomicExchangeAndAdd (&buffer.m_sequence, 1);
+
+	const dgInt32 count = dgInt32 (m_bodiesUniqueID) + 1;
+	if (count > buffer.m_capacity) {
+		// a late reader may still hold the old pointer, so it is only released with the world
+		if (buffer.m_states) {
+			m_retiredPublishedStates.Append (buffer.m_states);
+		}
+		const dgInt32 capacity = dgMax (count * 2, 256);
+		dgPublishedBodyState* const states = (dgPublishedBodyState*) m_allocator->Malloc (dgInt32 (capacity * sizeof (dgPublishedBodyState)));
+		memset (states, 0, capacity * sizeof (dgPublishedBodyState));
+		for (dgInt32 i = 0; i < capacity; i ++) {
+			states[i].m_uniqueID = -1;
+		}
+		// the pointer must be visible before the larger capacity
+		buffer.m_states = states;
+		dgAtomicExchangeAndAdd (&buffer.m_capacity, capacity - buffer.m_capacity);
+	}
+}
+
+void dgWorld::EndPublishState()
+{
+	dgPublishedStateBuffer& buffer = m_publishedBuffers[m_publishedBack];
+	m_publishedFrame ++;
+	buffer.m_frame = m_publishedFrame;
+	dgAtomicExchangeAndAdd (&buffer.m_sequence, 1);
+	dgInterlockedExchange (&m_publishedFront, m_publishedBack);
+}
+
+dgInt32 dgWorld::GetPublishedFrame() const
+{
+	dgWorld* const me = (dgWorld*) this;
+	const dgInt32 front = dgAtomicExchangeAndAdd (&me->m_publishedFront, 0);
+	return (front >= 0) ? m_publishedBuffers[front].m_frame : 0;
+}
+
+bool dgWorld::GetPublishedBodyState(const dgBody* const body, dgPublishedBodyState& state) const
+{
+	dgWorld* const me = (dgWorld*) this;
+	for (;;) {
+		const dgInt32 front = dgAtomicExchangeAndAdd (&me->m_publishedFront, 0);
+		if (front < 0) {
+			return false;
+		}
+		dgPublishedStateBuffer& buffer = me->m_publishedBuffers[front];
+		const dgInt32 sequence = dgAtomicExchangeAndAdd (&buffer.m_sequence, 0);
+		if (!(sequence & 1)) {
+			const dgInt32 capacity = dgAtomicExchangeAndAdd (&buffer.m_capacity, 0);
+			const bool found = body->m_uniqueID < capacity;
+			if (found) {
+				state = buffer.m_states[body->m_uniqueID];
+			}
+			if (dgAtomicExchangeAndAdd (&buffer.m_sequence, 0) == sequence) {
+				return found && (state.m_uniqueID == body->m_uniqueID);
+			}
+		}
+		dgThreadYield();
+	}
+}
+
+dgInt32 dgWorld::GetPublishedBodyStates(const dgBody* const* const bodies, dgInt32 count, const dgBodyStateArrays& arrays) const
+{
+	const dgInt32 positStride = arrays.m_positStride ? arrays.m_positStride : dgInt32 (3 * sizeof (dgFloat32));
+	const dgInt32 rotationStride = arrays.m_rotationStride ? arrays.m_rotationStride : dgInt32 (4 * sizeof (dgFloat32));
+	const dgInt32 velocStride = arrays.m_velocStride ? arrays.m_velocStride : dgInt32 (3 * sizeof (dgFloat32));
+	const dgInt32 omegaStride = arrays.m_omegaStride ? arrays.m_omegaStride : dgInt32 (3 * sizeof (dgFloat32));
+	const dgInt32 sleepingStride = arrays.m_sleepingStride ? arrays.m_sleepingStride : dgInt32 (sizeof (dgInt32));
+
+	dgWorld* const me = (dgWorld*) this;
+	for (;;) {
+		const dgInt32 front = dgAtomicExchangeAndAdd (&me->m_publishedFront, 0);
+		if (front < 0) {
+			return 0;
+		}
+		dgPublishedStateBuffer& buffer = me->m_publishedBuffers[front];
+		const dgInt32 sequence = dgAtomicExchangeAndAdd (&buffer.m_sequence, 0);
+		if (!(sequence & 1)) {
+			dgInt32 found = 0;
+			const dgInt32 capacity = dgAtomicExchangeAndAdd (&buffer.m_capacity, 0);
+			const dgPublishedBodyState* const states = buffer.m_states;
+			for (dgInt32 i = 0; i < count; i ++) {
+				const dgInt32 uniqueID = bodies[i]->m_uniqueID;
+				if ((uniqueID < capacity) && (states[uniqueID].m_uniqueID == uniqueID)) {
+					const dgPublishedBodyState& state = states[uniqueID];
+					if (arrays.m_posit) {
+						memcpy ((dgInt8*)arrays.m_posit + i * positStride, state.m_posit, sizeof (state.m_posit));
+					}
+					if (arrays.m_rotation) {
+						memcpy ((dgInt8*)arrays.m_rotation + i * rotationStride, state.m_rotation, sizeof (state.m_rotation));
+					}
+					if (arrays.m_veloc) {
+						memcpy ((dgInt8*)arrays.m_veloc + i * velocStride, state.m_veloc, sizeof (state.m_veloc));
+					}
+					if (arrays.m_omega) {
+						memcpy ((dgInt8*)arrays.m_omega + i * omegaStride, state.m_omega, sizeof (state.m_omega));
+					}
+					if (arrays.m_sleeping) {
+						*(dgInt32*)((dgInt8*)arrays.m_sleeping + i * sleepingStride) = state.m_sleeping;
+					}
+					found ++;
+				}
+			}
+			if (dgAtomicExchangeAndAdd (&buffer.m_sequence, 0) == sequence) {
+				return found;
+			}
+		}
+		dgThreadYield();
+	}
+}
+
 
 void dgWorld::SetFrictionThreshold (dgFloat32 acceleration)
 {
@@ -911,7 +1111,10 @@ void dgWorld::StepDynamics (dgFloat32 timestep)
 	m_inUpdate ++;
 
 	D_TRACKTIME();
+	dgUnsigned64 timeAcc = dgGetTimeInMicrosenconds();
 	UpdateSkeletons();
+	m_stats.m_islandBuildTime += (dgGetTimeInMicrosenconds() - timeAcc) * dgFloat32 (1.0e-6f);
+
 	UpdateBroadphase(timestep);
 	UpdateDynamics (timestep);
 
@@ -940,6 +1143,108 @@ void dgWorld::Execute (dgInt32 threadID)
 	dgMutexThread::Execute (threadID);
 }
 
+dgWorldSharedThreadPool::dgWorldSharedThreadPool(dgMemoryAllocator* const allocator, dgInt32 threadCount)
+	:dgThread()
+	,dgWorldThreadPool(allocator)
+	,m_updateWorlds(allocator)
+	,m_poolAllocator(allocator)
+	,m_updateTimestep(dgFloat32 (0.0f))
+	,m_updateCount(0)
+	,m_atomicCounter(0)
+{
+	// this thread is never started, the pool blocks on the worker semaphores from the calling thread
+	dgThread* const myThread = this;
+	SetParentThread (myThread);
+	SetThreadsCount (threadCount);
+}
+
+dgWorldSharedThreadPool::~dgWorldSharedThreadPool()
+{
+}
+
+dgMemoryAllocator* dgWorldSharedThreadPool::GetAllocator() const
+{
+	return m_poolAllocator;
+}
+
+void dgWorldSharedThreadPool::Execute (dgInt32 threadId)
+{
+	dgAssert (0);
+}
+
+dgInt32 dgWorldSharedThreadPool::CompareWorldPriority (dgWorld* const* const worldA, dgWorld* const* const worldB, void* const context)
+{
+	if ((*worldA)->m_threadPoolPriority > (*worldB)->m_threadPoolPriority) {
+		return -1;
+	} else if ((*worldA)->m_threadPoolPriority < (*worldB)->m_threadPoolPriority) {
+		return 1;
+	}
+	return 0;
+}
+
+void dgWorldSharedThreadPool::UpdateWorldsKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgWorldSharedThreadPool* const me = (dgWorldSharedThreadPool*) context;
+	const dgInt32 count = me->m_updateCount;
+	const dgFloat32 timestep = me->m_updateTimestep;
+	dgWorld** const worlds = &me->m_updateWorlds[0];
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&me->m_atomicCounter, 1); i < count; i = dgAtomicExchangeAndAdd(&me->m_atomicCounter, 1)) {
+		worlds[i]->UpdateInSharedThreadPool(timestep);
+	}
+}
+
+void dgWorldSharedThreadPool::Update (dgWorld** const worlds, dgInt32 count, dgFloat32 timestep)
+{
+	LockSharedSection();
+
+	m_updateWorlds.ResizeIfNecessary(count);
+	for (dgInt32 i = 0; i < count; i ++) {
+		m_updateWorlds[i] = worlds[i];
+	}
+	dgSort(&m_updateWorlds[0], count, CompareWorldPriority);
+
+	m_atomicCounter = 0;
+	m_updateCount = count;
+	m_updateTimestep = timestep;
+
+	BeginSection();
+	const dgInt32 threadCount = dgMin (GetThreadCount(), count);
+	for (dgInt32 i = 0; i < threadCount; i ++) {
+		QueueJob (UpdateWorldsKernel, this, NULL, "dgWorldSharedThreadPool::UpdateWorlds");
+	}
+	SynchronizationBarrier();
+	EndSection();
+
+	UnlockSharedSection();
+}
+
+void dgWorldSharedThreadPool::SetWorkersName (const char* const name)
+{
+	dgAssert (!IsWorkerThread());
+	LockSharedSection();
+	SetThreadsName (name);
+	UnlockSharedSection();
+}
+
+void dgWorldSharedThreadPool::SetWorkerAffinity (dgInt32 threadIndex, dgInt32 firstCpu, dgInt32 cpuCount)
+{
+	dgAssert (!IsWorkerThread());
+	LockSharedSection();
+	SetThreadAffinity (threadIndex, firstCpu, cpuCount);
+	UnlockSharedSection();
+}
+
+void dgWorld::UpdateInSharedThreadPool (dgFloat32 timestep)
+{
+	// the whole step runs on the calling worker, so the jobs of this world are executed inline
+	dgThreadHive* const sharedHive = m_sharedHive;
+	m_sharedHive = NULL;
+	m_savetimestep = timestep;
+	RunStep();
+	m_sharedHive = sharedHive;
+}
+
 void dgWorld::UpdateTransforms(dgBodyMasterList::dgListNode* node, dgInt32 threadID)
 {
 	const dgInt32 threadsCount = GetThreadCount();
@@ -950,6 +1255,26 @@ void dgWorld::UpdateTransforms(dgBodyMasterList::dgListNode* node, dgInt32 threa
 		}
 		body->m_transformIsDirty = false;
 
+		if (m_publishedStateMode) {
+			const dgQuaternion& rotation = body->m_rotation;
+			dgPublishedBodyState& state = m_publishedBuffers[m_publishedBack].m_states[body->m_uniqueID];
+			state.m_posit[0] = body->m_matrix.m_posit.m_x;
+			state.m_posit[1] = body->m_matrix.m_posit.m_y;
+			state.m_posit[2] = body->m_matrix.m_posit.m_z;
+			state.m_rotation[0] = rotation.m_x;
+			state.m_rotation[1] = rotation.m_y;
+			state.m_rotation[2] = rotation.m_z;
+			state.m_rotation[3] = rotation.m_w;
+			state.m_veloc[0] = body->m_veloc.m_x;
+			state.m_veloc[1] = body->m_veloc.m_y;
+			state.m_veloc[2] = body->m_veloc.m_z;
+			state.m_omega[0] = body->m_omega.m_x;
+			state.m_omega[1] = body->m_omega.m_y;
+			state.m_omega[2] = body->m_omega.m_z;
+			state.m_sleeping = body->m_sleeping ? 1 : 0;
+			state.m_uniqueID = body->m_uniqueID;
+		}
+
 		for (dgInt32 i = 0; i < threadsCount; i++) {
 			node = node ? node->GetNext() : NULL;
 		}
@@ -970,6 +1295,13 @@ void dgWorld::RunStep ()
 	BeginSection();
 	dgUnsigned64 timeAcc = dgGetTimeInMicrosenconds();
 
+	const dgInt32 threadsCount = GetThreadCount();
+	dgUnsigned64 threadsBusyTime[DG_MAX_THREADS_HIVE_COUNT];
+	for (dgInt32 i = 0; i < threadsCount; i++) {
+		threadsBusyTime[i] = GetThreadBusyTime(i);
+	}
+	memset (&m_stats, 0, sizeof (m_stats));
+
 	dgFloat32 step = m_savetimestep / m_numberOfSubsteps;
 	for (dgUnsigned32 i = 0; i < m_numberOfSubsteps; i ++) {
 		StepDynamics (step);
@@ -981,14 +1313,20 @@ void dgWorld::RunStep ()
 		bodyList.DestroyBodies (*this);
 	}
 
+	const dgUnsigned64 transformTime = dgGetTimeInMicrosenconds();
 	const dgBodyMasterList* const masterList = this;
 	dgBodyMasterList::dgListNode* threadNode = masterList->GetFirst();
-	const dgInt32 threadsCount = GetThreadCount();
+	if (m_publishedStateMode) {
+		BeginPublishState();
+	}
 	for (dgInt32 i = 0; i < threadsCount; i++) {
 		QueueJob(UpdateTransforms, this, threadNode, "dgWorld::UpdateTransforms");
 		threadNode = threadNode ? threadNode->GetNext() : NULL;
 	}
 	SynchronizationBarrier();
+	if (m_publishedStateMode) {
+		EndPublishState();
+	}
 
 	if (m_listeners.GetCount()) {
 		for (dgListenerList::dgListNode* node = m_listeners.GetFirst(); node; node = node->GetNext()) {
@@ -1003,7 +1341,18 @@ void dgWorld::RunStep ()
 		m_onPostUpdateCallback (this, m_savetimestep);
 	}
 
-	m_lastExecutionTime = (dgGetTimeInMicrosenconds() - timeAcc) * dgFloat32 (1.0e-6f);
+	const dgUnsigned64 endTime = dgGetTimeInMicrosenconds();
+	m_lastExecutionTime = (endTime - timeAcc) * dgFloat32 (1.0e-6f);
+
+	m_stats.m_transformTime = (endTime - transformTime) * dgFloat32 (1.0e-6f);
+	m_stats.m_updateTime = m_lastExecutionTime;
+	m_stats.m_threadsCount = threadsCount;
+	for (dgInt32 i = 0; i < threadsCount; i++) {
+		// without worker threads all jobs run on the calling thread
+		const dgFloat32 busyTime = (threadsCount > 1) ? (GetThreadBusyTime(i) - threadsBusyTime[i]) * dgFloat32 (1.0e-6f) : m_lastExecutionTime;
+		m_stats.m_threadBusyTime[i] = dgMin (busyTime, m_lastExecutionTime);
+		m_stats.m_threadIdleTime[i] = m_lastExecutionTime - m_stats.m_threadBusyTime[i];
+	}
 	EndSection();
 }
 
@@ -1382,6 +1731,7 @@ void dgWorld::UpdateSkeletons()
 	for (iter.Begin(); iter; iter++) {
 		dgSkeletonContainer* const skeleton = iter.GetNode()->GetInfo();
 		skeleton->ClearSelfCollision();
+		skeleton->UpdateLod();
 	}
 }
 
@@ -1642,6 +1992,1072 @@ void dgWorld::DeserializeScene(void* const userData, OnBodyDeserialize bodyCallb
 	}
 }
 
+#define DG_SNAPSHOT_SIGNATURE	0x70616e73
+#define DG_SNAPSHOT_VERSION		2
+
+#define DG_SNAPSHOT_BODY_FREEZE			(1<<0)
+#define DG_SNAPSHOT_BODY_RESTING		(1<<1)
+#define DG_SNAPSHOT_BODY_SLEEPING		(1<<2)
+#define DG_SNAPSHOT_BODY_EQUILIBRIUM	(1<<3)
+
+#define DG_SNAPSHOT_CONTACT_ACTIVE		(1<<0)
+#define DG_SNAPSHOT_CONTACT_KILL		(1<<1)
+#define DG_SNAPSHOT_CONTACT_NEW			(1<<2)
+#define DG_SNAPSHOT_CONTACT_INTRA		(1<<3)
+#define DG_SNAPSHOT_CONTACT_SELF		(1<<4)
+
+// a snapshot is a flat image made of these sections, in this order: 
+// header, body unique IDs, body states, contact states, contact points, 
+// per body contact order and bilateral joint states.
+class dgWorldSnapshotHeader
+{
+	public:
+	dgInt32 m_signature;
+	dgInt32 m_version;
+	dgInt32 m_size;
+	dgInt32 m_bodyCount;
+	dgInt32 m_contactCount;
+	dgInt32 m_contactPointCount;
+	dgInt32 m_jointCount;
+	dgUnsigned32 m_broadPhaseLru;
+};
+
+DG_MSC_VECTOR_ALIGMENT
+class dgWorldSnapshotBody
+{
+	public:
+	dgMatrix m_matrix;
+	dgMatrix m_invWorldInertiaMatrix;
+	dgQuaternion m_rotation;
+	dgQuaternion m_gyroRotation;
+	dgVector m_veloc;
+	dgVector m_omega;
+	dgVector m_accel;
+	dgVector m_alpha;
+	dgVector m_minAABB;
+	dgVector m_maxAABB;
+	dgVector m_nodeMinBox;
+	dgVector m_nodeMaxBox;
+	dgVector m_globalCentreOfMass;
+	dgVector m_impulseForce;
+	dgVector m_impulseTorque;
+	dgVector m_gyroAlpha;
+	dgVector m_gyroTorque;
+	dgVector m_externalForce;
+	dgVector m_externalTorque;
+	dgVector m_savedExternalForce;
+	dgVector m_savedExternalTorque;
+	dgVector m_cachedDampCoef;
+	dgFloat32 m_cachedTimeStep;
+	dgInt32 m_sleepingCounter;
+	dgInt32 m_rowContactCount;
+	dgInt32 m_flags;
+} DG_GCC_VECTOR_ALIGMENT;
+
+DG_MSC_VECTOR_ALIGMENT
+class dgWorldSnapshotContact
+{
+	public:
+	dgVector m_positAcc;
+	dgQuaternion m_rotationAcc;
+	dgVector m_separtingVector;
+	dgFloat32 m_closestDistance;
+	dgFloat32 m_separationDistance;
+	dgFloat32 m_timeOfImpact;
+	dgFloat32 m_impulseSpeed;
+	dgUnsigned32 m_broadphaseLru;
+	dgInt32 m_body0;
+	dgInt32 m_body1;
+	dgInt32 m_pointCount;
+	dgInt32 m_maxDOF;
+	dgInt32 m_flags;
+} DG_GCC_VECTOR_ALIGMENT;
+
+class dgWorldSnapshotJoint
+{
+	public:
+	dgForceImpactPair m_jointForce[DG_BILATERAL_CONTRAINT_DOF];
+	dgFloat32 m_motorAcceleration[DG_BILATERAL_CONTRAINT_DOF];
+	dgFloat32 m_inverseDynamicsAcceleration[DG_BILATERAL_CONTRAINT_DOF];
+	dgInt32 m_body0;
+	dgInt32 m_body1;
+};
+
+// the shapes of a contact point are saved as a sub shape index of the body collision, -1 is the body collision itself
+static dgInt32 dgSnapshotShapeIndex (const dgCollisionInstance* const bodyCollision, const dgCollisionInstance* const shape)
+{
+	if ((shape != bodyCollision) && bodyCollision->IsType(dgCollision::dgCollisionCompound_RTTI)) {
+		const dgCollisionCompound* const compound = (dgCollisionCompound*)bodyCollision->GetChildShape();
+		for (dgCollisionCompound::dgTreeArray::dgTreeNode* node = compound->GetFirstNode(); node; node = compound->GetNextNode(node)) {
+			if (compound->GetCollisionFromNode(node) == shape) {
+				return compound->GetNodeIndex(node);
+			}
+		}
+	}
+	return -1;
+}
+
+static const dgCollisionInstance* dgSnapshotShape (const dgCollisionInstance* const bodyCollision, dgInt32 index)
+{
+	if (index < 0) {
+		return bodyCollision;
+	}
+	if (!bodyCollision->IsType(dgCollision::dgCollisionCompound_RTTI)) {
+		return NULL;
+	}
+	const dgCollisionCompound* const compound = (dgCollisionCompound*)bodyCollision->GetChildShape();
+	dgCollisionCompound::dgTreeArray::dgTreeNode* const node = compound->FindNodeByIndex(index);
+	return node ? compound->GetCollisionFromNode(node) : NULL;
+}
+
+dgInt32 dgWorld::GetSnapshotSize() const
+{
+	const dgContactList& contactList = *this;
+	dgInt32 pointCount = 0;
+	for (dgInt32 i = 0; i < contactList.m_contactCount; i++) {
+		pointCount += contactList[i]->GetCount();
+	}
+
+	const dgInt32 bodyCount = dgBodyMasterList::GetCount() - 1;
+	const dgInt32 jointCount = dgBilateralConstraintList::GetCount();
+	dgInt32 size = sizeof (dgWorldSnapshotHeader);
+	size += bodyCount * (sizeof (dgInt32) + sizeof (dgWorldSnapshotBody));
+	size += contactList.m_contactCount * (sizeof (dgWorldSnapshotContact) + 2 * sizeof (dgInt32));
+	size += pointCount * (sizeof (dgContactMaterial) + 2 * sizeof (dgInt32));
+	size += jointCount * sizeof (dgWorldSnapshotJoint);
+	return size;
+}
+
+dgInt32 dgWorld::SaveSnapshot(void* const buffer, dgInt32 bufferSize) const
+{
+	dgAssert (!m_inUpdate);
+	const dgInt32 size = GetSnapshotSize();
+	if (size > bufferSize) {
+		return 0;
+	}
+
+	const dgContactList& contactList = *this;
+	const dgBodyMasterList& masterList = *this;
+	const dgBilateralConstraintList& jointList = *this;
+
+	dgWorldSnapshotHeader header;
+	header.m_signature = DG_SNAPSHOT_SIGNATURE;
+	header.m_version = DG_SNAPSHOT_VERSION;
+	header.m_size = size;
+	header.m_bodyCount = masterList.GetCount() - 1;
+	header.m_contactCount = contactList.m_contactCount;
+	header.m_contactPointCount = 0;
+	header.m_jointCount = jointList.GetCount();
+	header.m_broadPhaseLru = m_broadPhase->m_lru;
+	for (dgInt32 i = 0; i < contactList.m_contactCount; i++) {
+		header.m_contactPointCount += contactList[i]->GetCount();
+	}
+
+	dgInt8* const base = (dgInt8*)buffer;
+	dgInt8* uniqueIDs = base + sizeof (dgWorldSnapshotHeader);
+	dgInt8* bodies = uniqueIDs + header.m_bodyCount * sizeof (dgInt32);
+	dgInt8* contacts = bodies + header.m_bodyCount * sizeof (dgWorldSnapshotBody);
+	dgInt8* points = contacts + header.m_contactCount * sizeof (dgWorldSnapshotContact);
+	dgInt8* shapes = points + header.m_contactPointCount * sizeof (dgContactMaterial);
+	dgInt8* rows = shapes + header.m_contactPointCount * 2 * sizeof (dgInt32);
+	dgInt8* joints = rows + header.m_contactCount * 2 * sizeof (dgInt32);
+	memcpy (base, &header, sizeof (dgWorldSnapshotHeader));
+
+	for (dgInt32 i = 0; i < contactList.m_contactCount; i++) {
+		contactList[i]->m_index = dgUnsigned32 (i);
+	}
+
+	dgInt32 bodyIndex = 0;
+	for (dgBodyMasterList::dgListNode* node = masterList.GetFirst()->GetNext(); node; node = node->GetNext()) {
+		const dgBodyMasterListRow& row = node->GetInfo();
+		dgBody* const body = row.GetBody();
+		body->m_serializedEnum = bodyIndex;
+		bodyIndex ++;
+
+		dgWorldSnapshotBody record;
+		record.m_matrix = body->m_matrix;
+		record.m_invWorldInertiaMatrix = body->m_invWorldInertiaMatrix;
+		record.m_rotation = body->m_rotation;
+		record.m_gyroRotation = body->m_gyroRotation;
+		record.m_veloc = body->m_veloc;
+		record.m_omega = body->m_omega;
+		record.m_accel = body->m_accel;
+		record.m_alpha = body->m_alpha;
+		record.m_minAABB = body->m_minAABB;
+		record.m_maxAABB = body->m_maxAABB;
+		record.m_nodeMinBox = body->m_minAABB;
+		record.m_nodeMaxBox = body->m_maxAABB;
+		if (body->GetBroadPhase()) {
+			record.m_nodeMinBox = body->GetBroadPhase()->m_minBox;
+			record.m_nodeMaxBox = body->GetBroadPhase()->m_maxBox;
+		}
+		record.m_globalCentreOfMass = body->m_globalCentreOfMass;
+		record.m_impulseForce = body->m_impulseForce;
+		record.m_impulseTorque = body->m_impulseTorque;
+		record.m_gyroAlpha = body->m_gyroAlpha;
+		record.m_gyroTorque = body->m_gyroTorque;
+		record.m_externalForce = dgVector::m_zero;
+		record.m_externalTorque = dgVector::m_zero;
+		record.m_savedExternalForce = dgVector::m_zero;
+		record.m_savedExternalTorque = dgVector::m_zero;
+		record.m_cachedDampCoef = dgVector::m_zero;
+		record.m_cachedTimeStep = dgFloat32 (0.0f);
+		record.m_sleepingCounter = 0;
+		if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
+			const dgDynamicBody* const dynBody = (dgDynamicBody*)body;
+			record.m_externalForce = dynBody->m_externalForce;
+			record.m_externalTorque = dynBody->m_externalTorque;
+			record.m_savedExternalForce = dynBody->m_savedExternalForce;
+			record.m_savedExternalTorque = dynBody->m_savedExternalTorque;
+			record.m_cachedDampCoef = dynBody->m_cachedDampCoef;
+			record.m_cachedTimeStep = dynBody->m_cachedTimeStep;
+			record.m_sleepingCounter = dynBody->m_sleepingCounter;
+		}
+
+		record.m_flags = (body->m_freeze ? DG_SNAPSHOT_BODY_FREEZE : 0) | (body->m_resting ? DG_SNAPSHOT_BODY_RESTING : 0) | 
+						 (body->m_sleeping ? DG_SNAPSHOT_BODY_SLEEPING : 0) | (body->m_equilibrium ? DG_SNAPSHOT_BODY_EQUILIBRIUM : 0);
+
+		// the solver walks the body rows, so the order of the contacts in each row is part of the state
+		record.m_rowContactCount = 0;
+		for (dgBodyMasterListRow::dgListNode* link = row.GetFirst(); link; link = link->GetNext()) {
+			const dgConstraint* const joint = link->GetInfo().m_joint;
+			if (joint->GetId() == dgConstraint::m_contactConstraint) {
+				const dgInt32 index = dgInt32 (joint->m_index);
+				memcpy (rows, &index, sizeof (dgInt32));
+				rows += sizeof (dgInt32);
+				record.m_rowContactCount ++;
+			}
+		}
+
+		memcpy (uniqueIDs, &body->m_uniqueID, sizeof (dgInt32));
+		memcpy (bodies, &record, sizeof (dgWorldSnapshotBody));
+		uniqueIDs += sizeof (dgInt32);
+		bodies += sizeof (dgWorldSnapshotBody);
+	}
+
+	for (dgInt32 i = 0; i < contactList.m_contactCount; i++) {
+		const dgContact* const contact = contactList[i];
+		dgWorldSnapshotContact record;
+		record.m_positAcc = contact->m_positAcc;
+		record.m_rotationAcc = contact->m_rotationAcc;
+		record.m_separtingVector = contact->m_separtingVector;
+		record.m_closestDistance = contact->m_closestDistance;
+		record.m_separationDistance = contact->m_separationDistance;
+		record.m_timeOfImpact = contact->m_timeOfImpact;
+		record.m_impulseSpeed = contact->m_impulseSpeed;
+		record.m_broadphaseLru = contact->m_broadphaseLru;
+		record.m_body0 = contact->m_body0->m_serializedEnum;
+		record.m_body1 = contact->m_body1->m_serializedEnum;
+		record.m_pointCount = contact->GetCount();
+		record.m_maxDOF = contact->m_maxDOF;
+		record.m_flags = (contact->m_isActive ? DG_SNAPSHOT_CONTACT_ACTIVE : 0) | (contact->m_killContact ? DG_SNAPSHOT_CONTACT_KILL : 0) | 
+						 (contact->m_isNewContact ? DG_SNAPSHOT_CONTACT_NEW : 0) | (contact->m_skeletonIntraCollision ? DG_SNAPSHOT_CONTACT_INTRA : 0) |
+						 (contact->m_skeletonSelftCollision ? DG_SNAPSHOT_CONTACT_SELF : 0);
+		memcpy (contacts, &record, sizeof (dgWorldSnapshotContact));
+		contacts += sizeof (dgWorldSnapshotContact);
+
+		for (dgContact::dgListNode* pointNode = contact->GetFirst(); pointNode; pointNode = pointNode->GetNext()) {
+			const dgContactMaterial& point = pointNode->GetInfo();
+			const dgInt32 shapeIndex[2] = {dgSnapshotShapeIndex (contact->m_body0->m_collision, point.m_collision0), dgSnapshotShapeIndex (contact->m_body1->m_collision, point.m_collision1)};
+			memcpy (points, &point, sizeof (dgContactMaterial));
+			memcpy (shapes, shapeIndex, sizeof (shapeIndex));
+			points += sizeof (dgContactMaterial);
+			shapes += sizeof (shapeIndex);
+		}
+	}
+
+	for (dgBilateralConstraintList::dgListNode* node = jointList.GetFirst(); node; node = node->GetNext()) {
+		const dgBilateralConstraint* const joint = node->GetInfo();
+		dgWorldSnapshotJoint record;
+		memcpy (record.m_jointForce, joint->m_jointForce, sizeof (record.m_jointForce));
+		memcpy (record.m_motorAcceleration, joint->m_motorAcceleration, sizeof (record.m_motorAcceleration));
+		memcpy (record.m_inverseDynamicsAcceleration, joint->m_inverseDynamicsAcceleration, sizeof (record.m_inverseDynamicsAcceleration));
+		record.m_body0 = joint->m_body0 ? joint->m_body0->m_uniqueID : -1;
+		record.m_body1 = joint->m_body1 ? joint->m_body1->m_uniqueID : -1;
+		memcpy (joints, &record, sizeof (dgWorldSnapshotJoint));
+		joints += sizeof (dgWorldSnapshotJoint);
+	}
+	dgAssert ((joints - base) == size);
+
+	for (dgBodyMasterList::dgListNode* node = masterList.GetFirst()->GetNext(); node; node = node->GetNext()) {
+		node->GetInfo().GetBody()->m_serializedEnum = -1;
+	}
+	return size;
+}
+
+bool dgWorld::RestoreSnapshot(const void* const buffer, dgInt32 bufferSize)
+{
+	dgAssert (!m_inUpdate);
+	if (bufferSize < dgInt32 (sizeof (dgWorldSnapshotHeader))) {
+		return false;
+	}
+
+	dgWorldSnapshotHeader header;
+	const dgInt8* const base = (dgInt8*)buffer;
+	memcpy (&header, base, sizeof (dgWorldSnapshotHeader));
+
+	dgBodyMasterList& masterList = *this;
+	dgContactList& contactList = *this;
+	dgBilateralConstraintList& jointList = *this;
+	if ((header.m_signature != DG_SNAPSHOT_SIGNATURE) || (header.m_version != DG_SNAPSHOT_VERSION) || (header.m_size > bufferSize)) {
+		return false;
+	}
+	if ((header.m_bodyCount != (masterList.GetCount() - 1)) || (header.m_jointCount != jointList.GetCount())) {
+		return false;
+	}
+	if ((header.m_contactCount < 0) || (header.m_contactPointCount < 0)) {
+		return false;
+	}
+
+	const dgInt8* uniqueIDs = base + sizeof (dgWorldSnapshotHeader);
+	const dgInt8* bodies = uniqueIDs + header.m_bodyCount * sizeof (dgInt32);
+	const dgInt8* contacts = bodies + header.m_bodyCount * sizeof (dgWorldSnapshotBody);
+	const dgInt8* points = contacts + header.m_contactCount * sizeof (dgWorldSnapshotContact);
+	const dgInt8* shapes = points + header.m_contactPointCount * sizeof (dgContactMaterial);
+	const dgInt8* rows = shapes + header.m_contactPointCount * 2 * sizeof (dgInt32);
+	const dgInt8* joints = rows + header.m_contactCount * 2 * sizeof (dgInt32);
+	if ((joints + header.m_jointCount * sizeof (dgWorldSnapshotJoint) - base) != header.m_size) {
+		return false;
+	}
+
+	// match the snapshot bodies to the world bodies, this is a linear walk unless the master list was reordered
+	dgStack<dgBody*> bodyArray(dgMax (header.m_bodyCount, 1));
+	dgInt32 bodyIndex = 0;
+	for (dgBodyMasterList::dgListNode* node = masterList.GetFirst()->GetNext(); node; node = node->GetNext()) {
+		dgInt32 uniqueID;
+		memcpy (&uniqueID, uniqueIDs + bodyIndex * sizeof (dgInt32), sizeof (dgInt32));
+		dgBody* const body = node->GetInfo().GetBody();
+		if (body->m_uniqueID != uniqueID) {
+			break;
+		}
+		bodyArray[bodyIndex] = body;
+		bodyIndex ++;
+	}
+	if (bodyIndex != header.m_bodyCount) {
+		dgTree<dgBody*, dgInt32> bodyMap(GetAllocator());
+		for (dgBodyMasterList::dgListNode* node = masterList.GetFirst()->GetNext(); node; node = node->GetNext()) {
+			dgBody* const body = node->GetInfo().GetBody();
+			bodyMap.Insert(body, body->m_uniqueID);
+		}
+		for (; bodyIndex < header.m_bodyCount; bodyIndex ++) {
+			dgInt32 uniqueID;
+			memcpy (&uniqueID, uniqueIDs + bodyIndex * sizeof (dgInt32), sizeof (dgInt32));
+			dgTree<dgBody*, dgInt32>::dgTreeNode* const mapNode = bodyMap.Find(uniqueID);
+			if (!mapNode) {
+				return false;
+			}
+			bodyArray[bodyIndex] = mapNode->GetInfo();
+		}
+	}
+
+	const dgInt8* jointPtr = joints;
+	for (dgBilateralConstraintList::dgListNode* node = jointList.GetFirst(); node; node = node->GetNext()) {
+		const dgBilateralConstraint* const joint = node->GetInfo();
+		dgWorldSnapshotJoint record;
+		memcpy (&record, jointPtr, sizeof (dgWorldSnapshotJoint));
+		jointPtr += sizeof (dgWorldSnapshotJoint);
+		const dgInt32 body0 = joint->m_body0 ? joint->m_body0->m_uniqueID : -1;
+		const dgInt32 body1 = joint->m_body1 ? joint->m_body1->m_uniqueID : -1;
+		if ((body0 != record.m_body0) || (body1 != record.m_body1)) {
+			return false;
+		}
+	}
+
+	// check every index in the snapshot before anything in the world is changed
+	dgInt32 pointCount = 0;
+	const dgBodyMaterialList* const materialList = this;
+	dgTree<dgInt32, dgUnsigned64> pairMap(GetAllocator());
+	for (dgInt32 i = 0; i < header.m_contactCount; i ++) {
+		dgWorldSnapshotContact record;
+		memcpy (&record, contacts + i * sizeof (dgWorldSnapshotContact), sizeof (dgWorldSnapshotContact));
+		if ((record.m_body0 < 0) || (record.m_body0 >= header.m_bodyCount) || (record.m_body1 < 0) || (record.m_body1 >= header.m_bodyCount) || (record.m_body0 == record.m_body1)) {
+			return false;
+		}
+		if ((record.m_pointCount < 0) || (record.m_pointCount > (header.m_contactPointCount - pointCount))) {
+			return false;
+		}
+		if ((record.m_maxDOF < 0) || (record.m_maxDOF > 3 * record.m_pointCount)) {
+			return false;
+		}
+		// the sub shapes of the points must exist in the collisions of the bodies
+		for (dgInt32 j = 0; j < record.m_pointCount; j ++) {
+			dgInt32 shapeIndex[2];
+			memcpy (shapeIndex, shapes + (pointCount + j) * sizeof (shapeIndex), sizeof (shapeIndex));
+			if (!dgSnapshotShape (bodyArray[record.m_body0]->m_collision, shapeIndex[0]) || !dgSnapshotShape (bodyArray[record.m_body1]->m_collision, shapeIndex[1])) {
+				return false;
+			}
+		}
+		pointCount += record.m_pointCount;
+
+		// a pair can only have one contact joint
+		const dgUnsigned64 pairKey = (dgUnsigned64 (dgMin (record.m_body0, record.m_body1)) << 32) + dgUnsigned64 (dgMax (record.m_body0, record.m_body1));
+		if (!pairMap.Insert(i, pairKey)) {
+			return false;
+		}
+
+		dgUnsigned32 group0_ID = dgUnsigned32 (bodyArray[record.m_body0]->m_bodyGroupId);
+		dgUnsigned32 group1_ID = dgUnsigned32 (bodyArray[record.m_body1]->m_bodyGroupId);
+		if (group1_ID < group0_ID) {
+			dgSwap (group0_ID, group1_ID);
+		}
+		if (!materialList->Find ((group1_ID << 16) + group0_ID)) {
+			return false;
+		}
+	}
+	if (pointCount != header.m_contactPointCount) {
+		return false;
+	}
+
+	dgInt32 rowIndex = 0;
+	for (dgInt32 i = 0; i < header.m_bodyCount; i ++) {
+		dgWorldSnapshotBody record;
+		memcpy (&record, bodies + i * sizeof (dgWorldSnapshotBody), sizeof (dgWorldSnapshotBody));
+		if ((record.m_rowContactCount < 0) || (record.m_rowContactCount > (2 * header.m_contactCount - rowIndex))) {
+			return false;
+		}
+		for (dgInt32 j = 0; j < record.m_rowContactCount; j ++) {
+			dgInt32 index;
+			memcpy (&index, rows + (rowIndex + j) * sizeof (dgInt32), sizeof (dgInt32));
+			if ((index < 0) || (index >= header.m_contactCount)) {
+				return false;
+			}
+			// the contact must be attached to this body, otherwise it has no link in the body row
+			dgWorldSnapshotContact contactRecord;
+			memcpy (&contactRecord, contacts + index * sizeof (dgWorldSnapshotContact), sizeof (dgWorldSnapshotContact));
+			if ((contactRecord.m_body0 != i) && (contactRecord.m_body1 != i)) {
+				return false;
+			}
+		}
+		rowIndex += record.m_rowContactCount;
+	}
+	if (rowIndex != 2 * header.m_contactCount) {
+		return false;
+	}
+
+	// from here on the snapshot is known to match this world
+	dgStack<dgInt32> rowContactCount(dgMax (header.m_bodyCount, 1));
+	for (dgInt32 i = 0; i < header.m_bodyCount; i ++) {
+		dgBody* const body = bodyArray[i];
+		dgWorldSnapshotBody record;
+		memcpy (&record, bodies, sizeof (dgWorldSnapshotBody));
+		bodies += sizeof (dgWorldSnapshotBody);
+
+		body->m_matrix = record.m_matrix;
+		body->m_invWorldInertiaMatrix = record.m_invWorldInertiaMatrix;
+		body->m_rotation = record.m_rotation;
+		body->m_gyroRotation = record.m_gyroRotation;
+		body->m_veloc = record.m_veloc;
+		body->m_omega = record.m_omega;
+		body->m_accel = record.m_accel;
+		body->m_alpha = record.m_alpha;
+		body->m_minAABB = record.m_minAABB;
+		body->m_maxAABB = record.m_maxAABB;
+		body->m_globalCentreOfMass = record.m_globalCentreOfMass;
+		body->m_impulseForce = record.m_impulseForce;
+		body->m_impulseTorque = record.m_impulseTorque;
+		body->m_gyroAlpha = record.m_gyroAlpha;
+		body->m_gyroTorque = record.m_gyroTorque;
+		body->m_freeze = (record.m_flags & DG_SNAPSHOT_BODY_FREEZE) ? 1 : 0;
+		body->m_resting = (record.m_flags & DG_SNAPSHOT_BODY_RESTING) ? 1 : 0;
+		body->m_sleeping = (record.m_flags & DG_SNAPSHOT_BODY_SLEEPING) ? 1 : 0;
+		body->m_equilibrium = (record.m_flags & DG_SNAPSHOT_BODY_EQUILIBRIUM) ? 1 : 0;
+		body->m_transformIsDirty = 1;
+		if (body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
+			dgDynamicBody* const dynBody = (dgDynamicBody*)body;
+			dynBody->m_externalForce = record.m_externalForce;
+			dynBody->m_externalTorque = record.m_externalTorque;
+			dynBody->m_savedExternalForce = record.m_savedExternalForce;
+			dynBody->m_savedExternalTorque = record.m_savedExternalTorque;
+			dynBody->m_cachedDampCoef = record.m_cachedDampCoef;
+			dynBody->m_cachedTimeStep = record.m_cachedTimeStep;
+			dynBody->m_sleepingCounter = record.m_sleepingCounter;
+		}
+		rowContactCount[i] = record.m_rowContactCount;
+		body->UpdateWorlCollisionMatrix();
+		m_broadPhase->RestoreBodyBox(body, record.m_nodeMinBox, record.m_nodeMaxBox);
+	}
+
+	// reuse the contacts that still exist, create the missing ones and delete the ones the snapshot does not have
+	for (dgInt32 i = 0; i < contactList.m_contactCount; i ++) {
+		contactList[i]->m_graphTagged = 0;
+	}
+
+	dgStack<dgContact*> contactArray(dgMax (header.m_contactCount, 1));
+	for (dgInt32 i = 0; i < header.m_contactCount; i ++) {
+		dgWorldSnapshotContact record;
+		memcpy (&record, contacts, sizeof (dgWorldSnapshotContact));
+		contacts += sizeof (dgWorldSnapshotContact);
+
+		dgBody* const body0 = bodyArray[record.m_body0];
+		dgBody* const body1 = bodyArray[record.m_body1];
+		dgContact* contact = m_broadPhase->m_contactCache.FindContactJoint(body0, body1);
+		if (!contact) {
+			dgUnsigned32 group0_ID = dgUnsigned32 (body0->m_bodyGroupId);
+			dgUnsigned32 group1_ID = dgUnsigned32 (body1->m_bodyGroupId);
+			if (group1_ID < group0_ID) {
+				dgSwap (group0_ID, group1_ID);
+			}
+			dgUnsigned32 key = (group1_ID << 16) + group0_ID;
+			dgAssert (materialList->Find (key));
+			const dgContactMaterial* const material = &materialList->Find (key)->GetInfo();
+
+			contact = new (m_allocator) dgContact(this, material, body0, body1);
+			if (contact->m_body0 != body0) {
+				contact->SwapBodies();
+			}
+			m_broadPhase->m_contactCache.AddContactJoint(contact);
+			AttachContact(contact);
+		} else if (contact->m_body0 != body0) {
+			contact->SwapBodies();
+		}
+		dgAssert (!contact->m_graphTagged);
+		dgAssert ((contact->m_body0 == body0) && (contact->m_body1 == body1));
+
+		contact->m_graphTagged = 1;
+		contact->m_positAcc = record.m_positAcc;
+		contact->m_rotationAcc = record.m_rotationAcc;
+		contact->m_separtingVector = record.m_separtingVector;
+		contact->m_closestDistance = record.m_closestDistance;
+		contact->m_separationDistance = record.m_separationDistance;
+		contact->m_timeOfImpact = record.m_timeOfImpact;
+		contact->m_impulseSpeed = record.m_impulseSpeed;
+		contact->m_broadphaseLru = record.m_broadphaseLru;
+		contact->m_maxDOF = dgUnsigned32 (record.m_maxDOF);
+		contact->m_isActive = (record.m_flags & DG_SNAPSHOT_CONTACT_ACTIVE) ? 1 : 0;
+		contact->m_killContact = (record.m_flags & DG_SNAPSHOT_CONTACT_KILL) ? 1 : 0;
+		contact->m_isNewContact = (record.m_flags & DG_SNAPSHOT_CONTACT_NEW) ? 1 : 0;
+		contact->m_skeletonIntraCollision = (record.m_flags & DG_SNAPSHOT_CONTACT_INTRA) ? 1 : 0;
+		contact->m_skeletonSelftCollision = (record.m_flags & DG_SNAPSHOT_CONTACT_SELF) ? 1 : 0;
+
+		dgContact::dgListNode* pointNode = contact->GetFirst();
+		for (dgInt32 j = 0; j < record.m_pointCount; j ++) {
+			if (!pointNode) {
+				pointNode = contact->Append();
+			}
+			// the saved pointers are not trusted, the points are bound to the bodies of the restored contact 
+			// and to the shapes found by their saved sub shape index
+			dgContactMaterial& point = pointNode->GetInfo();
+			dgInt32 shapeIndex[2];
+			memcpy (&point, points, sizeof (dgContactMaterial));
+			memcpy (shapeIndex, shapes, sizeof (shapeIndex));
+			point.m_body0 = body0;
+			point.m_body1 = body1;
+			point.m_collision0 = dgSnapshotShape (body0->m_collision, shapeIndex[0]);
+			point.m_collision1 = dgSnapshotShape (body1->m_collision, shapeIndex[1]);
+			points += sizeof (dgContactMaterial);
+			shapes += sizeof (shapeIndex);
+			pointNode = pointNode->GetNext();
+		}
+		while (pointNode) {
+			dgContact::dgListNode* const nextNode = pointNode->GetNext();
+			contact->Remove(pointNode);
+			pointNode = nextNode;
+		}
+		contactArray[i] = contact;
+	}
+
+	for (dgInt32 i = 0; i < contactList.m_contactCount; i ++) {
+		dgContact* const contact = contactList[i];
+		if (!contact->m_graphTagged) {
+			m_broadPhase->m_contactCache.RemoveContactJoint(contact);
+			RemoveContact(contact);
+			delete contact;
+		}
+	}
+
+	if (header.m_contactCount > contactList.GetElementsCapacity()) {
+		contactList.Resize(header.m_contactCount * 2);
+	}
+	for (dgInt32 i = 0; i < header.m_contactCount; i ++) {
+		dgContact* const contact = contactArray[i];
+		contact->m_graphTagged = 0;
+		contactList[i] = contact;
+	}
+	contactList.m_contactCount = header.m_contactCount;
+	contactList.m_contactCountReset = header.m_contactCount;
+
+	for (dgInt32 i = 0; i < header.m_bodyCount; i ++) {
+		dgBody* const body = bodyArray[i];
+		dgBodyMasterListRow& row = body->m_masterNode->GetInfo();
+		for (dgInt32 j = rowContactCount[i] - 1; j >= 0; j --) {
+			dgInt32 index;
+			memcpy (&index, rows + j * sizeof (dgInt32), sizeof (dgInt32));
+			dgContact* const contact = contactArray[index];
+			row.RotateToBegin((contact->m_body0 == body) ? contact->m_link0 : contact->m_link1);
+		}
+		rows += rowContactCount[i] * sizeof (dgInt32);
+	}
+
+	for (dgBilateralConstraintList::dgListNode* node = jointList.GetFirst(); node; node = node->GetNext()) {
+		dgBilateralConstraint* const joint = node->GetInfo();
+		dgWorldSnapshotJoint record;
+		memcpy (&record, joints, sizeof (dgWorldSnapshotJoint));
+		joints += sizeof (dgWorldSnapshotJoint);
+		memcpy (joint->m_jointForce, record.m_jointForce, sizeof (record.m_jointForce));
+		memcpy (joint->m_motorAcceleration, record.m_motorAcceleration, sizeof (record.m_motorAcceleration));
+		memcpy (joint->m_inverseDynamicsAcceleration, record.m_inverseDynamicsAcceleration, sizeof (record.m_inverseDynamicsAcceleration));
+	}
+
+	m_broadPhase->m_lru = header.m_broadPhaseLru;
+	return true;
+}
+
+#define DG_STATE_BASELINE_SIGNATURE		0x6c736162
+#define DG_STATE_DELTA_SIGNATURE		0x746c6564
+#define DG_STATE_DELTA_SLEEPING			(1<<0)
+#define DG_STATE_DELTA_ROTATION_BITS	10
+#define DG_STATE_DELTA_ROTATION_MAX		((1<<DG_STATE_DELTA_ROTATION_BITS) - 1)
+
+// the baseline stays on the sender, it holds the values the receiver has for each body, 
+// already rounded to the streamed precision so that quantization errors do not accumulate
+class dgStateBaselineHeader
+{
+	public:
+	dgInt32 m_signature;
+	dgInt32 m_bodyCount;
+	dgFloat32 m_positionPrecision;
+	dgFloat32 m_velocityPrecision;
+};
+
+class dgStateBaselineBody
+{
+	public:
+	dgInt32 m_uniqueID;
+	dgInt32 m_flags;
+	dgFloat32 m_posit[3];
+	dgFloat32 m_rotation[4];
+	dgFloat32 m_veloc[3];
+	dgFloat32 m_omega[3];
+};
+
+// the delta is what goes over the wire, a header followed by packed records of 
+// unique ID, quantized position, smallest three rotation, quantized velocities and flags
+class dgStateDeltaHeader
+{
+	public:
+	dgInt32 m_signature;
+	dgInt32 m_count;
+	dgFloat32 m_positionPrecision;
+	dgFloat32 m_velocityPrecision;
+};
+
+#define DG_STATE_DELTA_RECORD_SIZE	(4 + 3 * 4 + 4 + 6 * 2 + 1)
+
+static DG_INLINE dgInt32 dgQuantize(dgFloat32 value, dgFloat32 invStep, dgFloat32 maxValue)
+{
+	return dgInt32 (dgFloor(dgClamp(value * invStep, -maxValue, maxValue) + dgFloat32 (0.5f)));
+}
+
+static DG_INLINE dgUnsigned32 dgEncodeSmallestThree(const dgQuaternion& rotation)
+{
+	const dgFloat32 q[4] = {rotation.m_x, rotation.m_y, rotation.m_z, rotation.m_w};
+	dgInt32 largest = 0;
+	for (dgInt32 i = 1; i < 4; i ++) {
+		if (dgAbs(q[i]) > dgAbs(q[largest])) {
+			largest = i;
+		}
+	}
+	// q and -q are the same rotation, flip it so that the dropped component is positive
+	const dgFloat32 sign = (q[largest] < dgFloat32 (0.0f)) ? dgFloat32 (-1.0f) : dgFloat32 (1.0f);
+	const dgFloat32 scale = dgFloat32 (0.5f) * dgFloat32 (DG_STATE_DELTA_ROTATION_MAX) * dgFloat32 (1.41421356f);
+
+	dgUnsigned32 code = dgUnsigned32 (largest);
+	for (dgInt32 i = 0; i < 4; i ++) {
+		if (i != largest) {
+			const dgFloat32 value = q[i] * sign * scale + dgFloat32 (0.5f) * dgFloat32 (DG_STATE_DELTA_ROTATION_MAX);
+			const dgInt32 bits = dgClamp (dgInt32 (dgFloor(value + dgFloat32 (0.5f))), 0, DG_STATE_DELTA_ROTATION_MAX);
+			code = (code << DG_STATE_DELTA_ROTATION_BITS) | dgUnsigned32 (bits);
+		}
+	}
+	return code;
+}
+
+static DG_INLINE dgQuaternion dgDecodeSmallestThree(dgUnsigned32 code)
+{
+	const dgFloat32 scale = dgFloat32 (2.0f) / (dgFloat32 (DG_STATE_DELTA_ROTATION_MAX) * dgFloat32 (1.41421356f));
+	const dgInt32 largest = dgInt32 (code >> (3 * DG_STATE_DELTA_ROTATION_BITS));
+
+	dgFloat32 q[4];
+	dgFloat32 mag2 = dgFloat32 (0.0f);
+	for (dgInt32 i = 3; i >= 0; i --) {
+		if (i != largest) {
+			const dgInt32 bits = dgInt32 (code & DG_STATE_DELTA_ROTATION_MAX);
+			code >>= DG_STATE_DELTA_ROTATION_BITS;
+			q[i] = (dgFloat32 (bits) - dgFloat32 (0.5f) * dgFloat32 (DG_STATE_DELTA_ROTATION_MAX)) * scale;
+			mag2 += q[i] * q[i];
+		}
+	}
+	q[largest] = dgSqrt (dgMax (dgFloat32 (1.0f) - mag2, dgFloat32 (0.0f)));
+
+	dgQuaternion rotation (q[3], q[0], q[1], q[2]);
+	rotation.Normalize();
+	return rotation;
+}
+
+dgInt32 dgWorld::GetStateBaselineSize() const
+{
+	return sizeof (dgStateBaselineHeader) + (dgBodyMasterList::GetCount() - 1) * sizeof (dgStateBaselineBody);
+}
+
+dgInt32 dgWorld::GetStateDeltaMaxSize() const
+{
+	return sizeof (dgStateDeltaHeader) + (dgBodyMasterList::GetCount() - 1) * DG_STATE_DELTA_RECORD_SIZE;
+}
+
+dgInt32 dgWorld::EncodeStateDelta(const dgWorldStateDeltaParams& params, void* const baseline, dgInt32 baselineSize, void* const delta, dgInt32 deltaSize) const
+{
+	dgAssert (!m_inUpdate);
+	dgAssert (params.m_positionPrecision > dgFloat32 (0.0f));
+	dgAssert (params.m_velocityPrecision > dgFloat32 (0.0f));
+	if ((baselineSize < GetStateBaselineSize()) || (deltaSize < GetStateDeltaMaxSize())) {
+		return 0;
+	}
+
+	const dgBodyMasterList& masterList = *this;
+	const dgInt32 bodyCount = masterList.GetCount() - 1;
+
+	// a baseline that is new, or was made for other precisions or another body count, invalidates every body
+	dgStateBaselineHeader* const baselineHeader = (dgStateBaselineHeader*)baseline;
+	dgStateBaselineBody* const baselineBodies = (dgStateBaselineBody*)&baselineHeader[1];
+	if ((baselineHeader->m_signature != DG_STATE_BASELINE_SIGNATURE) || (baselineHeader->m_bodyCount != bodyCount) ||
+		(baselineHeader->m_positionPrecision != params.m_positionPrecision) || (baselineHeader->m_velocityPrecision != params.m_velocityPrecision)) {
+		baselineHeader->m_signature = DG_STATE_BASELINE_SIGNATURE;
+		baselineHeader->m_bodyCount = bodyCount;
+		baselineHeader->m_positionPrecision = params.m_positionPrecision;
+		baselineHeader->m_velocityPrecision = params.m_velocityPrecision;
+		for (dgInt32 i = 0; i < bodyCount; i ++) {
+			baselineBodies[i].m_uniqueID = -1;
+		}
+	}
+
+	const dgFloat32 invPositionStep = dgFloat32 (1.0f) / params.m_positionPrecision;
+	const dgFloat32 invVelocityStep = dgFloat32 (1.0f) / params.m_velocityPrecision;
+	const dgFloat32 maxPosition = dgFloat32 (2147483000.0f);
+	const dgFloat32 maxVelocity = dgFloat32 (32767.0f);
+	const dgFloat32 positionTol2 = params.m_positionTolerance * params.m_positionTolerance;
+	const dgFloat32 rotationTol = dgCos (params.m_rotationTolerance * dgFloat32 (0.5f));
+	const dgFloat32 velocityTol = params.m_velocityTolerance;
+
+	dgStateDeltaHeader header;
+	header.m_signature = DG_STATE_DELTA_SIGNATURE;
+	header.m_count = 0;
+	header.m_positionPrecision = params.m_positionPrecision;
+	header.m_velocityPrecision = params.m_velocityPrecision;
+
+	dgInt8* const base = (dgInt8*)delta;
+	dgInt8* ptr = base + sizeof (dgStateDeltaHeader);
+
+	dgInt32 index = 0;
+	for (dgBodyMasterList::dgListNode* node = masterList.GetFirst()->GetNext(); node; node = node->GetNext()) {
+		const dgBody* const body = node->GetInfo().GetBody();
+		dgStateBaselineBody& last = baselineBodies[index];
+		index ++;
+
+		const dgInt32 sleeping = body->m_sleeping ? DG_STATE_DELTA_SLEEPING : 0;
+		if (last.m_uniqueID == body->m_uniqueID) {
+			// a body can still be nudged by the solver in the step it is flagged asleep, so sleeping bodies go through the same test
+			const dgVector& posit = body->m_matrix.m_posit;
+			const dgVector step (posit.m_x - last.m_posit[0], posit.m_y - last.m_posit[1], posit.m_z - last.m_posit[2], dgFloat32 (0.0f));
+			const dgQuaternion& rotation = body->m_rotation;
+			const dgFloat32 dot = rotation.m_x * last.m_rotation[0] + rotation.m_y * last.m_rotation[1] + rotation.m_z * last.m_rotation[2] + rotation.m_w * last.m_rotation[3];
+			const dgVector veloc (body->m_veloc - dgVector (last.m_veloc[0], last.m_veloc[1], last.m_veloc[2], dgFloat32 (0.0f)));
+			const dgVector omega (body->m_omega - dgVector (last.m_omega[0], last.m_omega[1], last.m_omega[2], dgFloat32 (0.0f)));
+			const dgFloat32 velocError = dgMax (veloc.Abs().GetMax(), omega.Abs().GetMax());
+			if ((sleeping == (last.m_flags & DG_STATE_DELTA_SLEEPING)) && (step.DotProduct(step).GetScalar() <= positionTol2) && (dgAbs (dot) >= rotationTol) && (velocError <= velocityTol)) {
+				continue;
+			}
+		}
+
+		dgInt32 posit[3];
+		dgInt16 veloc[6];
+		const dgVector velocity (sleeping ? dgVector::m_zero : body->m_veloc);
+		const dgVector omega (sleeping ? dgVector::m_zero : body->m_omega);
+		for (dgInt32 i = 0; i < 3; i ++) {
+			posit[i] = dgQuantize (body->m_matrix.m_posit[i], invPositionStep, maxPosition);
+			veloc[i] = dgInt16 (dgQuantize (velocity[i], invVelocityStep, maxVelocity));
+			veloc[i + 3] = dgInt16 (dgQuantize (omega[i], invVelocityStep, maxVelocity));
+		}
+		const dgUnsigned32 rotationCode = dgEncodeSmallestThree (body->m_rotation);
+		const dgInt8 flags = dgInt8 (sleeping);
+
+		memcpy (ptr, &body->m_uniqueID, sizeof (dgInt32));
+		memcpy (ptr + 4, posit, sizeof (posit));
+		memcpy (ptr + 16, &rotationCode, sizeof (dgUnsigned32));
+		memcpy (ptr + 20, veloc, sizeof (veloc));
+		ptr[32] = flags;
+		ptr += DG_STATE_DELTA_RECORD_SIZE;
+		header.m_count ++;
+
+		// remember what the receiver will decode, not the exact value
+		const dgQuaternion rotation (dgDecodeSmallestThree (rotationCode));
+		last.m_uniqueID = body->m_uniqueID;
+		last.m_flags = sleeping;
+		for (dgInt32 i = 0; i < 3; i ++) {
+			last.m_posit[i] = dgFloat32 (posit[i]) * params.m_positionPrecision;
+			last.m_veloc[i] = dgFloat32 (veloc[i]) * params.m_velocityPrecision;
+			last.m_omega[i] = dgFloat32 (veloc[i + 3]) * params.m_velocityPrecision;
+		}
+		last.m_rotation[0] = rotation.m_x;
+		last.m_rotation[1] = rotation.m_y;
+		last.m_rotation[2] = rotation.m_z;
+		last.m_rotation[3] = rotation.m_w;
+	}
+
+	memcpy (base, &header, sizeof (dgStateDeltaHeader));
+	return dgInt32 (ptr - base);
+}
+
+dgInt32 dgWorld::ApplyStateDelta(const void* const delta, dgInt32 deltaSize)
+{
+	dgAssert (!m_inUpdate);
+	dgStateDeltaHeader header;
+	if (deltaSize < dgInt32 (sizeof (dgStateDeltaHeader))) {
+		return -1;
+	}
+	memcpy (&header, delta, sizeof (dgStateDeltaHeader));
+	if ((header.m_signature != DG_STATE_DELTA_SIGNATURE) || (deltaSize < dgInt32 (sizeof (dgStateDeltaHeader) + header.m_count * DG_STATE_DELTA_RECORD_SIZE))) {
+		return -1;
+	}
+
+	// unique IDs are dense, so a direct table is cheaper than a search tree
+	dgBodyMasterList& masterList = *this;
+	dgInt32 maxUniqueID = 0;
+	for (dgBodyMasterList::dgListNode* node = masterList.GetFirst()->GetNext(); node; node = node->GetNext()) {
+		maxUniqueID = dgMax (maxUniqueID, node->GetInfo().GetBody()->m_uniqueID);
+	}
+	dgStack<dgBody*> bodyMap(maxUniqueID + 1);
+	memset (&bodyMap[0], 0, (maxUniqueID + 1) * sizeof (dgBody*));
+	for (dgBodyMasterList::dgListNode* node = masterList.GetFirst()->GetNext(); node; node = node->GetNext()) {
+		dgBody* const body = node->GetInfo().GetBody();
+		bodyMap[body->m_uniqueID] = body;
+	}
+
+	dgInt32 applied = 0;
+	const dgInt8* ptr = (dgInt8*)delta + sizeof (dgStateDeltaHeader);
+	for (dgInt32 i = 0; i < header.m_count; i ++) {
+		dgInt32 uniqueID;
+		dgInt32 posit[3];
+		dgUnsigned32 rotationCode;
+		dgInt16 veloc[6];
+		memcpy (&uniqueID, ptr, sizeof (dgInt32));
+		memcpy (posit, ptr + 4, sizeof (posit));
+		memcpy (&rotationCode, ptr + 16, sizeof (dgUnsigned32));
+		memcpy (veloc, ptr + 20, sizeof (veloc));
+		const dgInt32 flags = ptr[32];
+		ptr += DG_STATE_DELTA_RECORD_SIZE;
+
+		dgBody* const body = ((uniqueID >= 0) && (uniqueID <= maxUniqueID)) ? bodyMap[uniqueID] : NULL;
+		if (body) {
+			const dgVector origin (dgFloat32 (posit[0]) * header.m_positionPrecision, dgFloat32 (posit[1]) * header.m_positionPrecision, dgFloat32 (posit[2]) * header.m_positionPrecision, dgFloat32 (1.0f));
+			const dgVector velocity (dgFloat32 (veloc[0]) * header.m_velocityPrecision, dgFloat32 (veloc[1]) * header.m_velocityPrecision, dgFloat32 (veloc[2]) * header.m_velocityPrecision, dgFloat32 (0.0f));
+			const dgVector omega (dgFloat32 (veloc[3]) * header.m_velocityPrecision, dgFloat32 (veloc[4]) * header.m_velocityPrecision, dgFloat32 (veloc[5]) * header.m_velocityPrecision, dgFloat32 (0.0f));
+			body->SetMatrixResetSleep (dgMatrix (dgDecodeSmallestThree (rotationCode), origin));
+			body->SetVelocity (velocity);
+			body->SetOmega (omega);
+			if (flags & DG_STATE_DELTA_SLEEPING) {
+				body->SetSleepState (true);
+			}
+			applied ++;
+		}
+	}
+	return applied;
+}
+
+#define DG_BODY_STATES_BLOCK	64
+
+class dgBodyStatesDescriptor
+{
+	public:
+	const dgBodyStateArrays* m_arrays;
+	dgBody* const* m_bodies;
+	dgInt32 m_count;
+	dgInt32 m_jobsCount;
+	dgInt32 m_atomicIndex;
+	bool m_setState;
+};
+
+class dgBodyStatesJob
+{
+	public:
+	dgBodyStatesDescriptor* m_descriptor;
+	dgBodyMasterList::dgListNode* m_node;
+	dgInt32 m_index;
+};
+
+template<class T>
+DG_INLINE T* dgStridedEntry (T* const base, dgInt32 stride, dgInt32 index)
+{
+	return (T*)((dgInt8*)base + index * stride);
+}
+
+static void dgGetBodyState (const dgBody* const body, const dgBodyStateArrays& arrays, dgInt32 index)
+{
+	if (arrays.m_posit) {
+		const dgVector& posit = body->GetMatrix().m_posit;
+		dgFloat32* const dst = dgStridedEntry (arrays.m_posit, arrays.m_positStride, index);
+		dst[0] = posit.m_x;
+		dst[1] = posit.m_y;
+		dst[2] = posit.m_z;
+	}
+	if (arrays.m_rotation) {
+		const dgQuaternion& rotation = body->GetRotation();
+		dgFloat32* const dst = dgStridedEntry (arrays.m_rotation, arrays.m_rotationStride, index);
+		dst[0] = rotation.m_x;
+		dst[1] = rotation.m_y;
+		dst[2] = rotation.m_z;
+		dst[3] = rotation.m_w;
+	}
+	if (arrays.m_veloc) {
+		const dgVector& veloc = body->GetVelocity();
+		dgFloat32* const dst = dgStridedEntry (arrays.m_veloc, arrays.m_velocStride, index);
+		dst[0] = veloc.m_x;
+		dst[1] = veloc.m_y;
+		dst[2] = veloc.m_z;
+	}
+	if (arrays.m_omega) {
+		const dgVector& omega = body->GetOmega();
+		dgFloat32* const dst = dgStridedEntry (arrays.m_omega, arrays.m_omegaStride, index);
+		dst[0] = omega.m_x;
+		dst[1] = omega.m_y;
+		dst[2] = omega.m_z;
+	}
+	if (arrays.m_sleeping) {
+		*dgStridedEntry (arrays.m_sleeping, arrays.m_sleepingStride, index) = body->GetSleepState() ? 1 : 0;
+	}
+}
+
+static void dgSetBodyState (dgBody* const body, const dgBodyStateArrays& arrays, dgInt32 index)
+{
+	if (arrays.m_posit || arrays.m_rotation) {
+		dgVector posit (body->GetMatrix().m_posit);
+		dgQuaternion rotation (body->GetRotation());
+		if (arrays.m_posit) {
+			const dgFloat32* const src = dgStridedEntry (arrays.m_posit, arrays.m_positStride, index);
+			posit = dgVector (src[0], src[1], src[2], dgFloat32 (1.0f));
+		}
+		if (arrays.m_rotation) {
+			const dgFloat32* const src = dgStridedEntry (arrays.m_rotation, arrays.m_rotationStride, index);
+			rotation = dgQuaternion (src[3], src[0], src[1], src[2]);
+		}
+		// the broadphase refit locks each parent node, so bodies can be moved concurrently
+		body->SetMatrixResetSleep (dgMatrix (rotation, posit));
+	}
+	if (arrays.m_veloc) {
+		const dgFloat32* const src = dgStridedEntry (arrays.m_veloc, arrays.m_velocStride, index);
+		body->SetVelocity (dgVector (src[0], src[1], src[2], dgFloat32 (0.0f)));
+	}
+	if (arrays.m_omega) {
+		const dgFloat32* const src = dgStridedEntry (arrays.m_omega, arrays.m_omegaStride, index);
+		body->SetOmega (dgVector (src[0], src[1], src[2], dgFloat32 (0.0f)));
+	}
+	if (arrays.m_sleeping) {
+		body->SetSleepState (*dgStridedEntry (arrays.m_sleeping, arrays.m_sleepingStride, index) ? true : false);
+	}
+}
+
+void dgWorld::BodyStatesKernel (void* const context, void* const jobContext, dgInt32 threadID)
+{
+	dgBodyStatesJob* const job = (dgBodyStatesJob*) jobContext;
+	dgBodyStatesDescriptor* const descriptor = job->m_descriptor;
+	const dgBodyStateArrays& arrays = *descriptor->m_arrays;
+	const bool setState = descriptor->m_setState;
+
+	if (descriptor->m_bodies) {
+		dgBody* const* const bodies = descriptor->m_bodies;
+		const dgInt32 count = descriptor->m_count;
+		for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_BODY_STATES_BLOCK); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicIndex, DG_BODY_STATES_BLOCK)) {
+			const dgInt32 blockEnd = dgMin (i + DG_BODY_STATES_BLOCK, count);
+			for (dgInt32 j = i; j < blockEnd; j ++) {
+				if (setState) {
+					dgSetBodyState (bodies[j], arrays, j);
+				} else {
+					dgGetBodyState (bodies[j], arrays, j);
+				}
+			}
+		}
+	} else {
+		// each job owns every n-th block of the master list, so entries keep the list order
+		const dgInt32 skipCount = (descriptor->m_jobsCount - 1) * DG_BODY_STATES_BLOCK;
+		dgInt32 index = job->m_index;
+		dgBodyMasterList::dgListNode* node = job->m_node;
+		while (node) {
+			for (dgInt32 i = 0; node && (i < DG_BODY_STATES_BLOCK); i ++) {
+				dgBody* const body = node->GetInfo().GetBody();
+				if (setState) {
+					dgSetBodyState (body, arrays, index);
+				} else {
+					dgGetBodyState (body, arrays, index);
+				}
+				index ++;
+				node = node->GetNext();
+			}
+			for (dgInt32 i = 0; node && (i < skipCount); i ++) {
+				node = node->GetNext();
+			}
+			index += skipCount;
+		}
+	}
+}
+
+dgInt32 dgWorld::BodyStates (dgBody* const* const bodies, dgInt32 count, const dgBodyStateArrays& arrays, bool setState)
+{
+	dgAssert (!m_inUpdate);
+	dgBodyStateArrays packedArrays (arrays);
+	packedArrays.m_positStride = packedArrays.m_positStride ? packedArrays.m_positStride : dgInt32 (3 * sizeof (dgFloat32));
+	packedArrays.m_rotationStride = packedArrays.m_rotationStride ? packedArrays.m_rotationStride : dgInt32 (4 * sizeof (dgFloat32));
+	packedArrays.m_velocStride = packedArrays.m_velocStride ? packedArrays.m_velocStride : dgInt32 (3 * sizeof (dgFloat32));
+	packedArrays.m_omegaStride = packedArrays.m_omegaStride ? packedArrays.m_omegaStride : dgInt32 (3 * sizeof (dgFloat32));
+	packedArrays.m_sleepingStride = packedArrays.m_sleepingStride ? packedArrays.m_sleepingStride : dgInt32 (sizeof (dgInt32));
+
+	const dgBodyMasterList& masterList = *this;
+	if (!bodies) {
+		count = masterList.GetCount() - 1;
+	}
+	if (count <= 0) {
+		return 0;
+	}
+
+	const dgInt32 threadsCount = GetThreadCount();
+	const dgInt32 jobsCount = dgMax (dgMin (threadsCount, (count + DG_BODY_STATES_BLOCK - 1) / DG_BODY_STATES_BLOCK), 1);
+
+	dgBodyStatesDescriptor descriptor;
+	descriptor.m_arrays = &packedArrays;
+	descriptor.m_bodies = bodies;
+	descriptor.m_count = count;
+	descriptor.m_jobsCount = jobsCount;
+	descriptor.m_atomicIndex = 0;
+	descriptor.m_setState = setState;
+
+	dgBodyStatesJob jobs[DG_MAX_THREADS_HIVE_COUNT];
+	dgBodyMasterList::dgListNode* node = masterList.GetFirst()->GetNext();
+	for (dgInt32 i = 0; i < jobsCount; i ++) {
+		jobs[i].m_descriptor = &descriptor;
+		jobs[i].m_node = node;
+		jobs[i].m_index = i * DG_BODY_STATES_BLOCK;
+		for (dgInt32 j = 0; node && (j < DG_BODY_STATES_BLOCK); j ++) {
+			node = node->GetNext();
+		}
+	}
+
+	BeginSection();
+	for (dgInt32 i = 0; i < jobsCount; i ++) {
+		QueueJob (BodyStatesKernel, this, &jobs[i], "dgWorld::BodyStates");
+	}
+	SynchronizationBarrier();
+	EndSection();
+	return count;
+}
+
+dgInt32 dgWorld::GetBodyStates (dgBody* const* const bodies, dgInt32 count, const dgBodyStateArrays& arrays)
+{
+	return BodyStates (bodies, count, arrays, false);
+}
+
+dgInt32 dgWorld::SetBodyStates (dgBody* const* const bodies, dgInt32 count, const dgBodyStateArrays& arrays)
+{
+	return BodyStates (bodies, count, arrays, true);
+}
+
 void dgWorld::OnBodyDeserializeFromFile(dgBody& body, void* const userData, dgDeserialize deserializeCallback, void* const fileHandle)
 {
 }
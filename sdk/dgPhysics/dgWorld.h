@@ -36,6 +36,7 @@
 
 #define DG_REDUCE_CONTACT_TOLERANCE			dgFloat32 (5.0e-2f)
 #define DG_PRUNE_CONTACT_TOLERANCE			dgFloat32 (5.0e-2f)
+#define DG_COMPOUND_CONTACT_SPLIT_THRESHOLD	0
 
 #define DG_SLEEP_ENTRIES					8
 #define DG_MAX_DESTROYED_BODIES_BY_FORCE	8
@@ -126,6 +127,37 @@ class dgWorldThreadPool: public dgThreadHive
 	virtual void OnEndWorkerThread (dgInt32 threadId);
 };
 
+// a fixed set of worker threads that several worlds can share, 
+// worlds attached to it do not own any worker thread
+class dgWorldSharedThreadPool: public dgThread, public dgWorldThreadPool
+{
+	public:
+	DG_CLASS_ALLOCATOR(allocator)
+
+	dgWorldSharedThreadPool(dgMemoryAllocator* const allocator, dgInt32 threadCount);
+	virtual ~dgWorldSharedThreadPool();
+
+	dgMemoryAllocator* GetAllocator() const;
+
+	// steps a batch of worlds, each world runs on a single worker, higher priority worlds are dispatched first
+	void Update (dgWorld** const worlds, dgInt32 count, dgFloat32 timestep);
+
+	// the workers are recreated or rebound, so these wait until no attached world is using them
+	void SetWorkersName (const char* const name);
+	void SetWorkerAffinity (dgInt32 threadIndex, dgInt32 firstCpu, dgInt32 cpuCount);
+
+	private:
+	virtual void Execute (dgInt32 threadId);
+	static void UpdateWorldsKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static dgInt32 CompareWorldPriority (dgWorld* const* const worldA, dgWorld* const* const worldB, void* const context);
+
+	dgArray<dgWorld*> m_updateWorlds;
+	dgMemoryAllocator* m_poolAllocator;
+	dgFloat32 m_updateTimestep;
+	dgInt32 m_updateCount;
+	dgInt32 m_atomicCounter;
+};
+
 class dgDeadJoints: public dgTree<dgConstraint*, void* >
 {
 	public: 
@@ -147,6 +179,79 @@ class dgDeadBodies: public dgTree<dgBody*, void* >
 	dgInt32 m_lock;
 };
 
+class dgWorldStats
+{
+	public:
+	// phase times are in seconds and add up all sub steps of the last update
+	dgFloat32 m_updateTime;
+	dgFloat32 m_forceAndTorqueTime;
+	dgFloat32 m_broadPhaseTime;
+	dgFloat32 m_narrowPhaseTime;
+	dgFloat32 m_islandBuildTime;
+	dgFloat32 m_solverTime;
+	dgFloat32 m_integrationTime;
+	dgFloat32 m_transformTime;
+	dgFloat32 m_threadBusyTime[DG_MAX_THREADS_HIVE_COUNT];
+	dgFloat32 m_threadIdleTime[DG_MAX_THREADS_HIVE_COUNT];
+
+	// counters are taken from the last sub step
+	dgInt32 m_threadsCount;
+	dgInt32 m_pairsCount;
+	dgInt32 m_contactsCount;
+	dgInt32 m_activeBodiesCount;
+	dgInt32 m_islandsCount;
+	dgInt32 m_solverRowsCount;
+};
+
+class dgWorldStateDeltaParams
+{
+	public:
+	// quantization steps of the streamed values
+	dgFloat32 m_positionPrecision;
+	dgFloat32 m_velocityPrecision;
+
+	// a body is streamed when any of these changed since the baseline
+	dgFloat32 m_positionTolerance;
+	dgFloat32 m_rotationTolerance;
+	dgFloat32 m_velocityTolerance;
+};
+
+class dgBodyStateArrays
+{
+	public:
+	// each field is skipped when its pointer is NULL, a zero stride means tightly packed
+	dgFloat32* m_posit;
+	dgFloat32* m_rotation;
+	dgFloat32* m_veloc;
+	dgFloat32* m_omega;
+	dgInt32* m_sleeping;
+	dgInt32 m_positStride;
+	dgInt32 m_rotationStride;
+	dgInt32 m_velocStride;
+	dgInt32 m_omegaStride;
+	dgInt32 m_sleepingStride;
+};
+
+class dgPublishedBodyState
+{
+	public:
+	dgFloat32 m_posit[3];
+	dgFloat32 m_rotation[4];
+	dgFloat32 m_veloc[3];
+	dgFloat32 m_omega[3];
+	dgInt32 m_uniqueID;
+	dgInt32 m_sleeping;
+};
+
+class dgPublishedStateBuffer
+{
+	public:
+	dgPublishedBodyState* m_states;
+	dgInt32 m_capacity;
+	dgInt32 m_sequence;
+	dgInt32 m_frame;
+};
+
 typedef void (*OnPostUpdateCallback) (const dgWorld* const world, dgFloat32 timestep);
 
 DG_MSC_VECTOR_ALIGMENT
@@ -240,6 +345,7 @@ class dgWorld
 	~dgWorld();
 
 	dgFloat32 GetUpdateTime() const;
+	const dgWorldStats& GetStats() const;
 	dgBroadPhase* GetBroadPhase() const;
 
 	dgInt32 GetSolverIterations() const;
@@ -251,6 +357,15 @@ class dgWorld
 	void EnableParallelSolverOnLargeIsland(dgInt32 mode);
 	dgInt32 GetParallelSolverOnLargeIsland() const;
 
+	void SetDeterministicMode(dgInt32 mode);
+	dgInt32 GetDeterministicMode() const;
+
+	void SetPublishedStateMode(dgInt32 mode);
+	dgInt32 GetPublishedStateMode() const;
+	dgInt32 GetPublishedFrame() const;
+	bool GetPublishedBodyState(const dgBody* const body, dgPublishedBodyState& state) const;
+	dgInt32 GetPublishedBodyStates(const dgBody* const* const bodies, dgInt32 count, const dgBodyStateArrays& arrays) const;
+
 	void FlushCache();
 
 	virtual dgUnsigned64 GetTimeInMicrosenconds() const;
@@ -371,6 +486,18 @@ class dgWorld
 	void SerializeJointArray (dgInt32 count, dgSerialize serializeCallback, void* const serializeHandle) const;
 	void DeserializeJointArray (const dgTree<dgBody*, dgInt32>&bodyMap, dgDeserialize serializeCallback, void* const serializeHandle);
 
+	dgInt32 GetSnapshotSize() const;
+	dgInt32 SaveSnapshot(void* const buffer, dgInt32 bufferSize) const;
+	bool RestoreSnapshot(const void* const buffer, dgInt32 bufferSize);
+
+	dgInt32 GetStateBaselineSize() const;
+	dgInt32 GetStateDeltaMaxSize() const;
+	dgInt32 EncodeStateDelta(const dgWorldStateDeltaParams& params, void* const baseline, dgInt32 baselineSize, void* const delta, dgInt32 deltaSize) const;
+	dgInt32 ApplyStateDelta(const void* const delta, dgInt32 deltaSize);
+
+	dgInt32 GetBodyStates(dgBody* const* const bodies, dgInt32 count, const dgBodyStateArrays& arrays);
+	dgInt32 SetBodyStates(dgBody* const* const bodies, dgInt32 count, const dgBodyStateArrays& arrays);
+
 	void SerializeCollision (dgCollisionInstance* const shape, dgSerialize deserialization, void* const userData) const;
 	dgCollisionInstance* CreateCollisionFromSerialization (dgDeserialize deserialization, void* const userData);
 	void ReleaseCollision(const dgCollision* const collision);
@@ -399,6 +526,10 @@ class dgWorld
 	dgContact* FindContactJoint (const dgBody* body0, const dgBody* body1) const;
 
 	void SetThreadsCount (dgInt32 count);
+	void SetSharedThreadPool (dgWorldSharedThreadPool* const threadPool);
+	dgWorldSharedThreadPool* GetSharedThreadPool () const;
+	dgInt32 GetThreadPoolPriority () const;
+	void SetThreadPoolPriority (dgInt32 priority);
 	
 	//Parallel Job dispatcher for user related stuff
 	void ExecuteUserJob (dgWorkerThreadTaskCallback userJobKernel, void* const userJobKernelContext, const char* const functionName);
@@ -417,6 +548,9 @@ class dgWorld
 	dgFloat32 GetContactMergeTolerance() const;
 	void SetContactMergeTolerance(dgFloat32 tolerenace);
 
+	dgInt32 GetCompoundContactSplitThreshold() const;
+	void SetCompoundContactSplitThreshold(dgInt32 threshold);
+
 //	void Sync ();
 
 	void SetSubsteps (dgInt32 subSteps);
@@ -431,12 +565,14 @@ class dgWorld
 	};
 
 	void RunStep ();
+	void UpdateInSharedThreadPool (dgFloat32 timestep);
 	void CalculateContacts (dgBroadPhase::dgPair* const pair, dgInt32 threadIndex, bool ccdMode, bool intersectionTestOnly);
 
 	dgInt32 PruneContacts (dgInt32 count, dgContactPoint* const contact, dgFloat32 distTolerenace, dgInt32 maxCount = (DG_CONSTRAINT_MAX_ROWS / 3)) const;
 	dgInt32 CalculateConvexPolygonToHullContactsDescrete (dgCollisionParamProxy& proxy) const;
 	dgInt32 CalculatePolySoupToHullContactsDescrete (dgCollisionParamProxy& proxy) const;
 	dgInt32 CalculateConvexToNonConvexContactsContinue (dgCollisionParamProxy& proxy) const;
+	void ValidatePolySoupContactNormals (dgCollisionParamProxy& proxy, dgInt32 count) const;
 	dgInt32 CalculateUserContacts (dgCollisionParamProxy& proxy) const;
 	dgInt32 CalculateConvexToNonConvexContacts (dgCollisionParamProxy& proxy) const;
 	dgInt32 CalculateConvexToConvexContacts (dgCollisionParamProxy& proxy) const;
@@ -476,10 +612,16 @@ class dgWorld
 	virtual void Execute (dgInt32 threadID);
 	virtual void TickCallback (dgInt32 threadID);
 	void UpdateTransforms(dgBodyMasterList::dgListNode* node, dgInt32 threadID);
+	dgInt32 BodyStates(dgBody* const* const bodies, dgInt32 count, const dgBodyStateArrays& arrays, bool setState);
+	void BeginPublishState();
+	void EndPublishState();
+	void ReleasePublishedState();
 
 	static dgUnsigned32 dgApi GetPerformanceCount ();
 	static void UpdateTransforms(void* const context, void* const node, dgInt32 threadID);
+	static void BodyStatesKernel(void* const context, void* const jobContext, dgInt32 threadID);
 	static dgInt32 SortFaces (const dgAdressDistPair* const A, const dgAdressDistPair* const B, void* const context);
+	static bool OnPolySoupFaceBatch (dgPolygonMeshDesc* const data);
 	static dgInt32 CompareJointByInvMass (const dgBilateralConstraint* const jointA, const dgBilateralConstraint* const jointB, void* notUsed);
 
 	dgUnsigned32 m_numberOfSubsteps;
@@ -490,8 +632,15 @@ class dgWorld
 	dgUnsigned32 m_defualtBodyGroupID;
 	dgUnsigned32 m_bodiesUniqueID;
 	dgUnsigned32 m_useParallelSolver;
+	dgUnsigned32 m_deterministicMode;
+	dgUnsigned32 m_publishedStateMode;
+	dgInt32 m_publishedFront;
+	dgInt32 m_publishedBack;
+	dgInt32 m_publishedFrame;
 	dgUnsigned32 m_genericLRUMark;
 	dgInt32 m_clusterLRU;
+	dgInt32 m_compoundContactSplitThreshold;
+	dgInt32 m_threadPoolPriority;
 
 	dgFloat32 m_freezeAccel2;
 	dgFloat32 m_freezeAlpha2;
@@ -501,6 +650,8 @@ class dgWorld
 	dgFloat32 m_savetimestep;
 	dgFloat32 m_contactTolerance;
 	dgFloat32 m_lastExecutionTime;
+	dgWorldStats m_stats;
+	dgPublishedStateBuffer m_publishedBuffers[2];
 
 	dgSolverProgressiveSleepEntry m_sleepTable[DG_SLEEP_ENTRIES];
 	
@@ -522,6 +673,7 @@ class dgWorld
 	OnPostUpdateCallback m_onPostUpdateCallback;
 
 	dgListenerList m_listeners;
+	dgList<dgPublishedBodyState*> m_retiredPublishedStates;
 	dgTree<void*, unsigned> m_perInstanceData;
 	dgArray<dgBodyInfo> m_bodiesMemory; 
 	dgArray<dgJointInfo> m_jointsMemory; 
@@ -548,6 +700,7 @@ class dgWorld
 	friend class dgCollisionCompound;
 	friend class dgParallelBodySolver;
 	friend class dgWorldDynamicUpdate;
+	friend class dgWorldSharedThreadPool;
 	friend class dgParallelSolverClear;	
 	friend class dgParallelSolverSolve;
 	friend class dgCollisionHeightField;
@@ -599,6 +752,11 @@ inline dgFloat32 dgWorld::GetUpdateTime() const
 	return m_lastExecutionTime;
 }
 
+inline const dgWorldStats& dgWorld::GetStats() const
+{
+	return m_stats;
+}
+
 inline OnPostUpdateCallback dgWorld::GetPostUpdateCallback() const
 {
 	return m_onPostUpdateCallback;
@@ -48,6 +48,7 @@ class dgWorldDynamicUpdateSyncDescriptor
 	
 	dgInt32 m_clusterCount;
 	dgInt32 m_firstCluster;
+	dgInt32 m_continueCollisionCount;
 };
 
 
@@ -75,11 +76,15 @@ dgWorldDynamicUpdate::dgWorldDynamicUpdate(dgMemoryAllocator* const allocator)
 	:m_solverMemory()
 	,m_parallelSolver(allocator)
 	,m_clusterData(NULL)
+	,m_continueCollisionBodies(allocator)
+	,m_continueCollisionPartners(allocator)
+	,m_continueCollisionPairs(allocator)
 	,m_bodies(0)
 	,m_joints(0)
 	,m_clusters(0)
 	,m_markLru(0)
 	,m_softBodiesCount(0)
+	,m_continueCollisionBodiesCount(0)
 	,m_impulseLru(0)
 	,m_softBodyCriticalSectionLock(0)
 {
@@ -106,9 +111,23 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 	sentinelBody->m_equilibrium = 1;
 	sentinelBody->m_dynamicsLru = m_markLru;
 
+	dgUnsigned64 timeAcc = dgGetTimeInMicrosenconds();
 	BuildClusters(timestep);
 	const dgInt32 threadCount = world->GetThreadCount();	
 
+	dgInt32 rowsCount = 0;
+	for (dgInt32 i = 0; i < m_clusters; i++) {
+		rowsCount += m_clusterData[i].m_rowCount;
+	}
+	dgWorldStats& stats = world->m_stats;
+	stats.m_islandsCount = m_clusters;
+	stats.m_activeBodiesCount = m_bodies - m_clusters;
+	stats.m_solverRowsCount = rowsCount;
+
+	dgUnsigned64 phaseTime = dgGetTimeInMicrosenconds();
+	stats.m_islandBuildTime += (phaseTime - timeAcc) * dgFloat32 (1.0e-6f);
+	timeAcc = phaseTime;
+
 	dgWorldDynamicUpdateSyncDescriptor descriptor;
 	descriptor.m_timestep = timestep;
 
@@ -117,7 +136,8 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 	descriptor.m_firstCluster = index;
 	descriptor.m_clusterCount = m_clusters - index;
 
-	dgInt32 useParallelSolver = world->m_useParallelSolver;
+	// the parallel solver partitions large islands by thread count, it is skipped in deterministic mode
+	dgInt32 useParallelSolver = world->m_useParallelSolver && !world->m_deterministicMode;
 //useParallelSolver = 0;
 	if (useParallelSolver) {
 		dgInt32 count = 0;
@@ -140,6 +160,12 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 		world->SynchronizationBarrier();
 	}
 
+	// rigid bodies velocities are integrated by the cluster solver, 
+	// integration time only accounts for soft bodies and continuous collision
+	phaseTime = dgGetTimeInMicrosenconds();
+	stats.m_solverTime += (phaseTime - timeAcc) * dgFloat32 (1.0e-6f);
+	timeAcc = phaseTime;
+
 	dgBodyInfo* const bodyArrayPtr = &world->m_bodiesMemory[0];
 	for (dgInt32 i = 0; i < m_softBodiesCount; i++) {
 		dgBodyCluster* const cluster = &m_clusterData[i];
@@ -152,6 +178,11 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgFloat32 timestep)
 		IntegrateVelocity(cluster, DG_SOLVER_MAX_ERROR, timestep, 0);
 	}
 
+	if (m_continueCollisionBodiesCount) {
+		ResolveContinueCollision(timestep);
+	}
+	stats.m_integrationTime += (dgGetTimeInMicrosenconds() - timeAcc) * dgFloat32 (1.0e-6f);
+
 	m_clusterData = NULL;
 }
 
@@ -325,8 +356,14 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 	m_clusterData = &world->m_clusterMemory[0];
 //	dgSort(augmentedJointArray, augmentedJointCount, CompareJointInfos);
 //	dgSort(m_clusterData, clustersCount, CompareClusterInfos);
-	dgParallelSort(*world, augmentedJointArray, augmentedJointCount, CompareJointInfos);
-	dgParallelSort(*world, m_clusterData, clustersCount, CompareClusterInfos);
+	if (world->m_deterministicMode) {
+		// joints of the same cluster compare equal, the parallel sort leaves them in an order that depends on the thread count
+		dgSort(augmentedJointArray, augmentedJointCount, CompareJointInfos);
+		dgSort(m_clusterData, clustersCount, CompareClusterInfos);
+	} else {
+		dgParallelSort(*world, augmentedJointArray, augmentedJointCount, CompareJointInfos);
+		dgParallelSort(*world, m_clusterData, clustersCount, CompareClusterInfos);
+	}
 
 	dgInt32 rowStart = 0;
 	dgInt32 bodyStart = 0;
@@ -347,6 +384,7 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 	world->m_bodiesMemory.ResizeIfNecessary(bodyStart);
 
 	rowStart = 0;
+	dgInt32 continueCollisionBodiesCount = 0;
 	for (dgInt32 i = 0; i < clustersCount; i++) {
 		const dgBodyCluster& cluster = m_clusterData[i];
 		dgBodyInfo* const bodyArray = &world->m_bodiesMemory[cluster.m_bodyStart];
@@ -394,12 +432,28 @@ void dgWorldDynamicUpdate::BuildClusters(dgFloat32 timestep)
 			dgAssert(cluster.m_bodyCount == 2);
 			bodyArray[1].m_body = jointSetArray[0].m_body;
 		}
+
+		if (!cluster.m_hasSoftBodies) {
+			// save the pose of continue collision bodies before the solver moves them 
+			for (dgInt32 j = 1; j < cluster.m_bodyCount; j++) {
+				dgDynamicBody* const body = (dgDynamicBody*)bodyArray[j].m_body;
+				if (body->m_continueCollisionMode && body->IsRTTIType(dgBody::m_dynamicBodyRTTI)) {
+					dgContinueCollisionBody& entry = m_continueCollisionBodies[continueCollisionBodiesCount];
+					entry.m_body = body;
+					entry.m_matrix = body->m_matrix;
+					entry.m_rotation = body->m_rotation;
+					entry.m_globalCentreOfMass = body->m_globalCentreOfMass;
+					continueCollisionBodiesCount++;
+				}
+			}
+		}
 	}
 	
 	m_bodies = bodyStart;
 	m_joints = jointStart;
 	m_clusters = clustersCount;
 	m_softBodiesCount = softBodiesCount;
+	m_continueCollisionBodiesCount = continueCollisionBodiesCount;
 }
 
 dgInt32 dgWorldDynamicUpdate::CompareBodyJacobianPair(const dgBodyJacobianPair* const infoA, const dgBodyJacobianPair* const infoB, void* notUsed)
@@ -438,6 +492,262 @@ void dgWorldDynamicUpdate::CalculateClusterReactionForcesKernel (void* const con
 	}
 }
 
+dgInt32 dgWorldDynamicUpdate::CompareContinueCollisionBodies (const dgContinueCollisionBody* const bodyA, const dgContinueCollisionBody* const bodyB, void* notUsed)
+{
+	if (bodyA->m_body < bodyB->m_body) {
+		return -1;
+	} else if (bodyA->m_body > bodyB->m_body) {
+		return 1;
+	}
+	return 0;
+}
+
+dgInt32 dgWorldDynamicUpdate::FindContinueCollisionBody (const dgBody* const body, dgInt32 count) const
+{
+	const dgContinueCollisionBody* const bodyArray = &m_continueCollisionBodies[0];
+	dgInt32 i0 = 0;
+	dgInt32 i1 = count - 1;
+	while (i0 <= i1) {
+		const dgInt32 mid = (i0 + i1) >> 1;
+		if (bodyArray[mid].m_body < body) {
+			i0 = mid + 1;
+		} else if (bodyArray[mid].m_body > body) {
+			i1 = mid - 1;
+		} else {
+			return mid;
+		}
+	}
+	return -1;
+}
+
+bool dgWorldDynamicUpdate::HasBilateralJoints (const dgBody* const body) const
+{
+	for (dgBodyMasterListRow::dgListNode* jointNode = body->m_masterNode->GetInfo().GetFirst(); jointNode; jointNode = jointNode->GetNext()) {
+		if (jointNode->GetInfo().m_joint->GetId() != dgConstraint::m_contactConstraint) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool dgWorldDynamicUpdate::IsApproachingContact (const dgContact* const contact, dgFloat32 minDisplacement, dgFloat32 timestep) const
+{
+	const dgBody* const body0 = contact->m_body0;
+	const dgBody* const body1 = contact->m_body1;
+	dgFloat32 approachSpeed = dgFloat32 (0.0f);
+	for (dgContact::dgListNode* node = contact->GetFirst(); node; node = node->GetNext()) {
+		const dgContactMaterial& point = node->GetInfo();
+		const dgVector relVeloc (body1->GetVelocityAtPoint(point.m_point) - body0->GetVelocityAtPoint(point.m_point));
+		approachSpeed = dgMax (approachSpeed, relVeloc.DotProduct(point.m_normal).GetScalar());
+	}
+	return (approachSpeed * timestep) > minDisplacement;
+}
+
+void dgWorldDynamicUpdate::ResolveContinueCollision (dgFloat32 timestep)
+{
+	D_TRACKTIME();
+	dgWorld* const world = (dgWorld*) this;
+	dgContinueCollisionBody* const bodyArray = &m_continueCollisionBodies[0];
+
+	// only bodies that moved more than a fraction of their thickness can tunnel, 
+	// rewind those to the pose they had at the beginning of the step. 
+	// A body with bilateral joints is left alone, clamping it alone would tear its joints apart
+	dgInt32 bodyCount = 0;
+	for (dgInt32 i = 0; i < m_continueCollisionBodiesCount; i++) {
+		dgContinueCollisionBody& entry = bodyArray[i];
+		dgDynamicBody* const body = entry.m_body;
+		const dgVector step (body->m_globalCentreOfMass - entry.m_globalCentreOfMass);
+		const dgFloat32 minDisplacement = body->m_collision->GetBoxMinRadius() * DG_CCD_MIN_DISPLACEMENT_FACTOR;
+		if ((step.DotProduct(step).GetScalar() > (minDisplacement * minDisplacement)) && !HasBilateralJoints(body)) {
+			bodyArray[bodyCount] = entry;
+			bodyArray[bodyCount].m_timeToImpact = timestep;
+			bodyCount++;
+		}
+	}
+	m_continueCollisionBodiesCount = 0;
+	if (!bodyCount) {
+		return;
+	}
+
+	dgSort(bodyArray, bodyCount, CompareContinueCollisionBodies);
+	for (dgInt32 i = 0; i < bodyCount; i++) {
+		dgContinueCollisionBody& entry = bodyArray[i];
+		dgDynamicBody* const body = entry.m_body;
+		dgSwap(entry.m_matrix, body->m_matrix);
+		dgSwap(entry.m_rotation, body->m_rotation);
+		dgSwap(entry.m_globalCentreOfMass, body->m_globalCentreOfMass);
+		body->UpdateWorlCollisionMatrix();
+	}
+
+	// collect the contacts of the fast bodies, a contact between two of them is only added once
+	dgInt32 pairCount = 0;
+	dgInt32 partnerCount = 0;
+	const dgUnsigned32 lru = world->m_broadPhase->m_lru;
+	for (dgInt32 i = 0; i < bodyCount; i++) {
+		dgDynamicBody* const body = bodyArray[i].m_body;
+		const dgFloat32 minDisplacement = body->m_collision->GetBoxMinRadius() * DG_CCD_MIN_DISPLACEMENT_FACTOR;
+		for (dgBodyMasterListRow::dgListNode* jointNode = body->m_masterNode->GetInfo().GetFirst(); jointNode; jointNode = jointNode->GetNext()) {
+			const dgBodyMasterListCell& cell = jointNode->GetInfo();
+			if (cell.m_joint->GetId() == dgConstraint::m_contactConstraint) {
+				dgContact* const contact = (dgContact*)cell.m_joint;
+				dgBody* const otherBody = cell.m_bodyNode;
+				const dgContactMaterial* const material = contact->m_material;
+				if (!(material->m_flags & dgContactMaterial::m_collisionEnable)) {
+					continue;
+				}
+				if (!(body->m_collision->GetCollisionMode() & otherBody->m_collision->GetCollisionMode())) {
+					continue;
+				}
+				if (!(body->m_collideWithLinkedBodies & otherBody->m_collideWithLinkedBodies) && world->AreBodyConnectedByJoints(body, otherBody)) {
+					continue;
+				}
+				if ((contact->m_aabbOverlapLru == lru) && !contact->m_aabbOverlapAccepted) {
+					continue;
+				}
+				if (contact->m_isActive && contact->m_maxDOF && !IsApproachingContact(contact, minDisplacement, timestep)) {
+					// a contact that is already touching would give a time of impact of zero, 
+					// the solver handles it unless the bodies close in faster than the body can tunnel
+					continue;
+				}
+
+				const dgInt32 otherIndex = otherBody->m_continueCollisionMode ? FindContinueCollisionBody(otherBody, bodyCount) : -1;
+				if ((otherIndex < 0) || (otherIndex > i)) {
+					dgContinueCollisionPair& pair = m_continueCollisionPairs[pairCount];
+					pair.m_contact = contact;
+					pair.m_body0 = i;
+					pair.m_body1 = otherIndex;
+					pair.m_timeToImpact = timestep;
+					pairCount++;
+
+					if ((otherIndex < 0) && otherBody->IsRTTIType(dgBody::m_dynamicBodyRTTI) && (otherBody->m_invMass.m_w != dgFloat32 (0.0f)) && !otherBody->m_sleeping) {
+						m_continueCollisionPartners[partnerCount].m_body = (dgDynamicBody*)otherBody;
+						partnerCount++;
+					}
+				}
+			}
+		}
+	}
+
+	dgWorldDynamicUpdateSyncDescriptor descriptor;
+	descriptor.m_timestep = timestep;
+	const dgInt32 threadCount = world->GetThreadCount();
+
+	if (pairCount) {
+		// the other bodies that moved this step are swept from their start of step position too, the solver integrates 
+		// the position with the end of step velocity so that position is recovered exactly. Only the rotation is not rewound
+		dgContinueCollisionBody* const partnerArray = &m_continueCollisionPartners[0];
+		dgSort(partnerArray, partnerCount, CompareContinueCollisionBodies);
+		dgInt32 uniqueCount = 0;
+		for (dgInt32 i = 0; i < partnerCount; i++) {
+			if (!uniqueCount || (partnerArray[uniqueCount - 1].m_body != partnerArray[i].m_body)) {
+				dgContinueCollisionBody& entry = partnerArray[uniqueCount];
+				dgDynamicBody* const body = partnerArray[i].m_body;
+				const dgVector step (body->m_veloc.Scale(timestep));
+				entry.m_body = body;
+				entry.m_matrix = body->m_matrix;
+				entry.m_rotation = body->m_rotation;
+				entry.m_globalCentreOfMass = body->m_globalCentreOfMass;
+				body->m_globalCentreOfMass -= step;
+				body->m_matrix.m_posit -= step;
+				body->UpdateWorlCollisionMatrix();
+				uniqueCount++;
+			}
+		}
+
+		descriptor.m_atomicCounter = 0;
+		descriptor.m_continueCollisionCount = pairCount;
+		for (dgInt32 i = 0; i < threadCount; i++) {
+			world->QueueJob(CalculateTimeToImpactKernel, &descriptor, world, "dgWorldDynamicUpdate::CalculateTimeToImpact");
+		}
+		world->SynchronizationBarrier();
+
+		for (dgInt32 i = 0; i < uniqueCount; i++) {
+			const dgContinueCollisionBody& entry = partnerArray[i];
+			dgDynamicBody* const body = entry.m_body;
+			body->m_matrix = entry.m_matrix;
+			body->m_rotation = entry.m_rotation;
+			body->m_globalCentreOfMass = entry.m_globalCentreOfMass;
+			body->UpdateWorlCollisionMatrix();
+		}
+
+		// each body stops at the earliest impact of all its contacts
+		const dgContinueCollisionPair* const pairArray = &m_continueCollisionPairs[0];
+		for (dgInt32 i = 0; i < pairCount; i++) {
+			const dgContinueCollisionPair& pair = pairArray[i];
+			dgContinueCollisionBody& entry0 = bodyArray[pair.m_body0];
+			entry0.m_timeToImpact = dgMin(entry0.m_timeToImpact, pair.m_timeToImpact);
+			if (pair.m_body1 >= 0) {
+				dgContinueCollisionBody& entry1 = bodyArray[pair.m_body1];
+				entry1.m_timeToImpact = dgMin(entry1.m_timeToImpact, pair.m_timeToImpact);
+			}
+		}
+	}
+
+	descriptor.m_atomicCounter = 0;
+	descriptor.m_continueCollisionCount = bodyCount;
+	for (dgInt32 i = 0; i < threadCount; i++) {
+		world->QueueJob(IntegrateContinueCollisionKernel, &descriptor, world, "dgWorldDynamicUpdate::IntegrateContinueCollision");
+	}
+	world->SynchronizationBarrier();
+}
+
+void dgWorldDynamicUpdate::CalculateTimeToImpactKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgWorldDynamicUpdateSyncDescriptor* const descriptor = (dgWorldDynamicUpdateSyncDescriptor*) context;
+
+	dgFloat32 timestep = descriptor->m_timestep;
+	dgWorld* const world = (dgWorld*) worldContext;
+	dgInt32 count = descriptor->m_continueCollisionCount;
+	dgContinueCollisionPair* const pairArray = &world->m_continueCollisionPairs[0];
+	const dgUnsigned32 lru = world->m_broadPhase->m_lru;
+
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicCounter, 1); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicCounter, 1)) {
+		dgContinueCollisionPair& pair = pairArray[i];
+		dgContact* const contact = pair.m_contact;
+		const dgContactMaterial* const material = contact->m_material;
+		if (material->m_aabbOverlap && (contact->m_aabbOverlapLru != lru) && !material->m_aabbOverlap(*contact, timestep, threadID)) {
+			continue;
+		}
+
+		// conservative advancement of the closest points along the relative velocity, 
+		// the contacts are allowed to penetrate a little so that the next step generates contacts 
+		dgVector p;
+		dgVector q;
+		dgVector normal;
+		const dgFloat32 closestDistance = contact->m_closestDistance;
+		pair.m_timeToImpact = world->CalculateTimeToImpact(contact, timestep, threadID, p, q, normal, -DG_CCD_PENETRATION_TOL);
+		contact->m_closestDistance = closestDistance;
+	}
+}
+
+void dgWorldDynamicUpdate::IntegrateContinueCollisionKernel (void* const context, void* const worldContext, dgInt32 threadID)
+{
+	D_TRACKTIME();
+	dgWorldDynamicUpdateSyncDescriptor* const descriptor = (dgWorldDynamicUpdateSyncDescriptor*) context;
+
+	dgFloat32 timestep = descriptor->m_timestep;
+	dgWorld* const world = (dgWorld*) worldContext;
+	dgInt32 count = descriptor->m_continueCollisionCount;
+	dgContinueCollisionBody* const bodyArray = &world->m_continueCollisionBodies[0];
+
+	for (dgInt32 i = dgAtomicExchangeAndAdd(&descriptor->m_atomicCounter, 1); i < count; i = dgAtomicExchangeAndAdd(&descriptor->m_atomicCounter, 1)) {
+		dgContinueCollisionBody& entry = bodyArray[i];
+		dgDynamicBody* const body = entry.m_body;
+		if (entry.m_timeToImpact < timestep) {
+			// advance the body to the time of impact, the remainder of the step is lost 
+			// and the contact solver resolves the collision on the next update
+			body->IntegrateVelocity(dgMax (entry.m_timeToImpact, dgFloat32 (0.0f)));
+			body->UpdateCollisionMatrix(timestep, threadID);
+		} else {
+			body->m_matrix = entry.m_matrix;
+			body->m_rotation = entry.m_rotation;
+			body->m_globalCentreOfMass = entry.m_globalCentreOfMass;
+			body->UpdateWorlCollisionMatrix();
+		}
+	}
+}
+
 dgInt32 dgWorldDynamicUpdate::GetJacobianDerivatives(dgContraintDescritor& constraintParam, dgJointInfo* const jointInfo, dgConstraint* const constraint, dgLeftHandSide* const leftHandSide, dgRightHandSide* const rightHandSide, dgInt32 rowCount) const
 {
 	dgInt32 dof = dgInt32(constraint->m_maxDOF);
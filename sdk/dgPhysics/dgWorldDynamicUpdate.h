@@ -37,6 +37,8 @@
 #define	DG_SOLVER_MAX_ERROR					(DG_FREEZE_MAG * dgFloat32 (0.5f))
 
 #define DG_CCD_EXTRA_CONTACT_COUNT			(8 * 3)
+#define DG_CCD_MIN_DISPLACEMENT_FACTOR		dgFloat32 (0.5f)
+#define DG_CCD_PENETRATION_TOL				dgFloat32 (1.0f / 256.0f)
 #define DG_PARALLEL_JOINT_COUNT_CUT_OFF		(64)
 //#define DG_PARALLEL_JOINT_COUNT_CUT_OFF	(2)
 
@@ -120,6 +122,25 @@ class dgBodyCluster
 	dgInt16 m_isContinueCollision;
 };
 
+class dgContinueCollisionBody
+{
+	public:
+	dgDynamicBody* m_body;
+	dgMatrix m_matrix;
+	dgQuaternion m_rotation;
+	dgVector m_globalCentreOfMass;
+	dgFloat32 m_timeToImpact;
+};
+
+class dgContinueCollisionPair
+{
+	public:
+	dgContact* m_contact;
+	dgInt32 m_body0;
+	dgInt32 m_body1;
+	dgFloat32 m_timeToImpact;
+};
+
 class dgJointImpulseInfo
 {
 	public:
@@ -255,6 +276,9 @@ class dgWorldDynamicUpdate
 	static dgInt32 CompareBodyJacobianPair(const dgBodyJacobianPair* const infoA, const dgBodyJacobianPair* const infoB, void* notUsed);
 	static void IntegrateClustersParallelKernel (void* const context, void* const worldContext, dgInt32 threadID);
 	static void CalculateClusterReactionForcesKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void CalculateTimeToImpactKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static void IntegrateContinueCollisionKernel (void* const context, void* const worldContext, dgInt32 threadID);
+	static dgInt32 CompareContinueCollisionBodies (const dgContinueCollisionBody* const bodyA, const dgContinueCollisionBody* const bodyB, void* notUsed);
 
 	void BuildJacobianMatrix (dgBodyCluster* const cluster, dgInt32 threadID, dgFloat32 timestep) const;
 	void ResolveClusterForces (dgBodyCluster* const cluster, dgInt32 threadID, dgFloat32 timestep) const;
@@ -272,6 +296,10 @@ class dgWorldDynamicUpdate
 	void IntegrateExternalForce(const dgBodyCluster* const cluster, dgFloat32 timestep, dgInt32 threadID) const;
 	void IntegrateVelocity (const dgBodyCluster* const cluster, dgFloat32 accelTolerance, dgFloat32 timestep, dgInt32 threadID) const;
 	void CalculateClusterContacts (dgBodyCluster* const cluster, dgFloat32 timestep, dgInt32 currLru, dgInt32 threadID) const;
+	void ResolveContinueCollision (dgFloat32 timestep);
+	dgInt32 FindContinueCollisionBody (const dgBody* const body, dgInt32 count) const;
+	bool HasBilateralJoints (const dgBody* const body) const;
+	bool IsApproachingContact (const dgContact* const contact, dgFloat32 minDisplacement, dgFloat32 timestep) const;
 
 	void CalculateImpulseVeloc(dgJointImpulseInfo* const jointInfo, const dgLeftHandSide* const leftHandSide, const dgRightHandSide* const rightHandSide, dgFloat32* const contactVeloc) const;
 	void ResolveImpulse(const dgJointInfo* const constraintArray, const dgLeftHandSide* const leftHandSide, dgRightHandSide* const rightHandSide, dgDownHeap<dgContact*, dgFloat32>& impactJoints) const;
@@ -280,12 +308,16 @@ class dgWorldDynamicUpdate
 	dgJacobianMemory m_solverMemory;
 	dgParallelBodySolver m_parallelSolver;
 	dgBodyCluster* m_clusterData;
+	dgArray<dgContinueCollisionBody> m_continueCollisionBodies;
+	dgArray<dgContinueCollisionBody> m_continueCollisionPartners;
+	dgArray<dgContinueCollisionPair> m_continueCollisionPairs;
 
 	dgInt32 m_bodies;
 	dgInt32 m_joints;
 	dgInt32 m_clusters;
 	dgInt32 m_markLru;
 	dgInt32 m_softBodiesCount;
+	dgInt32 m_continueCollisionBodiesCount;
 	mutable dgInt32 m_impulseLru;
 	mutable dgInt32 m_softBodyCriticalSectionLock;
 
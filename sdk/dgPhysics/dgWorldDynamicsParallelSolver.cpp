@@ -830,7 +830,7 @@ void dgParallelBodySolver::InitSkeletons(dgInt32 threadID)
 	dgRightHandSide* const rightHandSide = &m_world->m_solverMemory.m_righHandSizeBuffer[0];
 	const dgLeftHandSide* const leftHandSide = &m_world->m_solverMemory.m_leftHandSizeBuffer[0];
 
-	const dgInt32 count = m_skeletonCount;
+	const dgInt32 count = m_splitSkeletonStart;
 	const dgInt32 threadCounts = m_world->GetThreadCount();
 	dgSkeletonContainer** const skeletonArray = &m_skeletonArray[0];
 
@@ -842,7 +842,7 @@ void dgParallelBodySolver::InitSkeletons(dgInt32 threadID)
 
 void dgParallelBodySolver::UpdateSkeletons(dgInt32 threadID)
 {
-	const dgInt32 count = m_skeletonCount;
+	const dgInt32 count = m_splitSkeletonStart;
 	const dgInt32 threadCounts = m_world->GetThreadCount();
 	dgSkeletonContainer** const skeletonArray = &m_skeletonArray[0];
 	dgJacobian* const internalForces = &m_world->m_solverMemory.m_internalForcesBuffer[0];
@@ -868,19 +868,49 @@ void dgParallelBodySolver::UpdateSkeletonsKernel(void* const context, void* cons
 void dgParallelBodySolver::InitSkeletons()
 {
 	const dgInt32 threadCounts = m_world->GetThreadCount();
-	for (dgInt32 i = 0; i < threadCounts; i++) {
-		m_world->QueueJob(InitSkeletonsKernel, this, NULL, "dgParallelBodySolver::InitSkeletonsKernel");
+
+	// skeletons that can be split into subtrees go last, each one is solved by all threads in turn
+	dgInt32 splitStart = m_skeletonCount;
+	dgSkeletonContainer** const skeletonArray = &m_skeletonArray[0];
+	for (dgInt32 i = 0; i < splitStart; i++) {
+		skeletonArray[i]->PartitionSubtrees(threadCounts);
+		if (skeletonArray[i]->GetSubtreeCount()) {
+			splitStart--;
+			dgSwap(skeletonArray[i], skeletonArray[splitStart]);
+			i--;
+		}
+	}
+	m_splitSkeletonStart = splitStart;
+
+	if (m_splitSkeletonStart) {
+		for (dgInt32 i = 0; i < threadCounts; i++) {
+			m_world->QueueJob(InitSkeletonsKernel, this, NULL, "dgParallelBodySolver::InitSkeletonsKernel");
+		}
+		m_world->SynchronizationBarrier();
+	}
+
+	dgRightHandSide* const rightHandSide = &m_world->m_solverMemory.m_righHandSizeBuffer[0];
+	const dgLeftHandSide* const leftHandSide = &m_world->m_solverMemory.m_leftHandSizeBuffer[0];
+	for (dgInt32 i = m_splitSkeletonStart; i < m_skeletonCount; i++) {
+		skeletonArray[i]->InitMassMatrixParallel(m_jointArray, leftHandSide, rightHandSide);
 	}
-	m_world->SynchronizationBarrier();
 }
 
 void dgParallelBodySolver::UpdateSkeletons()
 {
 	const dgInt32 threadCounts = m_world->GetThreadCount();
-	for (dgInt32 i = 0; i < threadCounts; i++) {
-		m_world->QueueJob(UpdateSkeletonsKernel, this, NULL, "dgParallelBodySolver::UpdateSkeletons");
+	if (m_splitSkeletonStart) {
+		for (dgInt32 i = 0; i < threadCounts; i++) {
+			m_world->QueueJob(UpdateSkeletonsKernel, this, NULL, "dgParallelBodySolver::UpdateSkeletons");
+		}
+		m_world->SynchronizationBarrier();
+	}
+
+	dgSkeletonContainer** const skeletonArray = &m_skeletonArray[0];
+	dgJacobian* const internalForces = &m_world->m_solverMemory.m_internalForcesBuffer[0];
+	for (dgInt32 i = m_splitSkeletonStart; i < m_skeletonCount; i++) {
+		skeletonArray[i]->CalculateJointForceParallel(m_jointArray, m_bodyArray, internalForces);
 	}
-	m_world->SynchronizationBarrier();
 }
 
 
@@ -278,6 +278,7 @@ class dgParallelBodySolver
 	dgInt32 m_threadCounts;
 	dgInt32 m_soaRowsCount;
 	dgInt32 m_skeletonCount;
+	dgInt32 m_splitSkeletonStart;
 	dgInt32 m_jacobianMatrixRowAtomicIndex;
 	dgInt32* m_soaRowStart;
 	dgInt32* m_bodyRowStart;
@@ -308,6 +309,7 @@ DG_INLINE dgParallelBodySolver::dgParallelBodySolver(dgMemoryAllocator* const al
 	,m_threadCounts(0)
 	,m_soaRowsCount(0)
 	,m_skeletonCount(0)
+	,m_splitSkeletonStart(0)
 	,m_jacobianMatrixRowAtomicIndex(0)
 	,m_soaRowStart(NULL)
 	,m_bodyRowStart(NULL)